@@ -5,14 +5,30 @@
 #ifndef CCTOML_TOML_H
 #    define CCTOML_TOML_H
 
+#    include <array>
+#    if __cplusplus >= 202002L
+#        include <bit>
+#    endif
 #    include <chrono>
+#    include <cstddef>
 #    include <cstdint>
+#    include <deque>
+#    include <functional>
+#    include <initializer_list>
 #    include <iterator>
+#    include <limits>
 #    include <map>
+#    include <memory_resource>
+#    include <memory>
+#    include <mutex>
 #    include <optional>
+#    include <set>
 #    include <stdexcept>
 #    include <string>
+#    include <string_view>
+#    include <tuple>
 #    include <unordered_map>
+#    include <utility>
 #    include <variant>
 #    include <vector>
 
@@ -46,6 +62,33 @@ class TomlParseException : public TomlException {
         : TomlException(data + ", position: " + std::to_string(position)) {}
 };
 
+/**
+ * @class TomlSchemaException
+ * @brief 按模式（TomlSchema）解码时的异常类。
+ *
+ * 包含出错值的键路径（如 servers[1].port），便于在加载时定位配置错误。
+ */
+class TomlSchemaException : public TomlException {
+  public:
+    /**
+     * @brief 构造函数，创建包含键路径和错误信息的异常。
+     * @param path 出错值的键路径。
+     * @param message 错误描述信息。
+     */
+    TomlSchemaException(const std::string& path, const std::string& message)
+        : TomlException(path + ": " + message), m_path(path) {}
+
+    /**
+     * @brief 获取出错值的键路径。
+     */
+    const std::string& path() const noexcept {
+        return m_path;
+    }
+
+  private:
+    std::string m_path;  ///< 出错值的键路径。
+};
+
 /**
  * @enum TomlType
  * @brief 表示 TOML 数据类型的枚举。
@@ -63,6 +106,7 @@ enum class TomlType {
 };
 
 class TomlValue;
+class TomlFrozen;
 
 /**
  * @namespace cctoml::parser
@@ -77,6 +121,50 @@ namespace parser {
      */
     TomlValue parse(std::string_view data);
 
+    /**
+     * @struct ParseOptions
+     * @brief 解析选项。
+     */
+    struct ParseOptions {
+        /**
+         * @brief 数组与内联表允许的最大嵌套深度。
+         *
+         * 嵌套结构使用显式栈解析，不会因深度耗尽调用栈；该限制用于拒绝恶意或异常的输入。
+         */
+        size_t maxDepth = 1024;
+    };
+
+    /**
+     * @brief 按指定选项解析 TOML 格式的字符串数据。
+     * @param data 输入的 TOML 数据（字符串视图）
+     * @param options 解析选项。
+     * @return 解析结果，返回一个 TomlValue 对象。
+     * @throws TomlParseException 如果解析失败或嵌套深度超过 options.maxDepth，抛出异常。
+     */
+    TomlValue parse(std::string_view data, const ParseOptions& options);
+
+#    if defined(CCTOML_USE_PMR)
+    /**
+     * @brief 解析 TOML 数据，所有字符串、数组和对象都从指定的内存资源分配。
+     * @param data 输入的 TOML 数据（字符串视图）
+     * @param resource 内存资源（如 std::pmr::monotonic_buffer_resource），生命周期须长于结果。
+     * @return 解析结果。
+     * @throws TomlParseException 如果解析失败，抛出包含错误信息的异常。
+     */
+    TomlValue parse(std::string_view data, std::pmr::memory_resource* resource);
+
+    /**
+     * @brief 按指定选项解析 TOML 数据，所有存储都从指定的内存资源分配。
+     * @param data 输入的 TOML 数据（字符串视图）
+     * @param options 解析选项。
+     * @param resource 内存资源，生命周期须长于结果。
+     * @return 解析结果。
+     * @throws TomlParseException 如果解析失败或嵌套深度超过 options.maxDepth，抛出异常。
+     */
+    TomlValue parse(std::string_view data, const ParseOptions& options,
+                    std::pmr::memory_resource* resource);
+#    endif
+
     /**
      * @enum StringifyType
      * @brief 序列化格式的枚举。
@@ -98,11 +186,90 @@ namespace parser {
      */
     std::string
     stringify(const TomlValue& value, StringifyType type = StringifyType::TO_TOML, int indent = 0);
+
+    /**
+     * @brief 多线程序列化，结果与 stringify() 逐字节相同。
+     *
+     * 根对象的顶层字段、每个子表以及表数组中的每一批元素各为一段，在线程池中分别序列化到
+     * 独立的缓冲区后按原顺序拼接。只有 TO_TOML 格式且根为对象时才会并行，其余情况等同于
+     * stringify()。
+     *
+     * @param value 要序列化的 TomlValue 对象。
+     * @param type 序列化格式。
+     * @param indent 缩进空格数（同 stringify()）
+     * @param threads 线程数，0 表示使用硬件并发数。
+     * @return 序列化后的字符串。
+     */
+    std::string stringifyParallel(const TomlValue& value,
+                                  StringifyType    type    = StringifyType::TO_TOML,
+                                  int              indent  = 0,
+                                  size_t           threads = 0);
+
+    /**
+     * @brief 多线程序列化并写入文件。
+     *
+     * 分段方式同 stringifyParallel()，各段缓冲区不再拼接，而是按顺序直接写出（POSIX 上使用
+     * writev 成批写入）
+     *
+     * @param path 文件路径（已存在时覆盖）
+     * @param value 要序列化的 TomlValue 对象。
+     * @param type 序列化格式。
+     * @param indent 缩进空格数（同 stringify()）
+     * @param threads 线程数，0 表示使用硬件并发数。
+     * @throws TomlException 如果文件无法打开或写入失败，抛出异常。
+     */
+    void stringifyToFile(const std::string& path,
+                         const TomlValue&   value,
+                         StringifyType      type    = StringifyType::TO_TOML,
+                         int                indent  = 0,
+                         size_t             threads = 0);
 }  // namespace parser
 
+#    if defined(CCTOML_USE_PMR)
+// 使用 std::pmr 容器: 内存来自 TomlResourceScope / parser::parse(data, resource) 指定的资源
+using TomlString = std::pmr::string;                 ///< TOML 字符串类型别名。
+using TomlArray  = std::pmr::vector<TomlValue>;      ///< TOML 数组类型别名。
+/**
+ * @brief TOML 对象类型别名（键值对映射）
+ * @note 使用透明比较器 std::less<>，可直接以 std::string_view / const char* 查找而无需构造临时字符串。
+ */
+using TomlObject = std::pmr::map<TomlString, TomlValue, std::less<>>;
+
+/**
+ * @class TomlResourceScope
+ * @brief 在作用域内把当前线程新建 TomlValue 所用的内存资源切换为指定资源（仅 CCTOML_USE_PMR）
+ *
+ * 作用域内构造的字符串、日期、数组、对象及其元素都从该资源分配；拷贝沿用源值的资源，
+ * 拷贝赋值沿用目标的资源。资源的生命周期必须长于其中分配的所有值。
+ */
+class TomlResourceScope {
+  public:
+    /**
+     * @brief 切换当前线程的资源。
+     * @param resource 内存资源，不能为 nullptr。
+     */
+    explicit TomlResourceScope(std::pmr::memory_resource* resource) noexcept;
+
+    /**
+     * @brief 恢复进入作用域前的资源。
+     */
+    ~TomlResourceScope();
+
+    TomlResourceScope(const TomlResourceScope&)            = delete;
+    TomlResourceScope& operator=(const TomlResourceScope&) = delete;
+
+  private:
+    std::pmr::memory_resource* m_previous;  ///< 进入作用域前的资源
+};
+#    else
 using TomlString = std::string;                      ///< TOML 字符串类型别名。
 using TomlArray  = std::vector<TomlValue>;           ///< TOML 数组类型别名。
-using TomlObject = std::map<TomlString, TomlValue>;  ///< TOML 对象类型别名（键值对映射）
+/**
+ * @brief TOML 对象类型别名（键值对映射）
+ * @note 使用透明比较器 std::less<>，可直接以 std::string_view / const char* 查找而无需构造临时字符串。
+ */
+using TomlObject = std::map<TomlString, TomlValue, std::less<>>;
+#    endif
 
 /**
  * @class TomlDate
@@ -126,6 +293,11 @@ class TomlDate {
     };
 
   public:
+    /**
+     * @brief 默认构造函数，构造一个 INVALID 类型的日期。
+     */
+    constexpr TomlDate() noexcept : m_type(TomlDateTimeType::INVALID) {}
+
     /**
      * @brief 从 TOML 格式的字符串构造 TomlDate 对象。
      * @param s 输入的 TOML 日期/时间字符串。
@@ -139,27 +311,53 @@ class TomlDate {
      * @brief 拷贝构造函数。
      * @param date 要拷贝的 TomlDate 对象。
      */
-    TomlDate(const TomlDate& date) noexcept;
+    constexpr TomlDate(const TomlDate& date) noexcept = default;
 
     /**
      * @brief 移动构造函数。
      * @param date 要移动的 TomlDate 对象。
      */
-    TomlDate(TomlDate&& date) noexcept;
+    constexpr TomlDate(TomlDate&& date) noexcept
+        : m_type(date.m_type), m_core(date.m_core), m_subSecond(date.m_subSecond) {
+        // 赋值原date
+        date.m_type = TomlDateTimeType::INVALID;
+        date.m_core = date.m_subSecond = 0;
+    }
 
     /**
      * @brief 拷贝赋值运算符。
      * @param date 要拷贝的 TomlDate 对象。
      * @return 自身引用。
      */
-    TomlDate& operator=(const TomlDate& date) noexcept;
+    constexpr TomlDate& operator=(const TomlDate& date) noexcept = default;
 
     /**
      * @brief 移动赋值运算符。
      * @param date 要移动的 TomlDate 对象。
      * @return 自身引用。
      */
-    TomlDate& operator=(TomlDate&& date) noexcept;
+    constexpr TomlDate& operator=(TomlDate&& date) noexcept {
+        m_type      = date.m_type;
+        m_core      = date.m_core;
+        m_subSecond = date.m_subSecond;
+        // 赋值原date
+        date.m_type = TomlDateTimeType::INVALID;
+        date.m_core = date.m_subSecond = 0;
+        return *this;
+    }
+
+    /**
+     * @brief 从指定位置单遍词法分析一个 TOML 日期/时间字面量。
+     *
+     * 校验与打包同时完成，结果直接写入 m_core；定宽的 YYYY-MM-DD 与 hh:mm:ss 部分使用
+     * SWAR（一次 64 位读取处理 8 个字节）解析。字面量之后的内容不会被消耗。
+     *
+     * @param sv 输入字符串视图。
+     * @param position 起始位置，成功时更新为字面量之后的位置，失败时保持不变。
+     * @param date 输出的日期对象，仅在成功时被写入。
+     * @return 如果从 position 开始是合法的日期/时间字面量，返回 true，否则返回 false。
+     */
+    static bool lex(std::string_view sv, size_t& position, TomlDate& date) noexcept;
 
     /**
      * @brief 获取日期/时间的类型。
@@ -294,7 +492,7 @@ class TomlDate {
      */
     inline std::optional<int> getTzOffset() const noexcept {
         if (m_type == TomlDateTimeType::OFFSET_DATE_TIME) {
-            return static_cast<int>(getSignedBits(m_core, 11, 11));
+            return static_cast<int>(getSignedBits(m_core, 10, 12));
         }
         return std::nullopt;
     }
@@ -312,12 +510,134 @@ class TomlDate {
     std::string toString() const noexcept;
 
     /**
-     * @brief 将 OFFSET_DATE_TIME 转换为 std::chrono::system_clock::time_point。
-     * @return 系统时间点。
-     * @throws TomlException 如果不是 OFFSET_DATE_TIME 类型，抛出异常。
+     * @brief format 最多写入的字节数（如 "YYYY-MM-DDThh:mm:ss.nnnnnnnnn+hh:mm"）。
+     */
+    static constexpr size_t FORMAT_BUFFER_SIZE = 35;
+
+    /**
+     * @brief 将对象格式化到调用方提供的缓冲区，不分配内存。
+     *
+     * 两位数字通过查表一次写出，输出与 toString() 完全一致（不写入结尾的 '\0'）。
+     *
+     * @param out 输出缓冲区，至少可容纳 FORMAT_BUFFER_SIZE 个字节。
+     * @return 实际写入的字节数，INVALID 类型返回 0。
+     */
+    size_t format(char* out) const noexcept;
+
+    /**
+     * @brief 将日期/时间转换为 std::chrono::system_clock::time_point。
+     * @return 系统时间点，语义同 toUnixNanos()。
+     * @throws TomlException 如果是 INVALID 类型，抛出异常。
      */
     std::chrono::system_clock::time_point toSystemTimePoint() const;
 
+    /**
+     * @brief 将日期/时间转换为距 Unix 纪元（1970-01-01T00:00:00Z）的纳秒数。
+     *
+     * 纯算术实现（不调用 timegm），支持全部四种类型：<br/>
+     * 1. OFFSET_DATE_TIME：减去时区偏移后的 UTC 时间<br/>
+     * 2. LOCAL_DATE_TIME：按 UTC 解释<br/>
+     * 3. LOCAL_DATE：当天 00:00:00 UTC<br/>
+     * 4. LOCAL_TIME：距当天零点的纳秒数
+     *
+     * @return 纳秒数，INVALID 类型返回 0。
+     * @note int64_t 纳秒可表示的范围约为 1677 年至 2262 年，超出范围的结果会溢出。
+     */
+    constexpr int64_t toUnixNanos() const noexcept {
+        if (m_type == TomlDateTimeType::INVALID) {
+            return 0;
+        }
+        const int64_t days =
+            m_type == TomlDateTimeType::LOCAL_TIME
+                ? 0
+                : daysFromCivil(getSignedBits(m_core, 48, 16),
+                                static_cast<unsigned>(getBits(m_core, 44, 4)),
+                                static_cast<unsigned>(getBits(m_core, 39, 5)));
+        const int64_t offset =
+            m_type == TomlDateTimeType::OFFSET_DATE_TIME ? getSignedBits(m_core, 10, 12) : 0;
+        const int64_t seconds = days * 86400 + getBits(m_core, 34, 5) * 3600 +
+                                (getBits(m_core, 28, 6) - offset) * 60 + getBits(m_core, 22, 6);
+        return seconds * 1000000000 + m_subSecond;
+    }
+
+    /**
+     * @brief 从距 Unix 纪元的纳秒数构造日期/时间，是 toUnixNanos() 的逆运算。
+     * @param nanos 距 1970-01-01T00:00:00Z 的纳秒数（LOCAL_TIME 时仅取一天之内的部分）
+     * @param type 目标类型。
+     * @param tzOffset 时区偏移（分钟，仅对 OFFSET_DATE_TIME 有效）
+     * @return 构造的 TomlDate 对象，type 为 INVALID 时返回 INVALID 日期。
+     */
+    static TomlDate fromUnixNanos(int64_t          nanos,
+                                  TomlDateTimeType type     = TomlDateTimeType::OFFSET_DATE_TIME,
+                                  int              tzOffset = 0) noexcept;
+
+    /**
+     * @brief 批量将日期转换为 Unix 纳秒数。
+     * @param dates 连续存储的日期。
+     * @param count 日期个数。
+     * @param out 输出缓冲区，至少可容纳 count 个元素。
+     */
+    static void batchToUnixNanos(const TomlDate* dates, size_t count, int64_t* out) noexcept;
+
+    /**
+     * @brief 批量将 TOML 数组中的日期转换为 Unix 纳秒数。
+     * @param array 元素均为日期的 TOML 数组。
+     * @return 与数组一一对应的纳秒数。
+     * @throws TomlException 如果数组中存在非日期元素，抛出异常。
+     */
+    static std::vector<int64_t> batchToUnixNanos(const TomlArray& array);
+
+    /**
+     * @brief 批量从 Unix 纳秒数构造日期。
+     * @param nanos 连续存储的纳秒数。
+     * @param count 元素个数。
+     * @param out 输出缓冲区，至少可容纳 count 个元素。
+     * @param type 目标类型。
+     * @param tzOffset 时区偏移（分钟，仅对 OFFSET_DATE_TIME 有效）
+     */
+    static void
+    batchFromUnixNanos(const int64_t*   nanos,
+                       size_t           count,
+                       TomlDate*        out,
+                       TomlDateTimeType type     = TomlDateTimeType::OFFSET_DATE_TIME,
+                       int              tzOffset = 0) noexcept;
+
+    /**
+     * @brief 计算公历日期距 1970-01-01 的天数（纯算术，可在编译期求值）。
+     * @param year 年份。
+     * @param month 月份（1-12）
+     * @param day 日期（1-31）
+     * @return 距 Unix 纪元的天数（可为负）
+     */
+    static constexpr int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) noexcept {
+        year -= month <= 2;
+        const int64_t  era = (year >= 0 ? year : year - 399) / 400;
+        const auto     yoe = static_cast<unsigned>(year - era * 400);                // [0, 399]
+        const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;  // [0, 146096]
+        return era * 146097 + static_cast<int64_t>(doe) - 719468;
+    }
+
+    /**
+     * @brief 由距 1970-01-01 的天数计算公历日期，是 daysFromCivil 的逆运算。
+     * @param days 距 Unix 纪元的天数（可为负）
+     * @param year 输出：年份。
+     * @param month 输出：月份（1-12）
+     * @param day 输出：日期（1-31）
+     */
+    static constexpr void
+    civilFromDays(int64_t days, int64_t& year, unsigned& month, unsigned& day) noexcept {
+        days += 719468;
+        const int64_t  era = (days >= 0 ? days : days - 146096) / 146097;
+        const auto     doe = static_cast<unsigned>(days - era * 146097);                // [0, 146096]
+        const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;  // [0, 399]
+        const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);                // [0, 365]
+        const unsigned mp  = (5 * doy + 2) / 153;                                    // [0, 11]
+        day                = doy - (153 * mp + 2) / 5 + 1;
+        month              = mp < 10 ? mp + 3 : mp - 9;
+        year               = static_cast<int64_t>(yoe) + era * 400 + (month <= 2);
+    }
+
     /**
      * @brief 比较两个 TomlDate 对象是否相等。
      * @param other 要比较的 TomlDate 对象。
@@ -336,6 +656,53 @@ class TomlDate {
         return !(*this == other);
     }
 
+    /**
+     * @brief 按时间先后比较两个 TomlDate 对象，可直接用于 std::sort。
+     *
+     * 先比较 toUnixNanos() 得到的时间点，时间点相同时再依次比较类型和时区偏移，
+     * 从而与 operator== 保持一致的严格弱序。
+     *
+     * @param other 要比较的 TomlDate 对象。
+     * @return 如果当前对象排在 other 之前，返回 true，否则返回 false。
+     */
+    inline bool operator<(const TomlDate& other) const noexcept {
+        const int64_t lhs = toUnixNanos(), rhs = other.toUnixNanos();
+        if (lhs != rhs) {
+            return lhs < rhs;
+        }
+        if (m_type != other.m_type) {
+            return m_type < other.m_type;
+        }
+        return m_core < other.m_core;
+    }
+
+    /**
+     * @brief 按时间先后比较两个 TomlDate 对象。
+     * @param other 要比较的 TomlDate 对象。
+     * @return 如果当前对象排在 other 之后，返回 true，否则返回 false。
+     */
+    inline bool operator>(const TomlDate& other) const noexcept {
+        return other < *this;
+    }
+
+    /**
+     * @brief 按时间先后比较两个 TomlDate 对象。
+     * @param other 要比较的 TomlDate 对象。
+     * @return 如果当前对象不排在 other 之后，返回 true，否则返回 false。
+     */
+    inline bool operator<=(const TomlDate& other) const noexcept {
+        return !(other < *this);
+    }
+
+    /**
+     * @brief 按时间先后比较两个 TomlDate 对象。
+     * @param other 要比较的 TomlDate 对象。
+     * @return 如果当前对象不排在 other 之前，返回 true，否则返回 false。
+     */
+    inline bool operator>=(const TomlDate& other) const noexcept {
+        return !(*this < other);
+    }
+
     /**
      * @brief 输出 TomlDate 对象到流。
      * @param os 输出流。
@@ -343,21 +710,12 @@ class TomlDate {
      * @return 输出流引用。
      */
     inline friend std::ostream& operator<<(std::ostream& os, const TomlDate& tomlDate) noexcept {
-        os << tomlDate.toString();
+        char buffer[FORMAT_BUFFER_SIZE];
+        os << std::string_view(buffer, tomlDate.format(buffer));
         return os;
     }
 
   private:
-    /**
-     * @brief 解析指定长度的数字。
-     * @param sv 输入字符串视图。
-     * @param position 当前解析位置（会被更新）。
-     * @param count 要解析的数字位数。
-     * @return 解析出的整数值（如果成功），否则返回 std::nullopt。
-     */
-    static std::optional<int>
-    ParseDigits(const std::string_view& sv, size_t& position, int count) noexcept;
-
     /**
      * @brief 在指定位范围存储值。
      * @param target 目标存储变量。
@@ -379,7 +737,7 @@ class TomlDate {
      * @param bitCount 位数。
      * @return 提取的值。
      */
-    static int64_t getBits(int64_t source, int startBit, int bitCount) noexcept {
+    static constexpr int64_t getBits(int64_t source, int startBit, int bitCount) noexcept {
         int64_t mask = (1LL << bitCount) - 1;
         return (source >> startBit) & mask;
     }
@@ -391,7 +749,7 @@ class TomlDate {
      * @param bitCount 位数。
      * @return 提取的有符号值。
      */
-    static int64_t getSignedBits(int64_t source, int startBit, int bitCount) noexcept {
+    static constexpr int64_t getSignedBits(int64_t source, int startBit, int bitCount) noexcept {
         int64_t raw     = getBits(source, startBit, bitCount);
         int64_t signBit = 1LL << (bitCount - 1);  // 符号位位置
         if (raw & signBit) {                      // 负数（补码）
@@ -456,136 +814,358 @@ class TomlDate {
      * @param tzOffset 时区偏移值（分钟）。
      */
     inline void setTzOffset(int tzOffset) noexcept {
-        // 时区偏移：11位，startBit=11，bitCount=11
-        setBits(m_core, tzOffset, 11, 11);
+        // 时区偏移：12位，startBit=10，bitCount=12（可表示 ±23:59）
+        setBits(m_core, tzOffset, 10, 12);
     }
 
     /**
-     * @brief 解析时间部分（hh:mm:ss）。
-     * @param sv 输入字符串视图。
-     * @param position 当前解析位置（会被更新）。
-     * @return 如果解析成功，返回 true，否则返回 false。
+     * @brief 解析 TOML 格式的日期/时间字符串。
+     * @param s 输入字符串视图。
+     * @throws TomlException 如果解析失败，抛出异常。
      */
-    bool parseTimePart(const std::string_view& sv, size_t& position) noexcept;
+    void parse(const std::string_view& s);
 
     /**
-     * @brief 解析亚秒部分。
-     * @param sv 输入字符串视图。
-     * @param position 当前解析位置（会被更新）。
-     * @throws TomlException 如果解析失败，抛出异常。
+     * @brief 由已打包的字段直接构造（供编译期解析的 TOML 字面量使用）
+     * @param type 日期/时间类型。
+     * @param core 打包的年月日时分秒和时区偏移。
+     * @param subSecond 亚秒值（纳秒）
      */
-    void parseSubSecond(const std::string_view& sv, size_t& position);
+    constexpr TomlDate(TomlDateTimeType type, int64_t core, int64_t subSecond) noexcept
+        : m_type(type), m_core(core), m_subSecond(subSecond) {}
+
+    template <size_t, size_t, size_t>
+    friend struct TomlStaticImage;
+
+  private:
+    TomlDateTimeType m_type;          ///< 日期/时间类型。
+    int64_t          m_core{0};       ///< 存储年月日时分秒和时区偏移。
+    int64_t          m_subSecond{0};  ///< 存储亚秒值（纳秒），0 表示无亚秒。
+};
 
+/**
+ * @class TomlDateArray
+ * @brief 紧凑存储的日期数组。
+ *
+ * 每个元素仅保存归一化的 UTC 纳秒键（与 TomlDate::toUnixNanos() 一致）以及原始的时区偏移和类型，
+ * 可直接 std::sort，并在有序时通过二分查找进行范围查询；需要时可无损还原为 TomlDate。
+ */
+class TomlDateArray {
+  public:
     /**
-     * @brief 解析时区偏移部分。
-     * @param sv 输入字符串视图。
-     * @param position 当前解析位置（会被更新）。
-     * @throws TomlException 如果解析失败，抛出异常。
+     * @struct Entry
+     * @brief 紧凑日期元素：排序键加原始时区偏移和类型。
      */
-    void parseTimezoneOffset(const std::string_view& sv, size_t& position);
+    struct Entry {
+        int64_t                    nanos{0};     ///< 归一化的 UTC 纳秒数（排序键）
+        int16_t                    tzOffset{0};  ///< 原始时区偏移（分钟）
+        TomlDate::TomlDateTimeType type{TomlDate::TomlDateTimeType::INVALID};  ///< 原始类型
+
+        Entry() = default;
+
+        /**
+         * @brief 从 TomlDate 构造紧凑元素。
+         * @param date 日期对象。
+         */
+        Entry(const TomlDate& date) noexcept
+            : nanos(date.toUnixNanos()),
+              tzOffset(static_cast<int16_t>(date.getTzOffset().value_or(0))),
+              type(date.type()) {}
+
+        /**
+         * @brief 还原为 TomlDate 对象。
+         * @return 与构造时等价的 TomlDate 对象。
+         */
+        TomlDate toDate() const noexcept {
+            return TomlDate::fromUnixNanos(nanos, type, tzOffset);
+        }
+
+        /**
+         * @brief 按排序键比较，规则与 TomlDate::operator< 一致。
+         * @param other 另一个元素。
+         * @return 如果当前元素排在 other 之前，返回 true，否则返回 false。
+         */
+        bool operator<(const Entry& other) const noexcept {
+            if (nanos != other.nanos) {
+                return nanos < other.nanos;
+            }
+            if (type != other.type) {
+                return type < other.type;
+            }
+            return tzOffset < other.tzOffset;
+        }
+
+        /**
+         * @brief 比较两个元素是否相等。
+         * @param other 另一个元素。
+         * @return 如果相等，返回 true，否则返回 false。
+         */
+        bool operator==(const Entry& other) const noexcept {
+            return nanos == other.nanos && tzOffset == other.tzOffset && type == other.type;
+        }
+    };
+
+    using const_iterator = std::vector<Entry>::const_iterator;  ///< 只读迭代器类型。
+
+    TomlDateArray() = default;
 
     /**
-     * @brief 解析本地时间格式。
-     * @param sv 输入字符串视图。
-     * @return 如果解析成功，返回 true，否则返回 false。
+     * @brief 从元素均为日期的 TOML 数组构造。
+     * @param array TOML 数组。
+     * @throws TomlException 如果数组中存在非日期元素，抛出异常。
      */
-    bool parseLocalTime(const std::string_view& sv) noexcept;
+    explicit TomlDateArray(const TomlArray& array);
 
     /**
-     * @brief 解析日期时间格式。
-     * @param sv 输入字符串视图。
-     * @return 如果解析成功，返回 true，否则返回 false。
-     * @throws TomlException 如果解析失败，抛出异常。
+     * @brief 获取元素个数。
+     * @return 元素个数。
      */
-    bool parseDateTime(const std::string_view& sv);
+    inline size_t size() const noexcept {
+        return m_entries.size();
+    }
 
     /**
-     * @brief 解析 TOML 格式的日期/时间字符串。
-     * @param s 输入字符串视图。
-     * @throws TomlException 如果解析失败，抛出异常。
+     * @brief 检查数组是否为空。
+     * @return 如果为空，返回 true，否则返回 false。
      */
-    void parse(const std::string_view& s);
+    inline bool empty() const noexcept {
+        return m_entries.empty();
+    }
+
+    /**
+     * @brief 预留容量。
+     * @param capacity 容量。
+     */
+    inline void reserve(size_t capacity) {
+        m_entries.reserve(capacity);
+    }
+
+    /**
+     * @brief 追加一个日期。
+     * @param date 日期对象。
+     */
+    inline void push_back(const TomlDate& date) {
+        m_entries.emplace_back(date);
+    }
+
+    /**
+     * @brief 获取指定下标的日期。
+     * @param index 下标（调用方保证不越界）
+     * @return 还原后的 TomlDate 对象。
+     */
+    inline TomlDate operator[](size_t index) const noexcept {
+        return m_entries[index].toDate();
+    }
+
+    /**
+     * @brief 获取指定下标的紧凑元素。
+     * @param index 下标（调用方保证不越界）
+     * @return 紧凑元素的常量引用。
+     */
+    inline const Entry& entry(size_t index) const noexcept {
+        return m_entries[index];
+    }
+
+    /**
+     * @brief 获取起始迭代器。
+     * @return 指向第一个紧凑元素的迭代器。
+     */
+    inline const_iterator begin() const noexcept {
+        return m_entries.begin();
+    }
+
+    /**
+     * @brief 获取结束迭代器。
+     * @return 指向末尾的迭代器。
+     */
+    inline const_iterator end() const noexcept {
+        return m_entries.end();
+    }
+
+    /**
+     * @brief 按时间升序排序。
+     */
+    void sort();
+
+    /**
+     * @brief 检查是否已按时间升序排列。
+     * @return 如果有序，返回 true，否则返回 false。
+     */
+    bool isSorted() const noexcept;
+
+    /**
+     * @brief 二分查找第一个不早于指定时间点的元素（要求数组有序）。
+     * @param nanos 距 Unix 纪元的纳秒数。
+     * @return 元素下标，全部早于该时间点时返回 size()。
+     */
+    size_t lowerBound(int64_t nanos) const noexcept;
+
+    /**
+     * @brief 二分查找第一个不早于指定时间点的元素（要求数组有序）。
+     * @param timePoint 系统时间点。
+     * @return 元素下标，全部早于该时间点时返回 size()。
+     */
+    size_t lowerBound(std::chrono::system_clock::time_point timePoint) const noexcept;
+
+    /**
+     * @brief 二分查找第一个晚于指定时间点的元素（要求数组有序）。
+     * @param nanos 距 Unix 纪元的纳秒数。
+     * @return 元素下标，没有晚于该时间点的元素时返回 size()。
+     */
+    size_t upperBound(int64_t nanos) const noexcept;
+
+    /**
+     * @brief 二分查找第一个晚于指定时间点的元素（要求数组有序）。
+     * @param timePoint 系统时间点。
+     * @return 元素下标，没有晚于该时间点的元素时返回 size()。
+     */
+    size_t upperBound(std::chrono::system_clock::time_point timePoint) const noexcept;
+
+    /**
+     * @brief 还原为普通的 TOML 数组。
+     * @return 元素均为日期的 TOML 数组。
+     */
+    TomlArray toArray() const;
 
   private:
-    TomlDateTimeType m_type;          ///< 日期/时间类型。
-    int64_t          m_core{0};       ///< 存储年月日时分秒和时区偏移。
-    int64_t          m_subSecond{0};  ///< 存储亚秒值（纳秒），0 表示无亚秒。
+    std::vector<Entry> m_entries;  ///< 紧凑元素。
 };
 
+// 容器序列化支持
 /**
- * @struct HasToToml
- * @brief 模板元编程工具，用于检查类型是否支持 toToml 序列化函数。
+ * @brief 约束模板参数为 TomlValue（可带 const 与引用），使反序列化函数同时接受左值与右值。
  *
- * 默认情况下，HasToToml 继承自 std::false_type，表示类型 T 不支持 toToml 函数。
- * @tparam T 要检查的类型。
- * @tparam void 辅助模板参数，用于 SFINAE。
+ * 传入右值（如 fromToml(std::move(root), vec)）时，字符串与子树会被直接移动到结果中，
+ * root 之后只能被销毁或重新赋值。V 总是排在元素类型之后，
+ * 显式指定元素类型的调用（如 fromToml<std::string>(root, vec)）仍然有效。
  */
-template <typename T, typename = void>
-struct HasToToml : std::false_type {};
+template <typename V>
+using EnableIfTomlValue = std::enable_if_t<std::is_same_v<std::decay_t<V>, TomlValue>, int>;
 
 /**
- * @struct HasToToml&lt;T, std::void_t&lt;decltype(toToml(std::declval&lt;const T&&gt;()))&gt;&gt;
- * @brief HasToToml 的特化版本，检查类型是否具有有效的 toToml 函数。
- *
- * 如果类型 T 具有 toToml 函数且返回值类型为 TomlValue，则继承自 std::true_type。
- * @tparam T 要检查的类型。
+ * @brief 约束 Map 为键为 std::string 的 std::map 或 std::unordered_map。
  */
-template <typename T>
-struct HasToToml<T, std::void_t<decltype(toToml(std::declval<const T&>()))>>
-    : std::is_same<decltype(toToml(std::declval<const T&>())), TomlValue> {};
+template <typename Map, typename T = typename Map::mapped_type>
+using EnableIfStringMap =
+    std::enable_if_t<std::is_same_v<typename Map::key_type, std::string> &&
+                     (std::is_same_v<Map, std::map<std::string, T>> ||
+                      std::is_same_v<Map, std::map<std::string, T, std::less<>>> ||
+                      std::is_same_v<Map, std::unordered_map<std::string, T>>)>;
 
 /**
- * @struct HasFromToml
- * @brief 模板元编程工具，用于检查类型是否支持 fromToml 反序列化函数。
- *
- * 默认情况下，HasFromToml 继承自 std::false_type，表示类型 T 不支持 fromToml 函数。
- * @tparam T 要检查的类型。
- * @tparam void 辅助模板参数，用于 SFINAE。
+ * @brief Toml 对象反序列化为 std::vector
+ * @tparam T 向量元素的类型
+ * @tparam V TomlValue 的转发引用类型
+ * @param root 要反序列化的 Toml 对象（右值时移动其元素）
+ * @param vec 反序列化后的 std::vector 对象
+ * @note 如果 T 支持 fromToml函数，则使用 fromToml 进行反序列化；否则直接构造 TomlValue
  */
-template <typename T, typename = void>
-struct HasFromToml : std::false_type {};
+template <typename T, typename V, EnableIfTomlValue<V> = 0>
+void fromToml(V&& root, std::vector<T>& vec);
 
 /**
- * @struct HasFromToml&lt;T, std::void_t&lt;decltype(fromToml(std::declval&lt;const
- * TomlValue&&gt;(), std::declval&lt;T&>()))&gt;&gt;
- * @brief HasFromToml 的特化版本，检查类型是否具有有效的 fromToml 函数。
- *
- * 如果类型 T 具有 fromToml 函数且返回值类型为 void，则继承自 std::true_type。
- * @tparam T 要检查的类型。
+ * @brief Toml 数组反序列化为 std::deque
+ * @tparam T 元素类型
+ * @tparam V TomlValue 的转发引用类型
+ * @param root 要反序列化的 Toml 数组（右值时移动其元素）
+ * @param deque 反序列化后的 std::deque 对象
  */
-template <typename T>
-struct HasFromToml<
-    T,
-    std::void_t<decltype(fromToml(std::declval<const TomlValue&>(), std::declval<T&>()))>>
-    : std::is_same<decltype(fromToml(std::declval<const TomlValue&>(), std::declval<T&>())), void> {
-};
+template <typename T, typename V, EnableIfTomlValue<V> = 0>
+void fromToml(V&& root, std::deque<T>& deque);
 
-// 容器序列化支持
 /**
- * @brief Toml 对象反序列化为 std::vector
- * @tparam T 向量元素的类型
- * @param root 要反序列化的 Toml 对象
- * @param vec 反序列化后的 std::vector 对象
- * @note 如果 T 支持 fromToml函数，则使用 fromToml 进行反序列化；否则直接构造 TomlValue
+ * @brief Toml 数组反序列化为 std::array
+ * @tparam T 元素类型
+ * @tparam N 数组长度
+ * @tparam V TomlValue 的转发引用类型
+ * @param root 要反序列化的 Toml 数组（右值时移动其元素）
+ * @param array 反序列化后的 std::array 对象
+ * @throws TomlException 如果 Toml 数组长度不等于 N，抛出异常
  */
-template <typename T>
-void fromToml(const TomlValue& root, std::vector<T>& vec);
+template <typename T, size_t N, typename V, EnableIfTomlValue<V> = 0>
+void fromToml(V&& root, std::array<T, N>& array);
+
+/**
+ * @brief Toml 数组反序列化为 std::set
+ * @tparam T 元素类型
+ * @tparam V TomlValue 的转发引用类型
+ * @param root 要反序列化的 Toml 数组（右值时移动其元素）
+ * @param set 反序列化后的 std::set 对象
+ */
+template <typename T, typename V, EnableIfTomlValue<V> = 0>
+void fromToml(V&& root, std::set<T>& set);
+
+/**
+ * @brief 长度为 2 的 Toml 数组反序列化为 std::pair
+ * @tparam A 第一个元素类型
+ * @tparam B 第二个元素类型
+ * @tparam V TomlValue 的转发引用类型
+ * @param root 要反序列化的 Toml 数组（右值时移动其元素）
+ * @param pair 反序列化后的 std::pair 对象
+ * @throws TomlException 如果 Toml 数组长度不为 2，抛出异常
+ */
+template <typename A, typename B, typename V, EnableIfTomlValue<V> = 0>
+void fromToml(V&& root, std::pair<A, B>& pair);
+
+/**
+ * @brief Toml 数组按位置反序列化为 std::tuple
+ * @tparam Ts 各元素类型
+ * @tparam V TomlValue 的转发引用类型
+ * @param root 要反序列化的 Toml 数组（右值时移动其元素）
+ * @param tuple 反序列化后的 std::tuple 对象
+ * @throws TomlException 如果 Toml 数组长度与元组不一致，抛出异常
+ */
+template <typename... Ts, typename V, EnableIfTomlValue<V> = 0>
+void fromToml(V&& root, std::tuple<Ts...>& tuple);
+
+/**
+ * @brief Toml 值反序列化为 std::optional（总是得到有值的结果）
+ * @tparam T 值类型
+ * @tparam V TomlValue 的转发引用类型
+ * @param root 要反序列化的 Toml 值（右值时移动其内容）
+ * @param optional 反序列化后的 std::optional 对象
+ * @note 键不存在的情况由调用方处理，例如配合 TomlValue::find()
+ */
+template <typename T, typename V, EnableIfTomlValue<V> = 0>
+void fromToml(V&& root, std::optional<T>& optional);
 
 /**
  * @brief 将 Toml 对象反序列化为键为字符串的映射
  * @tparam Map 映射类型（std::map 或 std::unordered_map）
  * @tparam T 映射值的类型
  * @tparam S SFINAE 约束，确保键类型为 std::string 且 Map 为 std::map 或 std::unordered_map
- * @param root 要反序列化的 Toml 对象
+ * @tparam V TomlValue 的转发引用类型
+ * @param root 要反序列化的 Toml 对象（右值时移动其键与值）
  * @param map 反序列化后的映射对象
  * @note 如果值类型支持 fromToml 函数，则使用 fromToml 反序列化；否则直接构造 TomlValue
  */
 template <typename Map,
-          typename T = typename Map::mapped_type,
-          typename S = std::enable_if_t<std::is_same_v<typename Map::key_type, std::string> &&
-                                        (std::is_same_v<Map, std::map<std::string, T>> ||
-                                         std::is_same_v<Map, std::unordered_map<std::string, T>>)>>
-void fromToml(const TomlValue& root, Map& map);
+          typename T           = typename Map::mapped_type,
+          typename S           = EnableIfStringMap<Map, T>,
+          typename V,
+          EnableIfTomlValue<V> = 0>
+void fromToml(V&& root, Map& map);
+
+/**
+ * @brief Toml 数值反序列化为 std::chrono::duration（以该 duration 的单位计数）
+ * @tparam Rep 计数类型
+ * @tparam Period 单位
+ * @param root 要反序列化的 Toml 数值
+ * @param duration 反序列化后的时长
+ */
+template <typename Rep, typename Period>
+void fromToml(const TomlValue& root, std::chrono::duration<Rep, Period>& duration);
+
+/**
+ * @brief Toml 日期反序列化为 std::chrono::system_clock 时间点
+ * @tparam Duration 时间点精度
+ * @param root 要反序列化的 Toml 日期
+ * @param timePoint 反序列化后的时间点
+ * @throws TomlException 如果不是日期类型，抛出异常
+ */
+template <typename Duration>
+void fromToml(const TomlValue& root,
+              std::chrono::time_point<std::chrono::system_clock, Duration>& timePoint);
 
 /**
  * @brief 将 std::vector 序列化为 Toml 数组。
@@ -597,6 +1177,63 @@ void fromToml(const TomlValue& root, Map& map);
 template <typename T>
 TomlValue toToml(const std::vector<T>& vec);
 
+/**
+ * @brief 将 std::deque 序列化为 Toml 数组。
+ * @tparam T 元素类型。
+ * @param deque 要序列化的队列。
+ * @return 表示 Toml 数组的 TomlValue 对象。
+ */
+template <typename T>
+TomlValue toToml(const std::deque<T>& deque);
+
+/**
+ * @brief 将 std::array 序列化为 Toml 数组。
+ * @tparam T 元素类型。
+ * @tparam N 数组长度。
+ * @param array 要序列化的数组。
+ * @return 表示 Toml 数组的 TomlValue 对象。
+ */
+template <typename T, size_t N>
+TomlValue toToml(const std::array<T, N>& array);
+
+/**
+ * @brief 将 std::set 按顺序序列化为 Toml 数组。
+ * @tparam T 元素类型。
+ * @param set 要序列化的集合。
+ * @return 表示 Toml 数组的 TomlValue 对象。
+ */
+template <typename T>
+TomlValue toToml(const std::set<T>& set);
+
+/**
+ * @brief 将 std::pair 序列化为长度为 2 的 Toml 数组。
+ * @tparam A 第一个元素类型。
+ * @tparam B 第二个元素类型。
+ * @param pair 要序列化的 pair。
+ * @return 表示 Toml 数组的 TomlValue 对象。
+ */
+template <typename A, typename B>
+TomlValue toToml(const std::pair<A, B>& pair);
+
+/**
+ * @brief 将 std::tuple 按位置序列化为 Toml 数组。
+ * @tparam Ts 各元素类型。
+ * @param tuple 要序列化的元组。
+ * @return 表示 Toml 数组的 TomlValue 对象。
+ */
+template <typename... Ts>
+TomlValue toToml(const std::tuple<Ts...>& tuple);
+
+/**
+ * @brief 将 std::optional 中的值序列化（TOML 没有空值）。
+ * @tparam T 值类型。
+ * @param optional 要序列化的 optional。
+ * @return 表示其中值的 TomlValue 对象。
+ * @throws TomlException 如果 optional 为空，抛出异常。
+ */
+template <typename T>
+TomlValue toToml(const std::optional<T>& optional);
+
 /**
  * @brief 将键为字符串的映射序列化为 Toml 对象。
  * @tparam Map 映射类型（std::map 或 std::unordered_map）
@@ -608,11 +1245,123 @@ TomlValue toToml(const std::vector<T>& vec);
  */
 template <typename Map,
           typename T = typename Map::mapped_type,
-          typename S = std::enable_if_t<std::is_same_v<typename Map::key_type, std::string> &&
-                                        (std::is_same_v<Map, std::map<std::string, T>> ||
-                                         std::is_same_v<Map, std::unordered_map<std::string, T>>)>>
+          typename S = EnableIfStringMap<Map, T>>
 TomlValue toToml(const Map& map);
 
+/**
+ * @brief 将 std::chrono::duration 序列化为以其单位计数的 Toml 数值。
+ * @tparam Rep 计数类型。
+ * @tparam Period 单位。
+ * @param duration 要序列化的时长。
+ * @return 表示计数的 TomlValue 对象。
+ */
+template <typename Rep, typename Period>
+TomlValue toToml(const std::chrono::duration<Rep, Period>& duration);
+
+/**
+ * @brief 将 std::chrono::system_clock 时间点序列化为 UTC 偏移日期时间。
+ * @tparam Duration 时间点精度。
+ * @param timePoint 要序列化的时间点。
+ * @return 表示日期的 TomlValue 对象。
+ */
+template <typename Duration>
+TomlValue toToml(const std::chrono::time_point<std::chrono::system_clock, Duration>& timePoint);
+
+/**
+ * @struct HasToToml
+ * @brief 模板元编程工具，用于检查类型是否支持 toToml 序列化函数。
+ *
+ * 默认情况下，HasToToml 继承自 std::false_type，表示类型 T 不支持 toToml 函数。
+ * @tparam T 要检查的类型。
+ * @tparam void 辅助模板参数，用于 SFINAE。
+ */
+template <typename T, typename = void>
+struct HasToToml : std::false_type {};
+
+/**
+ * @struct HasToToml&lt;T, std::void_t&lt;decltype(toToml(std::declval&lt;const T&&gt;()))&gt;&gt;
+ * @brief HasToToml 的特化版本，检查类型是否具有有效的 toToml 函数。
+ *
+ * 如果类型 T 具有 toToml 函数且返回值类型为 TomlValue，则继承自 std::true_type。
+ * @tparam T 要检查的类型。
+ */
+template <typename T>
+struct HasToToml<T, std::void_t<decltype(toToml(std::declval<const T&>()))>>
+    : std::is_same<decltype(toToml(std::declval<const T&>())), TomlValue> {};
+
+/**
+ * @struct HasFromToml
+ * @brief 模板元编程工具，用于检查类型是否支持 fromToml 反序列化函数。
+ *
+ * 默认情况下，HasFromToml 继承自 std::false_type，表示类型 T 不支持 fromToml 函数。
+ * @tparam T 要检查的类型。
+ * @tparam void 辅助模板参数，用于 SFINAE。
+ */
+template <typename T, typename = void>
+struct HasFromToml : std::false_type {};
+
+/**
+ * @struct HasFromToml&lt;T, std::void_t&lt;decltype(fromToml(std::declval&lt;const
+ * TomlValue&&gt;(), std::declval&lt;T&>()))&gt;&gt;
+ * @brief HasFromToml 的特化版本，检查类型是否具有有效的 fromToml 函数。
+ *
+ * 如果类型 T 具有 fromToml 函数且返回值类型为 void，则继承自 std::true_type。
+ * @tparam T 要检查的类型。
+ */
+template <typename T>
+struct HasFromToml<
+    T,
+    std::void_t<decltype(fromToml(std::declval<const TomlValue&>(), std::declval<T&>()))>>
+    : std::is_same<decltype(fromToml(std::declval<const TomlValue&>(), std::declval<T&>())), void> {
+};
+
+/**
+ * @struct TomlMemoryUsage
+ * @brief TomlValue 树占用内存的分类统计（字节），由 TomlValue::memoryUsage() 计算。
+ *
+ * 各分类互不重叠，total() 为整棵树（含根节点本身）的估算占用；其中 slack() 部分是
+ * 已分配但未使用的容量，可通过 TomlValue::shrinkToFit() 回收。
+ */
+struct TomlMemoryUsage {
+    size_t nodes       = 0;  ///< TomlValue 节点本身（根、数组元素与对象成员的值）
+    size_t strings     = 0;  ///< 字符串对象及其堆上字符数据（包括对象的键）
+    size_t stringSlack = 0;  ///< 其中字符串已分配未使用的容量
+    size_t arrays      = 0;  ///< 数组对象本身
+    size_t arraySlack  = 0;  ///< 数组缓冲区中未使用的元素槽位
+    size_t mapNodes    = 0;  ///< 对象本身与红黑树节点开销（不含键内容与值节点）
+    size_t dates       = 0;  ///< 日期存储
+    size_t nodeCount   = 0;  ///< 节点数量
+
+    /**
+     * @brief 获取总占用。
+     */
+    size_t total() const noexcept {
+        return nodes + strings + arrays + arraySlack + mapNodes + dates;
+    }
+
+    /**
+     * @brief 获取已分配但未使用的容量（字符串与数组）
+     */
+    size_t slack() const noexcept {
+        return stringSlack + arraySlack;
+    }
+
+    /**
+     * @brief 累加另一份统计（如多个文档或多个子树）
+     */
+    TomlMemoryUsage& operator+=(const TomlMemoryUsage& other) noexcept {
+        nodes += other.nodes;
+        strings += other.strings;
+        stringSlack += other.stringSlack;
+        arrays += other.arrays;
+        arraySlack += other.arraySlack;
+        mapNodes += other.mapNodes;
+        dates += other.dates;
+        nodeCount += other.nodeCount;
+        return *this;
+    }
+};
+
 /**
  * @class TomlValue
  * @brief 表示 TOML 格式的值。
@@ -626,7 +1375,7 @@ class TomlValue {
      * @brief 默认构造函数，初始化为空对象。
      */
     TomlValue() : m_type(TomlType::Object) {
-        m_value.object = new TomlObject();
+        m_value.object = createStorage<TomlObject>();
     }
 
     /**
@@ -668,7 +1417,7 @@ class TomlValue {
                                    !std::is_same_v<std::decay_t<T>, TomlValue>,
                                int> = 0>
     TomlValue(T value) : m_type(TomlType::String) {
-        m_value.string = new TomlString(value);
+        m_value.string = createStorage<TomlString>(std::string_view(value));
     }
 
     /**
@@ -676,7 +1425,7 @@ class TomlValue {
      * @param value 字符串值（右值）。
      */
     TomlValue(TomlString&& value) : m_type(TomlType::String) {
-        m_value.string = new TomlString(std::move(value));
+        m_value.string = createStorage<TomlString>(std::move(value));
     }
 
     /**
@@ -684,7 +1433,7 @@ class TomlValue {
      * @param date TomlDate 对象。
      */
     TomlValue(const TomlDate& date) : m_type(TomlType::Date) {
-        m_value.date = new TomlDate(date);
+        m_value.date = createStorage<TomlDate>(date);
     }
 
     /**
@@ -692,7 +1441,7 @@ class TomlValue {
      * @param value TomlArray 对象。
      */
     TomlValue(const TomlArray& value) noexcept : m_type(TomlType::Array) {
-        m_value.array = new TomlArray(value);
+        m_value.array = createStorage<TomlArray>(value);
     }
 
     /**
@@ -700,7 +1449,23 @@ class TomlValue {
      * @param value TomlObject 对象。
      */
     TomlValue(const TomlObject& value) noexcept : m_type(TomlType::Object) {
-        m_value.object = new TomlObject(value);
+        m_value.object = createStorage<TomlObject>(value);
+    }
+
+    /**
+     * @brief 构造数组类型的 TomlValue（移动构造，不复制元素）
+     * @param value TomlArray 对象（右值）。
+     */
+    TomlValue(TomlArray&& value) : m_type(TomlType::Array) {
+        m_value.array = createStorage<TomlArray>(std::move(value));
+    }
+
+    /**
+     * @brief 构造对象类型的 TomlValue（移动构造，不复制键值对）
+     * @param value TomlObject 对象（右值）。
+     */
+    TomlValue(TomlObject&& value) : m_type(TomlType::Object) {
+        m_value.object = createStorage<TomlObject>(std::move(value));
     }
 
     /**
@@ -745,6 +1510,49 @@ class TomlValue {
      */
     TomlValue(TomlValue&& other) noexcept;
 
+#    if defined(CCTOML_USE_PMR)
+    using allocator_type = std::pmr::polymorphic_allocator<TomlValue>;  ///< 分配器类型。
+
+    /**
+     * @brief 在指定分配器的资源中深拷贝（pmr 容器构造元素时使用）
+     * @param alloc 分配器。
+     * @param other 要拷贝的值。
+     */
+    TomlValue(std::allocator_arg_t, const allocator_type& alloc, const TomlValue& other);
+
+    /**
+     * @brief 移动到指定分配器的资源中：资源相同时直接接管，否则逐层移动。
+     * @param alloc 分配器。
+     * @param other 要移动的值。
+     */
+    TomlValue(std::allocator_arg_t, const allocator_type& alloc, TomlValue&& other);
+
+    /**
+     * @brief 以指定分配器的资源构造（pmr 容器就地构造元素时使用）
+     * @tparam Args 构造参数类型。
+     * @param alloc 分配器。
+     * @param args 构造参数。
+     */
+    template <typename... Args,
+              std::enable_if_t<!(sizeof...(Args) == 1 &&
+                                 (std::is_same_v<std::decay_t<Args>, TomlValue> && ...)),
+                               int> = 0>
+    TomlValue(std::allocator_arg_t, const allocator_type& alloc, Args&&... args)
+        : TomlValue(constructIn(alloc.resource(), std::forward<Args>(args)...)) {}
+
+    /**
+     * @brief 获取字符串、日期、数组或对象存储所在的内存资源。
+     * @return 内存资源；其他类型返回当前线程的默认资源。
+     */
+    std::pmr::memory_resource* resource() const noexcept;
+
+    /**
+     * @brief 获取当前线程新建值所用的内存资源（TomlResourceScope 设置，默认为
+     * std::pmr::get_default_resource()）
+     */
+    static std::pmr::memory_resource* currentResource() noexcept;
+#    endif
+
     /**
      * @brief 使用初始化列表构造对象类型的 Toml 数据。
      * @tparam T 值类型。
@@ -752,7 +1560,7 @@ class TomlValue {
      */
     template <typename T>
     TomlValue(std::initializer_list<std::pair<const char*, T>> init) : m_type(TomlType::Object) {
-        m_value.object = new TomlObject();
+        m_value.object = createStorage<TomlObject>();
         for (const auto& [k, v] : init) {
             (*m_value.object)[k] = TomlValue(v);
         }
@@ -764,7 +1572,7 @@ class TomlValue {
      */
     TomlValue(std::initializer_list<std::pair<const char*, TomlValue>> init)
         : m_type(TomlType::Object) {
-        m_value.object = new TomlObject();
+        m_value.object = createStorage<TomlObject>();
         for (const auto& [k, v] : init) {
             (*m_value.object)[k] = v;
         }
@@ -781,7 +1589,7 @@ class TomlValue {
     TomlValue(std::initializer_list<T> init) {
         // 对象初始化
         m_type         = TomlType::Object;
-        m_value.object = new TomlObject();
+        m_value.object = createStorage<TomlObject>();
         for (const auto& item : init) {
             auto [k, v]          = static_cast<std::pair<const char*, TomlValue>>(item);
             (*m_value.object)[k] = v;
@@ -798,7 +1606,7 @@ class TomlValue {
     TomlValue(std::initializer_list<T> init) {
         // 数组初始化
         m_type        = TomlType::Array;
-        m_value.array = new TomlArray();
+        m_value.array = createStorage<TomlArray>();
         m_value.array->reserve(init.size());
         for (const auto& item : init) {
             m_value.array->emplace_back(TomlValue(item));
@@ -828,7 +1636,7 @@ class TomlValue {
     TomlValue& operator=(std::initializer_list<TomlValue> init) {
         destroyValue();
         m_type        = TomlType::Array;
-        m_value.array = new TomlArray(init);
+        m_value.array = createStorage<TomlArray>(init);
         return *this;
     }
 
@@ -846,7 +1654,7 @@ class TomlValue {
         destroyValue();
         // 对象赋值
         m_type         = TomlType::Object;
-        m_value.object = new TomlObject();
+        m_value.object = createStorage<TomlObject>();
         for (const auto& [k, v] : init) {
             (*m_value.object)[k] = v;
         }
@@ -867,7 +1675,7 @@ class TomlValue {
         destroyValue();
         // 数组赋值
         m_type        = TomlType::Array;
-        m_value.array = new TomlArray();
+        m_value.array = createStorage<TomlArray>();
         m_value.array->reserve(init.size());
         for (const auto& item : init) {
             m_value.array->emplace_back(TomlValue(item));
@@ -890,9 +1698,99 @@ class TomlValue {
 
     /**
      * @brief 析构函数，释放内部资源。
+     * @note 释放过程不递归，任意深度的树都不会耗尽调用栈。
      */
     ~TomlValue();
 
+    /**
+     * @brief 将当前值交给后台回收线程释放，调用后当前值变为空对象。
+     *
+     * 释放很大的树可能耗时较长，适用于在持锁的线程中替换配置等场景。
+     * 回收线程在第一次调用时启动，程序退出前会释放完所有已提交的值。
+     */
+    void releaseAsync();
+
+    /**
+     * @brief 阻塞直到所有通过 releaseAsync() 提交的值都已被释放。
+     */
+    static void flushReleased();
+
+    /**
+     * @brief 按分类统计整棵树占用的内存。
+     *
+     * 只读取各容器的 size()/capacity()，嵌套不超过 64 层时不分配堆内存。
+     * 字符串堆内存按实现的短字符串容量估算，对象节点按红黑树的节点结构估算。
+     *
+     * @return 内存统计。
+     */
+    TomlMemoryUsage memoryUsage() const;
+
+    /**
+     * @brief 把树中所有字符串与数组的容量收缩到实际大小，回收增量编辑留下的冗余容量。
+     *
+     * 数组会重新分配，指向其元素的指针、迭代器与 TomlArrayIndex 随之失效；
+     * 对象的键不可修改，保持原样。
+     *
+     * @return 回收的字节数。
+     */
+    size_t shrinkToFit();
+
+    /**
+     * @brief 把整棵树冻结为紧凑的只读形式，见 TomlFrozen。
+     * @param deduplicate 是否让结构相同的子树与相同的字符串共享存储。
+     * @return 冻结后的树。
+     */
+    TomlFrozen freeze(bool deduplicate = false) const;
+
+    /**
+     * @brief 判断两棵树是否相等：类型与值都相同，对象的键集合相同且对应的值相等。
+     * @note 整数与浮点数互不相等；比较过程不递归。
+     */
+    bool operator==(const TomlValue& other) const;
+
+    /**
+     * @brief 判断两棵树是否不相等。
+     */
+    bool operator!=(const TomlValue& other) const {
+        return !(*this == other);
+    }
+
+    /**
+     * @brief 计算整棵树的哈希值，相等的树哈希值相同。
+     */
+    size_t hash() const;
+
+    /**
+     * @brief 多线程深拷贝，结果与拷贝构造相同。
+     *
+     * 从根开始，把数组与对象的子节点分批交给工作窃取线程池：靠近根的节点按线程数切分，
+     * 更深处只有子节点很多的宽节点才继续切分，其余子树在各线程中串行拷贝。
+     * 适用于节点数很多（百万级）的树，小树直接拷贝更快。
+     *
+     * @param threads 线程数，0 表示使用硬件并发数。
+     * @return 拷贝得到的树。
+     */
+    TomlValue copyParallel(size_t threads = 0) const;
+
+    /**
+     * @brief 多线程比较两棵树，结果与 operator== 相同，切分方式同 copyParallel()
+     * @param other 要比较的树。
+     * @param threads 线程数，0 表示使用硬件并发数。
+     */
+    bool equalsParallel(const TomlValue& other, size_t threads = 0) const;
+
+    /**
+     * @brief 多线程计算哈希值，结果与 hash() 相同，切分方式同 copyParallel()
+     * @param threads 线程数，0 表示使用硬件并发数。
+     */
+    size_t hashParallel(size_t threads = 0) const;
+
+    /**
+     * @brief 多线程统计内存，结果与 memoryUsage() 相同，切分方式同 copyParallel()
+     * @param threads 线程数，0 表示使用硬件并发数。
+     */
+    TomlMemoryUsage memoryUsageParallel(size_t threads = 0) const;
+
     /**
      * @brief 获取当前值的数据类型。
      * @return TomlType 枚举值，表示当前值的类型。
@@ -1026,6 +1924,13 @@ class TomlValue {
                              std::is_same_v<rawT, std::string_view>) {
             // 字符串
             return operator std::string();
+        } else if constexpr (std::is_same_v<rawT, TomlString>) {
+            // pmr 字符串（CCTOML_USE_PMR）
+            return asString();
+        } else if constexpr (std::is_same_v<rawT, TomlArray>) {
+            return asArray();
+        } else if constexpr (std::is_same_v<rawT, TomlObject>) {
+            return asObject();
         } else if constexpr (std::is_same_v<rawT, TomlDate>) {
             // 日期
             return asDate();
@@ -1069,14 +1974,24 @@ class TomlValue {
      * @throws TomlException 如果不是对象类型，抛出异常。
      */
     template <typename T,
-              std::enable_if_t<
-                  !std::is_integral_v<std::remove_reference_t<T>> &&
-                      (std::is_convertible_v<T, std::string> ||
-                       std::is_same_v<std::remove_cv_t<std::remove_reference_t<T>>, const char*>),
-                  int> = 0>
+              std::enable_if_t<!std::is_integral_v<std::remove_reference_t<T>> &&
+                                   (std::is_convertible_v<T, std::string> ||
+                                    std::is_convertible_v<T, std::string_view>),
+                               int> = 0>
     TomlValue& operator[](T&& key) {
         auto& object = asObject();
-        return object[std::forward<T>(key)];
+        if constexpr (std::is_convertible_v<T, std::string_view>) {
+            // 先以 string_view 查找, 仅在键不存在时才构造字符串
+            const std::string_view view(key);
+            auto                   it = object.find(view);
+            if (it == object.end()) {
+                // 键直接在对象的资源中构造 (CCTOML_USE_PMR)
+                it = object.emplace(view, TomlValue()).first;
+            }
+            return it->second;
+        } else {
+            return object[std::forward<T>(key)];
+        }
     }
 
     /**
@@ -1103,14 +2018,19 @@ class TomlValue {
      * @throws TomlException 如果键不存在或不是对象类型，抛出异常。
      */
     template <typename T,
-              std::enable_if_t<
-                  !std::is_integral_v<std::remove_reference_t<T>> &&
-                      (std::is_convertible_v<T, std::string> ||
-                       std::is_same_v<std::remove_cv_t<std::remove_reference_t<T>>, const char*>),
-                  int> = 0>
+              std::enable_if_t<!std::is_integral_v<std::remove_reference_t<T>> &&
+                                   (std::is_convertible_v<T, std::string> ||
+                                    std::is_convertible_v<T, std::string_view>),
+                               int> = 0>
     const TomlValue& operator[](T&& key) const {
         const auto& object = asObject();
-        auto        it     = object.find(std::forward<T>(key));
+        auto        it     = [&] {
+            if constexpr (std::is_convertible_v<T, std::string_view>) {
+                return object.find(std::string_view(key));
+            } else {
+                return object.find(TomlString(std::forward<T>(key)));
+            }
+        }();
         if (it != object.end()) {
             return it->second;
         }
@@ -1118,49 +2038,194 @@ class TomlValue {
     }
 
     /**
-     * @brief 设置对象键值对。
-     * @param key 键名。
-     * @param value 要设置的 TomlValue 值。
-     * @return 自身引用。
-     * @note 如果当前不是对象类型，会转换为对象类型。
+     * @brief getOr() 的返回类型：字符串字面量与 C 字符串按 std::string 处理，其余类型去掉引用与 cv。
      */
-    TomlValue& insert(const std::string& key, const TomlValue& value);
+    template <typename T>
+    using GetOrType = std::conditional_t<std::is_convertible_v<std::decay_t<T>, const char*>,
+                                         std::string,
+                                         std::decay_t<T>>;
 
     /**
-     * @brief 向数组添加元素。
-     * @param value 要添加的 TomlValue 值。
-     * @return 自身引用。
-     * @note 如果当前不是数组类型，会转换为数组类型。
+     * @brief 查找对象中的键（只读），不抛出异常。
+     * @param key 键名。
+     * @return 指向对应值的指针，不是对象或键不存在时返回 nullptr。
      */
-    TomlValue& push_back(const TomlValue& value);
+    const TomlValue* find(std::string_view key) const noexcept;
 
     /**
-     * @brief 获取字符串值（读写）。
-     * @return 字符串引用。
-     * @throws TomlException 如果不是字符串类型，抛出异常。
+     * @brief 判断对象中是否存在指定的键，不抛出异常。
+     * @param key 键名。
+     * @return 如果是对象且包含该键，返回 true，否则返回 false。
      */
-    TomlString& asString() {
-        if (m_type != TomlType::String) {
-            throw TomlException("not a string");
-        }
-        return *m_value.string;
+    bool contains(std::string_view key) const noexcept {
+        return find(key) != nullptr;
     }
 
     /**
-     * @brief 获取字符串值（只读）。
-     * @return 字符串常量引用。
-     * @throws TomlException 如果不是字符串类型，抛出异常。
+     * @brief 查找对象中的键（读写），不抛出异常。
+     * @param key 键名。
+     * @return 指向对应值的指针，不是对象或键不存在时返回 nullptr。
      */
-    const TomlString& asString() const {
-        if (m_type != TomlType::String) {
-            throw TomlException("not a string");
-        }
-        return *m_value.string;
-    }
+    TomlValue* find(std::string_view key) noexcept;
 
     /**
-     * @brief 获取日期值（读写）。
-     * @return 日期引用。
+     * @brief 按路径查找值（只读），不抛出异常。
+     *
+     * 路径由 . 分隔的键和 [下标] 组成，如 servers[0].host；包含 . 或 [ 的键请使用 find()。
+     *
+     * @param path 查找路径。
+     * @return 指向对应值的指针，路径不存在或格式错误时返回 nullptr。
+     */
+    const TomlValue* findPath(std::string_view path) const noexcept;
+
+    /**
+     * @brief 按路径查找值（读写），不抛出异常。
+     * @param path 查找路径，格式同 findPath() const。
+     * @return 指向对应值的指针，路径不存在或格式错误时返回 nullptr。
+     */
+    TomlValue* findPath(std::string_view path) noexcept;
+
+    /**
+     * @brief 尝试获取指定类型的值，不抛出异常。
+     * @tparam T 目标类型（同 get<T>()；std::string_view 指向内部字符串）
+     * @return 转换后的值，类型不匹配或转换失败时返回 std::nullopt。
+     */
+    template <typename T>
+    std::optional<T> tryGet() const noexcept {
+        if constexpr (std::is_arithmetic_v<T>) {
+            if (!(isNumber() || isBoolean())) {
+                return std::nullopt;
+            }
+            if (m_type == TomlType::Integer) {
+                return static_cast<T>(m_value.iNumber);
+            } else if (m_type == TomlType::Boolean) {
+                return static_cast<T>(m_value.boolean);
+            } else {
+                return static_cast<T>(m_value.dNumber);
+            }
+        } else if constexpr (std::is_same_v<T, std::string_view>) {
+            if (!isString()) {
+                return std::nullopt;
+            }
+            return std::string_view(*m_value.string);
+        } else if constexpr (std::is_same_v<T, TomlDate>) {
+            if (!isDate()) {
+                return std::nullopt;
+            }
+            return *m_value.date;
+        } else {
+            if constexpr (std::is_same_v<T, std::string>) {
+                if (!isString()) {
+                    return std::nullopt;
+                }
+            }
+            // 其余类型（字符串、自定义类型等）需要分配内存或调用 fromToml，转换失败视为无值
+            try {
+                return get<T>();
+            } catch (...) {
+                return std::nullopt;
+            }
+        }
+    }
+
+    /**
+     * @brief 按路径尝试获取指定类型的值，不抛出异常。
+     * @tparam T 目标类型。
+     * @param path 查找路径，格式同 findPath()
+     * @return 转换后的值，路径不存在或类型不匹配时返回 std::nullopt。
+     */
+    template <typename T>
+    std::optional<T> tryGet(std::string_view path) const noexcept {
+        const auto* value = findPath(path);
+        if (value == nullptr) {
+            return std::nullopt;
+        }
+        return value->tryGet<T>();
+    }
+
+    /**
+     * @brief 获取指定类型的值，失败时返回默认值，不抛出异常。
+     * @tparam T 目标类型（字符串字面量按 std::string 处理）
+     * @param defaultValue 默认值。
+     * @return 转换后的值或默认值。
+     */
+    template <typename T>
+    auto getOr(T&& defaultValue) const noexcept -> GetOrType<T> {
+        auto value = tryGet<GetOrType<T>>();
+        return value ? std::move(*value) : GetOrType<T>(std::forward<T>(defaultValue));
+    }
+
+    /**
+     * @brief 按路径获取指定类型的值，失败时返回默认值，不抛出异常。
+     * @tparam T 目标类型（字符串字面量按 std::string 处理）
+     * @param path 查找路径，格式同 findPath()
+     * @param defaultValue 默认值。
+     * @return 转换后的值或默认值。
+     */
+    template <typename T>
+    auto getOr(std::string_view path, T&& defaultValue) const noexcept -> GetOrType<T> {
+        const auto* value = findPath(path);
+        if (value == nullptr) {
+            return GetOrType<T>(std::forward<T>(defaultValue));
+        }
+        return value->getOr(std::forward<T>(defaultValue));
+    }
+
+    /**
+     * @brief 在按时间升序排列的日期数组中二分查找第一个不早于指定时间点的元素。
+     *
+     * 每次比较只做一次纯算术的 toUnixNanos() 转换，共 O(log n) 次；频繁查询时可改用 TomlDateArray。
+     *
+     * @param timePoint 系统时间点。
+     * @return 元素下标，全部早于该时间点时返回数组长度。
+     * @throws TomlException 如果不是数组类型或比较到的元素不是日期，抛出异常。
+     */
+    size_t lowerBound(std::chrono::system_clock::time_point timePoint) const;
+
+    /**
+     * @brief 设置对象键值对。
+     * @param key 键名。
+     * @param value 要设置的 TomlValue 值。
+     * @return 自身引用。
+     * @note 如果当前不是对象类型，会转换为对象类型。
+     */
+    TomlValue& insert(std::string_view key, const TomlValue& value);
+
+    /**
+     * @brief 向数组添加元素。
+     * @param value 要添加的 TomlValue 值。
+     * @return 自身引用。
+     * @note 如果当前不是数组类型，会转换为数组类型。
+     */
+    TomlValue& push_back(const TomlValue& value);
+
+    /**
+     * @brief 获取字符串值（读写）。
+     * @return 字符串引用。
+     * @throws TomlException 如果不是字符串类型，抛出异常。
+     */
+    TomlString& asString() {
+        if (m_type != TomlType::String) {
+            throw TomlException("not a string");
+        }
+        return *m_value.string;
+    }
+
+    /**
+     * @brief 获取字符串值（只读）。
+     * @return 字符串常量引用。
+     * @throws TomlException 如果不是字符串类型，抛出异常。
+     */
+    const TomlString& asString() const {
+        if (m_type != TomlType::String) {
+            throw TomlException("not a string");
+        }
+        return *m_value.string;
+    }
+
+    /**
+     * @brief 获取日期值（读写）。
+     * @return 日期引用。
      * @throws TomlException 如果不是日期类型，抛出异常。
      */
     TomlDate& asDate() {
@@ -1399,7 +2464,7 @@ class TomlValue {
             if (!m_value->isObject()) {
                 throw TomlException("Not an object iterator");
             }
-            return std::get<ObjectIterator>(m_it)->first;
+            return std::string(std::get<ObjectIterator>(m_it)->first);
         }
 
         /**
@@ -1552,6 +2617,75 @@ class TomlValue {
      */
     using ConstReverseIterator = BaseReverseIterator<ConstIterator>;
 
+    /**
+     * @brief 类型专用的遍历范围，直接包装底层容器的迭代器。
+     *
+     * 与 BaseIterator 不同，迭代过程中不再区分对象/数组，适合对大数组或大对象的紧凑循环。
+     * 数组范围的迭代器为随机访问迭代器。
+     *
+     * @tparam It 底层容器迭代器类型。
+     */
+    template <typename It>
+    class BaseRange {
+      public:
+        using iterator  = It;                                            ///< 迭代器类型。
+        using reference = typename std::iterator_traits<It>::reference;  ///< 元素引用类型。
+        using size_type = std::size_t;                                   ///< 大小类型。
+
+        /**
+         * @brief 构造函数。
+         * @param first 起始迭代器。
+         * @param last 结束迭代器。
+         */
+        BaseRange(It first, It last) : m_first(first), m_last(last) {}
+
+        /**
+         * @brief 获取起始迭代器。
+         */
+        It begin() const {
+            return m_first;
+        }
+
+        /**
+         * @brief 获取结束迭代器。
+         */
+        It end() const {
+            return m_last;
+        }
+
+        /**
+         * @brief 获取元素个数。
+         */
+        size_type size() const {
+            return static_cast<size_type>(std::distance(m_first, m_last));
+        }
+
+        /**
+         * @brief 判断范围是否为空。
+         */
+        bool empty() const {
+            return m_first == m_last;
+        }
+
+        /**
+         * @brief 按下标访问元素（仅适用于数组范围，不做越界检查）。
+         * @param index 下标。
+         * @return 元素引用。
+         */
+        reference operator[](size_type index) const {
+            return m_first[static_cast<typename std::iterator_traits<It>::difference_type>(index)];
+        }
+
+      private:
+        It m_first;  ///< 起始迭代器。
+        It m_last;   ///< 结束迭代器。
+    };
+
+    using ItemRange         = BaseRange<TomlObject::iterator>;        ///< 对象键值对范围。
+    using ConstItemRange    = BaseRange<TomlObject::const_iterator>;  ///< 对象键值对范围（只读）
+    using ElementRange      = BaseRange<TomlArray::iterator>;         ///< 数组元素范围。
+    using ConstElementRange = BaseRange<TomlArray::const_iterator>;   ///< 数组元素范围（只读）
+
   public:
     /**
      * @brief 获取 TOML 数据结构的正向迭代器（非 const），指向起始位置。
@@ -1617,14 +2751,165 @@ class TomlValue {
         return ConstReverseIterator(begin());
     }
 
+    /**
+     * @brief 获取对象的键值对范围（读写），元素为 std::pair<const TomlString, TomlValue>。
+     * @return 对象键值对范围。
+     * @throws TomlException 如果不是对象类型，抛出异常。
+     */
+    ItemRange items() {
+        auto& object = asObject();
+        return {object.begin(), object.end()};
+    }
+
+    /**
+     * @brief 获取对象的键值对范围（只读）。
+     * @return 对象键值对范围。
+     * @throws TomlException 如果不是对象类型，抛出异常。
+     */
+    ConstItemRange items() const {
+        const auto& object = asObject();
+        return {object.begin(), object.end()};
+    }
+
+    /**
+     * @brief 获取数组的元素范围（读写），迭代器支持随机访问。
+     * @return 数组元素范围。
+     * @throws TomlException 如果不是数组类型，抛出异常。
+     */
+    ElementRange elements() {
+        auto& array = asArray();
+        return {array.begin(), array.end()};
+    }
+
+    /**
+     * @brief 获取数组的元素范围（只读），迭代器支持随机访问。
+     * @return 数组元素范围。
+     * @throws TomlException 如果不是数组类型，抛出异常。
+     */
+    ConstElementRange elements() const {
+        const auto& array = asArray();
+        return {array.begin(), array.end()};
+    }
+
+    /**
+     * @brief 获取修改计数。
+     *
+     * 值被整体赋值或销毁时递增（读取与原地修改元素不会改变它），
+     * TomlArrayIndex 据此识别数组被替换为同一地址上的新数组。
+     *
+     * @return 修改计数。
+     */
+    uint32_t version() const noexcept {
+        return m_version;
+    }
+
   private:
     /**
      * @brief 释放内部资源。
      */
     void destroyValue() noexcept;
 
+#    if defined(CCTOML_USE_PMR)
+    /**
+     * @brief 日期存储：TomlDate 没有分配器，在其后记录所在的资源以便归还。
+     */
+    struct DateStorage {
+        TomlDate                   date;      ///< 日期（首成员，地址与存储相同）
+        std::pmr::memory_resource* resource;  ///< 所在的内存资源。
+    };
+
+    /**
+     * @brief 在指定资源中创建字符串/数组/对象/日期存储，容器本身及其元素都使用该资源。
+     * @tparam T TomlString、TomlArray、TomlObject 或 TomlDate。
+     * @param resource 内存资源。
+     * @param args 构造参数。
+     * @return 新建的存储。
+     */
+    template <typename T, typename... Args>
+    static T* createStorageIn(std::pmr::memory_resource* resource, Args&&... args) {
+        if constexpr (std::is_same_v<T, TomlDate>) {
+            void* memory = resource->allocate(sizeof(DateStorage), alignof(DateStorage));
+            return &(::new (memory) DateStorage{TomlDate(std::forward<Args>(args)...), resource})
+                        ->date;
+        } else {
+            void* memory = resource->allocate(sizeof(T), alignof(T));
+            try {
+                return ::new (memory)
+                    T(std::forward<Args>(args)..., typename T::allocator_type(resource));
+            } catch (...) {
+                resource->deallocate(memory, sizeof(T), alignof(T));
+                throw;
+            }
+        }
+    }
+
+    /**
+     * @brief 在当前线程的资源中创建存储。
+     */
+    template <typename T, typename... Args>
+    static T* createStorage(Args&&... args) {
+        return createStorageIn<T>(currentResource(), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief 获取 createStorage() 创建的存储所在的资源。
+     */
+    template <typename T>
+    static std::pmr::memory_resource* storageResource(const T* storage) noexcept {
+        if constexpr (std::is_same_v<T, TomlDate>) {
+            return reinterpret_cast<const DateStorage*>(storage)->resource;
+        } else {
+            return storage->get_allocator().resource();
+        }
+    }
+
+    /**
+     * @brief 析构存储并归还给它所在的资源。
+     * @param storage createStorage() 创建的存储，可为 nullptr。
+     */
+    template <typename T>
+    static void destroyStorage(T* storage) noexcept {
+        if (storage != nullptr) {
+            std::pmr::memory_resource* resource = storageResource(storage);
+            if constexpr (std::is_same_v<T, TomlDate>) {
+                reinterpret_cast<DateStorage*>(storage)->~DateStorage();
+                resource->deallocate(storage, sizeof(DateStorage), alignof(DateStorage));
+            } else {
+                storage->~T();
+                resource->deallocate(storage, sizeof(T), alignof(T));
+            }
+        }
+    }
+
+    /**
+     * @brief 在指定资源中构造值，供 allocator_arg 构造函数转发使用。
+     */
+    template <typename... Args>
+    static TomlValue constructIn(std::pmr::memory_resource* resource, Args&&... args) {
+        TomlResourceScope scope(resource);
+        return TomlValue(std::forward<Args>(args)...);
+    }
+#    else
+    /**
+     * @brief 创建字符串/数组/对象存储。
+     */
+    template <typename T, typename... Args>
+    static T* createStorage(Args&&... args) {
+        return new T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief 释放 createStorage() 创建的存储。
+     */
+    template <typename T>
+    static void destroyStorage(T* storage) noexcept {
+        delete storage;
+    }
+#    endif
+
   private:
-    TomlType m_type{};  ///< 当前值的数据类型。
+    TomlType m_type{};     ///< 当前值的数据类型。
+    uint32_t m_version{0};  ///< 整体赋值计数（与 m_type 共用对齐填充，不增加对象大小）
     union
     {
         bool        boolean;  ///< 布尔值。
@@ -1639,81 +2924,3453 @@ class TomlValue {
 
 // 容器序列化支持
 
+/**
+ * @brief 按容器的值类别访问其中的元素：容器为右值时移动元素，否则以 const 引用访问。
+ * @tparam V 容器所在 TomlValue 的转发引用类型。
+ * @param element 容器中的元素。
+ * @return 元素的右值引用或 const 引用。
+ */
+template <typename V, typename U>
+constexpr decltype(auto) forwardTomlElement(U& element) noexcept {
+    if constexpr (std::is_lvalue_reference_v<V>) {
+        return static_cast<const U&>(element);
+    } else {
+        return static_cast<U&&>(element);
+    }
+}
+
+/**
+ * @brief 将 Toml 值转换为容器元素类型；传入右值时直接取走字符串与子树。
+ * @tparam T 元素类型。
+ * @param item Toml 值。
+ * @return 转换后的元素。
+ */
+template <typename T, typename V>
+T fromTomlElement(V&& item) {
+    if constexpr (std::is_same_v<T, TomlValue>) {
+        return std::forward<V>(item);
+    } else if constexpr (std::is_same_v<T, std::string> && !std::is_lvalue_reference_v<V>) {
+        if (item.isString()) {
+            return T(std::move(item.asString()));
+        }
+        return item.template get<T>();
+    } else if constexpr (HasFromToml<T>::value) {
+        T value;
+        fromToml(std::forward<V>(item), value);
+        return value;
+    } else {
+        return item.template get<T>();
+    }
+}
+
+/**
+ * @brief 将元素转换为 Toml 值。
+ * @tparam T 元素类型。
+ * @param item 元素。
+ * @return 表示该元素的 TomlValue 对象。
+ */
 template <typename T>
-void fromToml(const TomlValue& root, std::vector<T>& vec) {
+TomlValue toTomlElement(const T& item) {
+    if constexpr (HasToToml<T>::value) {
+        return toToml(item);
+    } else {
+        return TomlValue(item);
+    }
+}
+
+/**
+ * @brief 将一段元素序列化为 Toml 数组。
+ * @param first 起始迭代器。
+ * @param last 结束迭代器。
+ * @param size 元素个数（用于预留空间）
+ * @return 表示 Toml 数组的 TomlValue 对象。
+ */
+template <typename It>
+TomlValue toTomlArray(It first, It last, size_t size) {
+    TomlArray result;
+    result.reserve(size);
+    for (; first != last; ++first) {
+        result.emplace_back(toTomlElement(*first));
+    }
+    return result;
+}
+
+template <typename T, typename V, EnableIfTomlValue<V>>
+void fromToml(V&& root, std::vector<T>& vec) {
     if (!root.isArray()) {
         throw TomlException("Not an Array");
     }
-    using ValueType = typename std::vector<T>::value_type;
+    auto& array = root.asArray();
     vec.clear();
-    vec.reserve(root.asArray().size());
-    for (const auto& item : root.asArray()) {
-        if constexpr (HasFromToml<ValueType>::value) {
-            ValueType value;
-            fromToml(item, value);
-            vec.emplace_back(std::move(value));
-        } else {
-            vec.emplace_back(item.template get<ValueType>());
-        }
+    vec.reserve(array.size());
+    for (auto& item : array) {
+        vec.emplace_back(fromTomlElement<T>(forwardTomlElement<V>(item)));
     }
 }
 
-template <typename Map, typename T, typename>
-void fromToml(const TomlValue& root, Map& map) {
-    if (!root.isObject()) {
-        throw TomlException("Not a Object");
+template <typename T, typename V, EnableIfTomlValue<V>>
+void fromToml(V&& root, std::deque<T>& deque) {
+    if (!root.isArray()) {
+        throw TomlException("Not an Array");
     }
-    using ValueType = typename Map::mapped_type;
-    map.clear();
-    for (const auto& [key, item] : root.asObject()) {
-        if constexpr (HasToToml<ValueType>::value) {
-            ValueType value;
-            fromToml(item, value);
-            map[key] = value;
-        } else {
-            // 没有定义fromToml函数
-            map[key] = item.template get<ValueType>();
-        }
+    deque.clear();
+    for (auto& item : root.asArray()) {
+        deque.emplace_back(fromTomlElement<T>(forwardTomlElement<V>(item)));
     }
 }
 
-template <typename T>
-TomlValue toToml(const std::vector<T>& vec) {
-    std::vector<TomlValue> result;
-    result.reserve(vec.size());
-    for (const auto& item : vec) {
-        if constexpr (HasToToml<T>::value) {
-            result.emplace_back(toToml(item));
-        } else {
-            result.emplace_back(item);
-        }
+template <typename T, size_t N, typename V, EnableIfTomlValue<V>>
+void fromToml(V&& root, std::array<T, N>& array) {
+    if (!root.isArray()) {
+        throw TomlException("Not an Array");
+    }
+    auto& items = root.asArray();
+    if (items.size() != N) {
+        throw TomlException("Array size mismatch");
+    }
+    for (size_t i = 0; i < N; ++i) {
+        array[i] = fromTomlElement<T>(forwardTomlElement<V>(items[i]));
     }
-    return result;
 }
 
-template <typename Map, typename T, typename>
-TomlValue toToml(const Map& map) {
-    TomlObject result;
-    for (const auto& [key, value] : map) {
-        if constexpr (HasToToml<T>::value) {
-            result[key] = toToml(value);
-        } else {
-            result[key] = TomlValue(value);
-        }
+template <typename T, typename V, EnableIfTomlValue<V>>
+void fromToml(V&& root, std::set<T>& set) {
+    if (!root.isArray()) {
+        throw TomlException("Not an Array");
     }
-    return result;
+    set.clear();
+    for (auto& item : root.asArray()) {
+        set.emplace_hint(set.end(), fromTomlElement<T>(forwardTomlElement<V>(item)));
+    }
+}
+
+template <typename A, typename B, typename V, EnableIfTomlValue<V>>
+void fromToml(V&& root, std::pair<A, B>& pair) {
+    if (!root.isArray()) {
+        throw TomlException("Not an Array");
+    }
+    auto& items = root.asArray();
+    if (items.size() != 2) {
+        throw TomlException("Array size mismatch");
+    }
+    pair.first  = fromTomlElement<A>(forwardTomlElement<V>(items[0]));
+    pair.second = fromTomlElement<B>(forwardTomlElement<V>(items[1]));
 }
 
 /**
- * @brief 将字符串字面量转为TomlValue
- * @param data 字符串指针
- * @param length 字符串长度
- * @return 解析后的TomlValue
+ * @brief 按位置将 Toml 数组中的元素赋给元组。
+ * @tparam V 数组所在 TomlValue 的转发引用类型。
+ * @param items Toml 数组（长度已校验）
+ * @param tuple 目标元组。
+ */
+template <typename V, typename Array, typename... Ts, size_t... I>
+void fromTomlTuple(Array& items, std::tuple<Ts...>& tuple, std::index_sequence<I...>) {
+    ((std::get<I>(tuple) = fromTomlElement<Ts>(forwardTomlElement<V>(items[I]))), ...);
+}
+
+template <typename... Ts, typename V, EnableIfTomlValue<V>>
+void fromToml(V&& root, std::tuple<Ts...>& tuple) {
+    if (!root.isArray()) {
+        throw TomlException("Not an Array");
+    }
+    auto& items = root.asArray();
+    if (items.size() != sizeof...(Ts)) {
+        throw TomlException("Array size mismatch");
+    }
+    fromTomlTuple<V>(items, tuple, std::index_sequence_for<Ts...>{});
+}
+
+template <typename T, typename V, EnableIfTomlValue<V>>
+void fromToml(V&& root, std::optional<T>& optional) {
+    optional = fromTomlElement<T>(std::forward<V>(root));
+}
+
+template <typename Map, typename T, typename, typename V, EnableIfTomlValue<V>>
+void fromToml(V&& root, Map& map) {
+    if (!root.isObject()) {
+        throw TomlException("Not a Object");
+    }
+    auto& object = root.asObject();
+    map.clear();
+    if constexpr (std::is_same_v<Map, std::unordered_map<std::string, T>>) {
+        map.reserve(object.size());
+    }
+    if constexpr (std::is_lvalue_reference_v<V>) {
+        for (const auto& [key, item] : object) {
+            // 源对象已按键排序, 对 std::map 以 end() 作为插入提示
+            map.emplace_hint(map.end(), key, fromTomlElement<T>(item));
+        }
+    } else {
+        // 右值: 逐个摘下节点, 键和值都直接移动
+        while (!object.empty()) {
+            auto node = object.extract(object.begin());
+            map.emplace_hint(map.end(), std::move(node.key()),
+                             fromTomlElement<T>(std::move(node.mapped())));
+        }
+    }
+}
+
+template <typename Rep, typename Period>
+void fromToml(const TomlValue& root, std::chrono::duration<Rep, Period>& duration) {
+    duration = std::chrono::duration<Rep, Period>(root.get<Rep>());
+}
+
+template <typename Duration>
+void fromToml(const TomlValue& root,
+              std::chrono::time_point<std::chrono::system_clock, Duration>& timePoint) {
+    if (!root.isDate()) {
+        throw TomlException("Not a Date");
+    }
+    timePoint = std::chrono::time_point<std::chrono::system_clock, Duration>(
+        std::chrono::duration_cast<Duration>(
+            std::chrono::nanoseconds(root.asDate().toUnixNanos())));
+}
+
+template <typename T>
+TomlValue toToml(const std::vector<T>& vec) {
+    return toTomlArray(vec.begin(), vec.end(), vec.size());
+}
+
+template <typename T>
+TomlValue toToml(const std::deque<T>& deque) {
+    return toTomlArray(deque.begin(), deque.end(), deque.size());
+}
+
+template <typename T, size_t N>
+TomlValue toToml(const std::array<T, N>& array) {
+    return toTomlArray(array.begin(), array.end(), N);
+}
+
+template <typename T>
+TomlValue toToml(const std::set<T>& set) {
+    return toTomlArray(set.begin(), set.end(), set.size());
+}
+
+template <typename A, typename B>
+TomlValue toToml(const std::pair<A, B>& pair) {
+    TomlArray result;
+    result.reserve(2);
+    result.emplace_back(toTomlElement(pair.first));
+    result.emplace_back(toTomlElement(pair.second));
+    return result;
+}
+
+template <typename... Ts>
+TomlValue toToml(const std::tuple<Ts...>& tuple) {
+    TomlArray result;
+    result.reserve(sizeof...(Ts));
+    std::apply([&result](const auto&... items) { (result.emplace_back(toTomlElement(items)), ...); },
+               tuple);
+    return result;
+}
+
+template <typename T>
+TomlValue toToml(const std::optional<T>& optional) {
+    if (!optional) {
+        throw TomlException("Cannot convert an empty optional to toml");
+    }
+    return toTomlElement(*optional);
+}
+
+template <typename Map, typename T, typename>
+TomlValue toToml(const Map& map) {
+    TomlObject result;
+    for (const auto& [key, value] : map) {
+        result.emplace_hint(result.end(), key, toTomlElement(value));
+    }
+    return result;
+}
+
+template <typename Rep, typename Period>
+TomlValue toToml(const std::chrono::duration<Rep, Period>& duration) {
+    return TomlValue(duration.count());
+}
+
+template <typename Duration>
+TomlValue toToml(const std::chrono::time_point<std::chrono::system_clock, Duration>& timePoint) {
+    return TomlDate::fromUnixNanos(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(timePoint.time_since_epoch())
+            .count());
+}
+
+/**
+ * @enum TomlArrayMerge
+ * @brief 合并时数组的处理方式。
+ */
+enum class TomlArrayMerge {
+    Replace,    ///< 覆盖层的数组替换基础层的数组
+    Append,     ///< 覆盖层的元素追加到基础层数组末尾
+    MergeByKey  ///< 按指定字段匹配表元素并递归合并，未匹配的元素追加到末尾
+};
+
+/**
+ * @class TomlMergePolicy
+ * @brief 分层合并的策略：默认的数组处理方式以及按键路径指定的数组处理方式。
+ *
+ * 键路径为以 . 分隔的表键（表数组内部的路径不含下标），如 "backends" 或 "backends.routes"。
+ */
+class TomlMergePolicy {
+  public:
+    /**
+     * @struct Rule
+     * @brief 数组合并规则。
+     */
+    struct Rule {
+        TomlArrayMerge mode = TomlArrayMerge::Replace;  ///< 处理方式。
+        std::string    key;                             ///< MergeByKey 时用于匹配元素的字段名。
+    };
+
+    /**
+     * @brief 设置未单独指定路径的数组的处理方式。
+     * @param mode 处理方式。
+     * @param key MergeByKey 时用于匹配元素的字段名。
+     * @return 自身引用。
+     */
+    TomlMergePolicy& arrays(TomlArrayMerge mode, std::string key = {}) {
+        m_default = {mode, std::move(key)};
+        return *this;
+    }
+
+    /**
+     * @brief 设置指定键路径上数组的处理方式。
+     * @param path 以 . 分隔的键路径。
+     * @param mode 处理方式。
+     * @param key MergeByKey 时用于匹配元素的字段名。
+     * @return 自身引用。
+     */
+    TomlMergePolicy& array(std::string path, TomlArrayMerge mode, std::string key = {}) {
+        m_rules.insert_or_assign(std::move(path), Rule{mode, std::move(key)});
+        return *this;
+    }
+
+    /**
+     * @brief 获取键路径上数组的处理规则。
+     * @param path 以 . 分隔的键路径。
+     * @return 对应的规则，未指定时返回默认规则。
+     */
+    const Rule& ruleFor(std::string_view path) const noexcept {
+        auto it = m_rules.find(path);
+        return it != m_rules.end() ? it->second : m_default;
+    }
+
+  private:
+    Rule                                     m_default;  ///< 默认规则。
+    std::map<std::string, Rule, std::less<>> m_rules;    ///< 按键路径指定的规则。
+};
+
+/**
+ * @brief 将覆盖层深度合并到基础层，覆盖层中的节点被移动而不是复制。
+ *
+ * 两侧同为表时逐键递归合并；同为数组时按 policy 处理；其余情况覆盖层的值替换基础层的值。
+ * 只遍历覆盖层，耗时与覆盖层大小成正比（MergeByKey 需为涉及的基础层数组建立一次索引）。
+ *
+ * @param base 基础层，合并结果写回其中。
+ * @param overlay 覆盖层，合并后处于被移动状态。
+ * @param policy 合并策略。
+ */
+void merge(TomlValue& base, TomlValue&& overlay, const TomlMergePolicy& policy = {});
+
+/**
+ * @brief 将覆盖层深度合并到基础层（复制覆盖层）
+ * @param base 基础层，合并结果写回其中。
+ * @param overlay 覆盖层。
+ * @param policy 合并策略。
+ */
+void merge(TomlValue& base, const TomlValue& overlay, const TomlMergePolicy& policy = {});
+
+/**
+ * @class TomlOverlayView
+ * @brief 多个文档叠加后的只读视图，查找时逐层解析而不生成合并结果。
+ *
+ * 后加入的层优先级更高。表会跨层叠加，非表的值会遮蔽更低层中同一位置的值。
+ * 视图只保存各层节点的指针，调用者需保证这些文档在视图使用期间有效且不被修改。
+ */
+class TomlOverlayView {
+  public:
+    TomlOverlayView() = default;
+
+    /**
+     * @brief 构造函数，从低到高依次给出各层。
+     * @param layers 各层文档。
+     */
+    TomlOverlayView(std::initializer_list<const TomlValue*> layers) : m_layers(layers) {}
+
+    /**
+     * @brief 在顶部加入一层（优先级最高）
+     * @param layer 文档。
+     * @return 自身引用。
+     */
+    TomlOverlayView& push(const TomlValue& layer) {
+        m_layers.push_back(&layer);
+        return *this;
+    }
+
+    /**
+     * @brief 获取子键的叠加视图。
+     * @param key 键名。
+     * @return 子视图；键在各层都不存在时返回空视图。
+     */
+    TomlOverlayView operator[](std::string_view key) const;
+
+    /**
+     * @brief 查找子键在最高优先级层中的值。
+     * @param key 键名。
+     * @return 值的指针，不存在时返回 nullptr。
+     */
+    const TomlValue* find(std::string_view key) const noexcept;
+
+    /**
+     * @brief 按路径查找值，语法同 TomlValue::findPath。
+     *
+     * 表键跨层解析；遇到数组下标时，在持有该数组的最高优先级层中继续查找。
+     *
+     * @param path 路径。
+     * @return 值的指针，不存在时返回 nullptr。
+     */
+    const TomlValue* findPath(std::string_view path) const noexcept;
+
+    /**
+     * @brief 判断子键是否在任意一层中存在。
+     * @param key 键名。
+     */
+    bool contains(std::string_view key) const noexcept {
+        return find(key) != nullptr;
+    }
+
+    /**
+     * @brief 获取当前位置在最高优先级层中的值。
+     * @return 值的指针，视图为空时返回 nullptr。
+     */
+    const TomlValue* value() const noexcept {
+        return m_layers.empty() ? nullptr : m_layers.back();
+    }
+
+    /**
+     * @brief 判断视图是否为空（当前位置在各层都不存在）
+     */
+    bool empty() const noexcept {
+        return m_layers.empty();
+    }
+
+    /**
+     * @brief 判断当前位置是否为表。
+     */
+    bool isObject() const noexcept {
+        return !m_layers.empty() && m_layers.back()->isObject();
+    }
+
+    /**
+     * @brief 获取当前位置各层键的并集（按键名排序）
+     * @return 键名列表，指向各层文档中的字符串。
+     */
+    std::vector<std::string_view> keys() const;
+
+    /**
+     * @brief 生成当前位置的合并结果（数组按 policy 处理）
+     * @param policy 合并策略。
+     * @return 合并后的值。
+     */
+    TomlValue materialize(const TomlMergePolicy& policy = {}) const;
+
+  private:
+    std::vector<const TomlValue*> m_layers;  ///< 当前位置在各层中的节点（从低到高）
+};
+
+/**
+ * @class TomlIndexKey
+ * @brief 索引查找用的轻量键，只引用数据而不复制，构造不分配内存。
+ *
+ * 可由 bool、整数、浮点数、字符串和 TomlDate 隐式构造；不同类型的键互不相等，
+ * 排序时先按 TomlType 再按值比较。NaN 排在所有浮点数之后，且所有 NaN 彼此相等。
+ */
+class TomlIndexKey {
+  public:
+    TomlIndexKey(bool value) noexcept : m_type(TomlType::Boolean) {
+        m_value.boolean = value;
+    }
+
+    template <typename T,
+              std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    TomlIndexKey(T value) noexcept : m_type(TomlType::Integer) {
+        m_value.iNumber = static_cast<int64_t>(value);
+    }
+
+    TomlIndexKey(double value) noexcept : m_type(TomlType::Double) {
+        m_value.dNumber = value;
+    }
+
+    TomlIndexKey(std::string_view value) noexcept : m_type(TomlType::String), m_string(value) {}
+
+    TomlIndexKey(const char* value) noexcept : TomlIndexKey(std::string_view(value)) {}
+
+    TomlIndexKey(const std::string& value) noexcept : TomlIndexKey(std::string_view(value)) {}
+
+    TomlIndexKey(const TomlDate& value) noexcept : m_type(TomlType::Date) {
+        m_value.date = &value;
+    }
+
+    /**
+     * @brief 从标量 TomlValue 构造（引用其内部数据）；数组和表得到的键不与任何值相等。
+     * @param value 值。
+     */
+    explicit TomlIndexKey(const TomlValue& value) noexcept;
+
+    /**
+     * @brief 计算哈希值，相等的键哈希值相同。
+     */
+    size_t hash() const noexcept;
+
+    /**
+     * @brief 与另一个键比较。
+     * @param other 另一个键。
+     * @return 小于、等于、大于 other 时分别返回负数、0、正数。
+     */
+    int compare(const TomlIndexKey& other) const noexcept;
+
+    /**
+     * @brief 与值比较。
+     * @param value 值，可为 nullptr（小于任何键）
+     * @return 键小于、等于、大于值时分别返回负数、0、正数。
+     */
+    int compare(const TomlValue* value) const noexcept;
+
+    /**
+     * @brief 判断是否与值相等。
+     * @param value 值，可为 nullptr。
+     */
+    bool matches(const TomlValue* value) const noexcept {
+        return value != nullptr && compare(value) == 0;
+    }
+
+  private:
+    TomlType m_type;  ///< 键的类型。
+    union
+    {
+        bool            boolean;  ///< 布尔值。
+        int64_t         iNumber;  ///< 整数值。
+        double          dNumber;  ///< 浮点值。
+        const TomlDate* date;     ///< 日期指针。
+    } m_value{};                  ///< 标量值。
+    std::string_view m_string;    ///< 字符串值。
+};
+
+/**
+ * @class TomlArrayIndex
+ * @brief 表数组上的二级索引，按一个或多个字段（可为 a.b 形式的嵌套路径）查找元素。
+ *
+ * Hash 索引使用开放寻址哈希表，查找为 O(1)；Sorted 索引按字段值排序，额外支持范围查询。
+ * 缺少任一字段或不是表的元素不会被索引。索引保存各元素字段值的副本，并记录数组的存储地址、
+ * 长度与 TomlValue::version()：数组被整体替换、增删元素或重新分配后 valid() 返回 false，
+ * 此时查找抛出异常，需调用 rebuild()（TomlIndexCache 会自动重建）。只读访问不会使索引失效。
+ *
+ * 通过元素引用修改或替换元素（如 array[1]["name"] = "z"）同样使索引失效，但无法被 valid() 检测到：
+ * 在调用 rebuild() 之前，查找仍按建立索引时的字段值进行。
+ * 数组所在的 TomlValue 需在索引使用期间保持有效。
+ */
+class TomlArrayIndex {
+  public:
+    /**
+     * @enum Kind
+     * @brief 索引类型。
+     */
+    enum class Kind {
+        Hash,   ///< 哈希索引
+        Sorted  ///< 有序索引
+    };
+
+    /**
+     * @brief 构造函数，建立索引。
+     * @param array 表数组。
+     * @param fields 索引字段（按顺序组成复合键）
+     * @param kind 索引类型。
+     * @throws TomlException 如果不是数组或字段列表为空，抛出异常。
+     */
+    TomlArrayIndex(const TomlValue& array, std::vector<std::string> fields, Kind kind = Kind::Hash);
+
+    // 字段值副本中的字符串与日期由键引用, 复制会使其悬空
+    TomlArrayIndex(const TomlArrayIndex&)            = delete;
+    TomlArrayIndex& operator=(const TomlArrayIndex&) = delete;
+    TomlArrayIndex(TomlArrayIndex&&)                 = default;
+    TomlArrayIndex& operator=(TomlArrayIndex&&)      = default;
+
+    /**
+     * @brief 判断数组是否仍是建立索引时的数组（未被替换、增删元素或重新分配）
+     */
+    bool valid() const noexcept;
+
+    /**
+     * @brief 按数组当前内容重建索引。
+     * @throws TomlException 如果已不是数组，抛出异常。
+     */
+    void rebuild();
+
+    /**
+     * @brief 查找第一个（数组顺序）字段值与键相等的元素。
+     * @param keys 键，个数与索引字段数相同。
+     * @return 元素指针，不存在时返回 nullptr。
+     * @throws TomlException 如果索引已失效或键个数不符，抛出异常。
+     */
+    const TomlValue* find(std::initializer_list<TomlIndexKey> keys) const {
+        return find(keys.begin(), keys.size());
+    }
+
+    /**
+     * @brief 查找第一个字段值与键相等的元素。
+     * @param keys 键数组。
+     * @param count 键个数。
+     * @return 元素指针，不存在时返回 nullptr。
+     */
+    const TomlValue* find(const TomlIndexKey* keys, size_t count) const;
+
+    /**
+     * @brief 查找所有字段值与键相等的元素（按数组顺序）
+     * @param keys 键，个数与索引字段数相同。
+     * @return 元素指针列表。
+     */
+    std::vector<const TomlValue*> findAll(std::initializer_list<TomlIndexKey> keys) const;
+
+    /**
+     * @brief 依次访问所有字段值与键相等的元素（顺序与 findAll 相同），不分配内存。
+     * @tparam F 形如 bool(const TomlValue&) 的访问函数，返回 false 时停止。
+     * @param keys 键数组。
+     * @param count 键个数。
+     * @param visitor 访问函数。
+     * @return false 表示访问函数要求停止。
+     * @throws TomlException 如果索引已失效或键个数不符，抛出异常。
+     */
+    template <typename F>
+    bool forEachMatch(const TomlIndexKey* keys, size_t count, F&& visitor) const {
+        check(count);
+        const auto& array = *m_array;
+        if (m_kind == Kind::Sorted) {
+            const auto [first, last] = equalRange(keys, count);
+            for (auto it = first; it != last; ++it) {
+                if (!visitor(array[*it])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        const size_t hash = hashKeys(keys, count);
+        const size_t mask = m_slots.size() - 1;
+        size_t       slot = hash & mask;
+        while (m_slots[slot].element != EMPTY_SLOT) {
+            const Slot& entry = m_slots[slot];
+            if (entry.hash == hash && matches(entry.element, keys) &&
+                !visitor(array[entry.element])) {
+                return false;
+            }
+            slot = (slot + 1) & mask;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 范围查询（仅 Sorted 索引）：第一个字段值在 [low, high) 内的元素，按字段值排序。
+     * @param low 下界（包含）
+     * @param high 上界（不包含）
+     * @return 元素指针列表。
+     * @throws TomlException 如果不是有序索引或索引已失效，抛出异常。
+     */
+    std::vector<const TomlValue*> range(const TomlIndexKey& low, const TomlIndexKey& high) const;
+
+    /**
+     * @brief 获取被索引的元素个数。
+     */
+    size_t size() const noexcept {
+        return m_order.size();
+    }
+
+    /**
+     * @brief 获取索引字段。
+     */
+    const std::vector<std::string>& fields() const noexcept {
+        return m_fields;
+    }
+
+    /**
+     * @brief 获取索引类型。
+     */
+    Kind kind() const noexcept {
+        return m_kind;
+    }
+
+  private:
+    /**
+     * @brief 检查索引有效且键个数正确。
+     */
+    void check(size_t count) const;
+
+    /**
+     * @brief 获取元素的第 field 个索引字段（建立索引时的副本）
+     */
+    const TomlIndexKey& keyOf(uint32_t element, size_t field) const noexcept {
+        return m_keys[element * m_fields.size() + field];
+    }
+
+    /**
+     * @brief 判断元素的各索引字段是否与键相等。
+     */
+    bool matches(uint32_t element, const TomlIndexKey* keys) const noexcept;
+
+    /**
+     * @brief 按有序索引的顺序比较键与元素。
+     */
+    int compare(const TomlIndexKey* keys, size_t count, uint32_t element) const noexcept;
+
+    /**
+     * @brief 在有序索引中查找与键相等的元素区间。
+     * @return m_order 中的 [first, last)。
+     */
+    std::pair<const uint32_t*, const uint32_t*>
+    equalRange(const TomlIndexKey* keys, size_t count) const noexcept;
+
+    /**
+     * @brief 计算复合键的哈希值。
+     */
+    static size_t hashKeys(const TomlIndexKey* keys, size_t count) noexcept;
+
+  private:
+    static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;  ///< 哈希表空槽。
+
+    /**
+     * @brief 哈希表槽位。
+     */
+    struct Slot {
+        size_t   hash;     ///< 复合键哈希值。
+        uint32_t element;  ///< 元素下标。
+    };
+
+    const TomlValue*          m_source;      ///< 数组所在的值。
+    const TomlArray*          m_array{};     ///< 建立索引时的数组。
+    const TomlValue*          m_elements{};  ///< 建立索引时数组的元素存储。
+    uint32_t                  m_version{};   ///< 建立索引时的修改计数。
+    std::vector<std::string>  m_fields;      ///< 索引字段。
+    Kind                      m_kind;        ///< 索引类型。
+    std::vector<TomlIndexKey> m_keys;        ///< 各元素字段值的副本（元素 x 字段）
+    std::vector<char>         m_strings;     ///< m_keys 中字符串的存储（移动时地址不变）
+    std::vector<TomlDate>     m_dates;       ///< m_keys 中日期的存储。
+    std::vector<uint32_t>     m_order;       ///< 被索引元素的下标（Sorted 时按字段值排序）
+    std::vector<Slot>         m_slots;       ///< 开放寻址哈希表（仅 Hash）
+};
+
+/**
+ * @class TomlIndexCache
+ * @brief 表数组索引的缓存，按（数组、字段、类型）复用索引，数组被修改后自动重建。
+ *
+ * get() 是线程安全的；缓存不能比其中引用的文档活得更久，文档销毁前请调用 clear()。
+ */
+class TomlIndexCache {
+  public:
+    /**
+     * @brief 获取（必要时建立或重建）索引。
+     * @param array 表数组。
+     * @param fields 索引字段。
+     * @param kind 索引类型。
+     * @return 索引引用，在下一次对同一索引调用 get() 或 clear() 之前有效。
+     */
+    const TomlArrayIndex& get(const TomlValue&                array,
+                              const std::vector<std::string>& fields,
+                              TomlArrayIndex::Kind            kind = TomlArrayIndex::Kind::Hash);
+
+    /**
+     * @brief 清空缓存。
+     */
+    void clear();
+
+  private:
+    using Key = std::tuple<const TomlValue*, std::vector<std::string>, TomlArrayIndex::Kind>;
+
+    std::mutex m_mutex;  ///< 保护 m_indexes。
+    /// 已建立的索引（透明比较，查找时不复制字段列表）
+    std::map<Key, std::unique_ptr<TomlArrayIndex>, std::less<>> m_indexes;
+};
+
+/**
+ * @class TomlQuery
+ * @brief 编译后的查询（JSONPath 子集），结果为指向原树节点的指针，保留 TOML 日期等类型。
+ *
+ * 支持的语法：
+ * - `$` 根（可省略），`.key` / `['key']` 子键，`.*` / `[*]` 所有子节点
+ * - `..key` / `..*` / `..[...]` 递归下降
+ * - `[0]`、`[-1]` 下标，`[0,2]` 多个下标，`[1:3]` 切片，`['a','b']` 多个键（投影）
+ * - `[?(表达式)]` 过滤：`@.a.b`、`@['k']`、`@[0]` 引用当前元素，字面量可为数字、'字符串'、
+ *   "字符串"、true/false 或 TOML 日期；运算符 == != < <= > >= && || ! 和括号，单独的 `@.a` 表示存在
+ *
+ * 查询在构造时编译一次，可重复、并发地用于不同文档。求值按深度优先直接遍历原树，除结果外不分配内存。
+ * 传入 TomlIndexCache 时，形如 `[?(@.field == '字符串')]` 的过滤会使用该字段的哈希索引。
+ *
+ * @code
+ * TomlQuery heavy("$.backends[?(@.weight > 10 && @.region == 'eu')].name");
+ * for (const TomlValue* name : heavy.select(doc)) { ... }
+ * @endcode
+ */
+class TomlQuery {
+  public:
+    /**
+     * @brief 编译查询表达式。
+     * @param expression 查询表达式。
+     * @throws TomlParseException 如果表达式有误，抛出包含位置的异常。
+     */
+    explicit TomlQuery(std::string_view expression);
+
+    /**
+     * @brief 查询所有匹配的节点。
+     * @param root 文档根节点。
+     * @param cache 可选的索引缓存。
+     * @return 按文档顺序排列的匹配节点。
+     */
+    std::vector<const TomlValue*> select(const TomlValue& root,
+                                         TomlIndexCache*  cache = nullptr) const;
+
+    /**
+     * @brief 查询第一个匹配的节点。
+     * @param root 文档根节点。
+     * @param cache 可选的索引缓存。
+     * @return 第一个匹配的节点，不存在时返回 nullptr。
+     */
+    const TomlValue* first(const TomlValue& root, TomlIndexCache* cache = nullptr) const;
+
+    /**
+     * @brief 依次访问匹配的节点，不分配内存。
+     * @param root 文档根节点。
+     * @param visitor 访问函数，返回 false 时停止。
+     * @param cache 可选的索引缓存。
+     */
+    void forEach(const TomlValue&                              root,
+                 const std::function<bool(const TomlValue&)>& visitor,
+                 TomlIndexCache*                               cache = nullptr) const;
+
+  private:
+    struct Plan;
+
+    std::shared_ptr<const Plan> m_plan;  ///< 编译后的执行计划（不可变，可在副本间共享）
+};
+
+/**
+ * @class TomlCache
+ * @brief 已解析文档的缓存，同一文件在进程内只解析一次并以只读的共享文档返回。
+ *
+ * 以路径为键，按（设备号、inode、修改时间、大小）判断文件是否变化，未变化时不读取文件；
+ * 可选地在变化时比较内容哈希，内容未变时（如仅被 touch）直接复用已解析的文档。超过内存预算时按 LRU 淘汰，
+ * 已返回的文档由 shared_ptr 保持有效。并发请求同一文件时只有一个线程读取并解析，其余线程等待其结果。
+ *
+ * @code
+ * auto config = TomlCache::instance().load("/etc/service/config.toml");
+ * int64_t port = (*config)["port"];
+ * @endcode
+ */
+class TomlCache {
+  public:
+    using Document = std::shared_ptr<const TomlValue>;  ///< 共享的只读文档。
+
+    /**
+     * @struct Options
+     * @brief 缓存选项。
+     */
+    struct Options {
+        size_t               memoryBudget  = size_t(64) << 20;  ///< 内存预算（字节，按文档树估算）
+        bool                 verifyContent = false;  ///< 元数据变化时比较内容哈希，内容未变则复用
+        parser::ParseOptions parseOptions;           ///< 解析选项。
+    };
+
+    /**
+     * @struct Stats
+     * @brief 缓存统计。
+     */
+    struct Stats {
+        size_t hits      = 0;  ///< 命中次数（含内容哈希相同而复用的次数）
+        size_t loads     = 0;  ///< 实际解析次数。
+        size_t waits     = 0;  ///< 等待其他线程加载的次数。
+        size_t evictions = 0;  ///< 淘汰次数。
+        size_t entries   = 0;  ///< 当前缓存的文档数。
+        size_t memory    = 0;  ///< 当前缓存文档的估算内存（字节）
+    };
+
+    /**
+     * @brief 构造函数，使用默认选项。
+     */
+    TomlCache();
+
+    /**
+     * @brief 构造函数。
+     * @param options 缓存选项。
+     */
+    explicit TomlCache(Options options);
+
+    ~TomlCache();
+
+    TomlCache(const TomlCache&)            = delete;
+    TomlCache& operator=(const TomlCache&) = delete;
+
+    /**
+     * @brief 获取进程级的全局缓存。
+     */
+    static TomlCache& instance();
+
+    /**
+     * @brief 加载文件，文件未变化时返回缓存的文档。
+     * @param path 文件路径。
+     * @return 只读的共享文档。
+     * @throws TomlException 如果文件无法读取，抛出异常。
+     * @throws TomlParseException 如果解析失败，抛出异常。
+     */
+    Document load(const std::string& path);
+
+    /**
+     * @brief 移除指定文件的缓存。
+     * @param path 文件路径。
+     */
+    void invalidate(const std::string& path);
+
+    /**
+     * @brief 清空缓存。
+     */
+    void clear();
+
+    /**
+     * @brief 设置内存预算，超出时立即淘汰。
+     * @param bytes 预算（字节）
+     */
+    void setMemoryBudget(size_t bytes);
+
+    /**
+     * @brief 获取统计信息。
+     */
+    Stats stats() const;
+
+  private:
+    struct State;
+
+    std::unique_ptr<State> m_state;  ///< 缓存状态（条目、LRU 链表、锁）
+};
+
+/**
+ * @class TomlPoolResource
+ * @brief 按固定大小级别分配小块内存的池式 std::pmr 内存资源。
+ *
+ * 适用于持续修改的长生命周期文档（无法使用单调的 arena）：不超过 MAX_BLOCK 字节的请求按
+ * 16 字节为步长归入大小级别，从当前线程的空闲链表中分配和归还，无需加锁；线程缓存耗尽时
+ * 从全局池成批取出，积累过多时成批归还，因此多线程编辑时几乎没有 malloc 竞争。
+ * 更大的请求直接转发给上游资源。内存块不区分分配与归还它的线程。
+ *
+ * 资源销毁前必须释放所有从中分配的内存；各线程缓存中的空闲块在线程退出时归还全局池。
+ */
+class TomlPoolResource : public std::pmr::memory_resource {
+  public:
+    static constexpr size_t MAX_BLOCK   = 512;                      ///< 池化的最大块（字节）
+    static constexpr size_t CLASS_STEP  = 16;                       ///< 大小级别的步长（字节）
+    static constexpr size_t CLASS_COUNT = MAX_BLOCK / CLASS_STEP;  ///< 大小级别数。
+
+    /**
+     * @struct Stats
+     * @brief 分配统计。线程缓存内的计数在与全局池交换批次或线程退出时汇总，因此是近似值。
+     */
+    struct Stats {
+        size_t allocations   = 0;  ///< 池化分配次数。
+        size_t deallocations = 0;  ///< 池化释放次数。
+        size_t refills       = 0;  ///< 线程缓存从全局池取批次的次数。
+        size_t flushes       = 0;  ///< 线程缓存向全局池还批次的次数。
+        size_t reservedBytes = 0;  ///< 向上游申请的池内存（字节）
+        size_t largeBytes    = 0;  ///< 当前直接由上游分配的大块内存（字节）
+        size_t centralBlocks = 0;  ///< 全局池中的空闲块数。
+    };
+
+    /**
+     * @brief 构造函数。
+     * @param upstream 上游资源（用于申请池内存和大块内存）
+     */
+    explicit TomlPoolResource(
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+    ~TomlPoolResource() override;
+
+    TomlPoolResource(const TomlPoolResource&)            = delete;
+    TomlPoolResource& operator=(const TomlPoolResource&) = delete;
+
+    /**
+     * @brief 获取进程级的共享池。
+     */
+    static TomlPoolResource& instance();
+
+    /**
+     * @brief 获取统计信息。
+     */
+    Stats stats() const;
+
+    /**
+     * @brief 将当前线程缓存的空闲块全部归还全局池（例如在线程长时间空闲前调用）
+     */
+    void flushThreadCache();
+
+  protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+  private:
+    struct Central;
+    struct ThreadCache;
+
+    /**
+     * @brief 获取当前线程对应本资源的缓存（不存在时创建）
+     */
+    ThreadCache& threadCache();
+
+  private:
+    std::shared_ptr<Central> m_central;  ///< 全局池（线程缓存持有其引用，线程退出时可安全归还）
+};
+
+/**
+ * @class TomlFrozen
+ * @brief 冻结后的只读 TOML 树，整棵树按深度优先顺序放在一块连续内存中。
+ *
+ * 每个数组/对象的直接子节点连续存放，对象成员按键排序：下标访问为 O(1)，按键查找为二分查找。
+ * 字符串、键与日期也在同一块内存中。冻结后的树不可修改，拷贝只共享同一块内存，
+ * 可直接在线程间共享；View 在任一共享该内存的 TomlFrozen 存活期间都有效。
+ */
+class TomlFrozen {
+    struct Node;
+
+    /**
+     * @brief 连续内存的头部，其后依次是节点、日期与字符数据。
+     */
+    struct Header {
+        size_t nodeCount;   ///< 节点数
+        size_t dateOffset;  ///< 日期区相对头部的偏移
+        size_t charOffset;  ///< 字符区相对头部的偏移
+        size_t bytes;       ///< 总字节数
+
+        const Node* nodes() const noexcept {
+            return reinterpret_cast<const Node*>(this + 1);
+        }
+
+        const TomlDate* dates() const noexcept {
+            return reinterpret_cast<const TomlDate*>(reinterpret_cast<const char*>(this) +
+                                                     dateOffset);
+        }
+
+        const char* chars() const noexcept {
+            return reinterpret_cast<const char*>(this) + charOffset;
+        }
+    };
+
+    /**
+     * @brief 冻结后的节点（24 字节）
+     */
+    struct Node {
+        uint32_t keyOffset = 0;                 ///< 作为对象成员时键在字符区中的偏移
+        uint32_t keyLength = 0;                 ///< 键长度
+        uint32_t length    = 0;                 ///< 字符串长度或子节点数
+        TomlType type      = TomlType::Object;  ///< 类型
+        union
+        {
+            uint64_t offset = 0;  ///< 字符串在字符区中的偏移 / 首个子节点的下标 / 日期下标
+            bool     boolean;     ///< 布尔值。
+            int64_t  iNumber;     ///< 整数值。
+            double   dNumber;     ///< 浮点值。
+        };
+    };
+
+  public:
+    /**
+     * @class View
+     * @brief 冻结树中某个节点的只读句柄（两个指针大小，按值传递）
+     */
+    class View {
+      public:
+        /**
+         * @class Iterator
+         * @brief 遍历数组元素或对象成员（按键排序）的迭代器，成员的键通过 View::key() 获取。
+         */
+        class Iterator {
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = View;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = void;
+            using reference         = View;
+
+            Iterator() noexcept = default;
+
+            View operator*() const noexcept {
+                return View(m_header, m_node);
+            }
+
+            Iterator& operator++() noexcept {
+                ++m_node;
+                return *this;
+            }
+
+            Iterator operator++(int) noexcept {
+                Iterator old = *this;
+                ++*this;
+                return old;
+            }
+
+            bool operator==(const Iterator& other) const noexcept {
+                return m_node == other.m_node;
+            }
+
+            bool operator!=(const Iterator& other) const noexcept {
+                return m_node != other.m_node;
+            }
+
+          private:
+            friend class View;
+
+            Iterator(const Header* header, const Node* node) noexcept
+                : m_header(header), m_node(node) {}
+
+            const Header* m_header = nullptr;  ///< 所属冻结树
+            const Node*   m_node   = nullptr;  ///< 当前子节点
+        };
+
+        /**
+         * @brief 获取节点类型。
+         */
+        TomlType type() const noexcept {
+            return m_node->type;
+        }
+
+        bool isBoolean() const noexcept {
+            return type() == TomlType::Boolean;
+        }
+
+        bool isInteger() const noexcept {
+            return type() == TomlType::Integer;
+        }
+
+        bool isDouble() const noexcept {
+            return type() == TomlType::Double;
+        }
+
+        bool isNumber() const noexcept {
+            return isInteger() || isDouble();
+        }
+
+        bool isString() const noexcept {
+            return type() == TomlType::String;
+        }
+
+        bool isDate() const noexcept {
+            return type() == TomlType::Date;
+        }
+
+        bool isArray() const noexcept {
+            return type() == TomlType::Array;
+        }
+
+        bool isObject() const noexcept {
+            return type() == TomlType::Object;
+        }
+
+        /**
+         * @brief 获取数组元素或对象成员的数量，其他类型返回 0。
+         */
+        size_t size() const noexcept {
+            return isArray() || isObject() ? m_node->length : 0;
+        }
+
+        /**
+         * @brief 判断数组或对象是否为空（其他类型视为空）
+         */
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        /**
+         * @brief 获取作为对象成员时的键，其他节点返回空。
+         */
+        std::string_view key() const noexcept {
+            return {m_header->chars() + m_node->keyOffset, m_node->keyLength};
+        }
+
+        /**
+         * @brief 访问数组元素。
+         * @param index 下标。
+         * @throws TomlException 如果不是数组或下标越界，抛出异常。
+         */
+        View operator[](size_t index) const;
+
+        /**
+         * @brief 访问对象成员。
+         * @param key 键名。
+         * @throws TomlException 如果不是对象或键不存在，抛出异常。
+         */
+        View operator[](std::string_view key) const;
+
+        /**
+         * @brief 查找对象成员，不抛出异常。
+         * @param key 键名。
+         * @return 成员；不是对象或键不存在时返回空。
+         */
+        std::optional<View> find(std::string_view key) const noexcept;
+
+        /**
+         * @brief 判断对象中是否存在指定的键。
+         */
+        bool contains(std::string_view key) const noexcept {
+            return find(key).has_value();
+        }
+
+        /**
+         * @brief 按路径查找，路径格式同 TomlValue::findPath()，如 servers[0].host。
+         * @param path 查找路径。
+         * @return 节点；路径不存在或格式错误时返回空。
+         */
+        std::optional<View> findPath(std::string_view path) const noexcept;
+
+        /**
+         * @brief 获取布尔值。
+         * @throws TomlException 如果不是布尔类型，抛出异常。
+         */
+        bool asBoolean() const;
+
+        /**
+         * @brief 获取整数值。
+         * @throws TomlException 如果不是整数类型，抛出异常。
+         */
+        int64_t asInteger() const;
+
+        /**
+         * @brief 获取浮点值（整数会被转换）
+         * @throws TomlException 如果不是数字类型，抛出异常。
+         */
+        double asDouble() const;
+
+        /**
+         * @brief 获取字符串，视图指向冻结树内部。
+         * @throws TomlException 如果不是字符串类型，抛出异常。
+         */
+        std::string_view asString() const;
+
+        /**
+         * @brief 获取日期。
+         * @throws TomlException 如果不是日期类型，抛出异常。
+         */
+        const TomlDate& asDate() const;
+
+        /**
+         * @brief 获取指定类型的值，支持算术类型、std::string、std::string_view、TomlDate 与 TomlValue。
+         * @tparam T 目标类型。
+         * @throws TomlException 如果类型不匹配，抛出异常。
+         */
+        template <typename T>
+        T get() const {
+            if constexpr (std::is_same_v<T, TomlValue>) {
+                return toValue();
+            } else if constexpr (std::is_arithmetic_v<T>) {
+                switch (type()) {
+                    case TomlType::Integer: return static_cast<T>(asInteger());
+                    case TomlType::Double: return static_cast<T>(asDouble());
+                    case TomlType::Boolean: return static_cast<T>(asBoolean());
+                    default: throw TomlException("Cannot convert to numeric type");
+                }
+            } else if constexpr (std::is_same_v<T, std::string> ||
+                                 std::is_same_v<T, std::string_view>) {
+                return T(asString());
+            } else if constexpr (std::is_same_v<T, TomlDate>) {
+                return asDate();
+            } else {
+                static_assert(std::is_void_v<T>, "Unsupported type for TomlFrozen::View::get<T>()");
+                return T{};
+            }
+        }
+
+        /**
+         * @brief 数组元素或对象成员的起始迭代器。
+         */
+        Iterator begin() const noexcept {
+            return {m_header, size() != 0 ? child(0) : nullptr};
+        }
+
+        /**
+         * @brief 数组元素或对象成员的结束迭代器。
+         */
+        Iterator end() const noexcept {
+            return {m_header, size() != 0 ? child(size()) : nullptr};
+        }
+
+        /**
+         * @brief 把以该节点为根的子树还原为可修改的 TomlValue。
+         */
+        TomlValue toValue() const;
+
+      private:
+        friend class TomlFrozen;
+
+        View(const Header* header, const Node* node) noexcept : m_header(header), m_node(node) {}
+
+        /**
+         * @brief 第 index 个子节点。
+         */
+        const Node* child(size_t index) const noexcept {
+            return m_header->nodes() + m_node->offset + index;
+        }
+
+        const Header* m_header;  ///< 所属冻结树
+        const Node*   m_node;    ///< 节点
+    };
+
+    /**
+     * @brief 构造函数，冻结一个空对象。
+     */
+    TomlFrozen();
+
+    /**
+     * @brief 冻结一棵树，耗时与深拷贝一次相当。
+     *
+     * deduplicate 为 true 时按结构哈希对子树做 hash-consing：结构相同的数组/对象共用同一段
+     * 子节点，相同的字符串与键共用同一份字符数据。适合大量重复内联表的生成配置，
+     * 代价是冻结时需要额外计算结构哈希（约慢一半）
+     *
+     * @param value 根节点。
+     * @param deduplicate 是否共享相同的子树与字符串。
+     * @throws TomlException 如果字符串总长度或节点数超过 32 位偏移的上限，抛出异常。
+     */
+    explicit TomlFrozen(const TomlValue& value, bool deduplicate = false);
+
+    /**
+     * @brief 获取根节点。
+     */
+    View root() const noexcept;
+
+    /**
+     * @brief 访问根对象的成员，等价于 root()[key]。
+     */
+    View operator[](std::string_view key) const {
+        return root()[key];
+    }
+
+    /**
+     * @brief 按路径查找，等价于 root().findPath(path)。
+     */
+    std::optional<View> findPath(std::string_view path) const noexcept {
+        return root().findPath(path);
+    }
+
+    /**
+     * @brief 获取节点数量。
+     */
+    size_t nodeCount() const noexcept;
+
+    /**
+     * @brief 获取冻结树占用的字节数（整块内存的大小）
+     */
+    size_t memoryBytes() const noexcept;
+
+    /**
+     * @brief 还原为可修改的 TomlValue。
+     */
+    TomlValue thaw() const {
+        return root().toValue();
+    }
+
+  private:
+    template <size_t, size_t, size_t>
+    friend struct TomlStaticImage;
+
+    /**
+     * @brief 获取以 header 开头的连续内存的根节点（供编译期构造的冻结树使用）
+     */
+    static View viewOf(const Header* header) noexcept {
+        return View(header, header->nodes());
+    }
+
+    /**
+     * @brief 按原树结构逐节点冻结。
+     */
+    static std::shared_ptr<const std::byte[]> freezeTree(const TomlValue& value);
+
+    /**
+     * @brief 冻结并共享结构相同的子树与相同的字符串。
+     */
+    static std::shared_ptr<const std::byte[]> freezeDeduplicated(const TomlValue& value);
+
+  private:
+    std::shared_ptr<const std::byte[]> m_buffer;  ///< 连续内存：头部、节点、日期与字符数据
+};
+
+/**
+ * @class TomlDecodeTarget
+ * @brief parser::parseInto() 的写入目标。
+ *
+ * 解析器按表头与点分键逐级定位子表，把每个键值对直接交给目标而不构建整棵文档树；
+ * TomlSchema::load() 以此把文档直接解码到结构体中。
+ */
+class TomlDecodeTarget {
+  public:
+    virtual ~TomlDecodeTarget() = default;
+
+    /**
+     * @brief 写入一个键值对。
+     * @param key 键名。
+     * @param value 值（可被移动）
+     */
+    virtual void value(std::string_view key, TomlValue&& value) = 0;
+
+    /**
+     * @brief 进入子表（[a.b] 表头或 a.b = 1 经过的表），不存在时创建。
+     *
+     * 子表为表数组时进入其最后一个元素。
+     * @param key 键名。
+     * @return 子表的写入目标，在当前目标结束前有效。
+     */
+    virtual TomlDecodeTarget& table(std::string_view key) = 0;
+
+    /**
+     * @brief 向表数组追加一个元素（[[a]] 表头）
+     * @param key 键名。
+     * @return 新元素的写入目标。
+     */
+    virtual TomlDecodeTarget& append(std::string_view key) = 0;
+
+    /**
+     * @brief 文档解析完毕（只对根目标调用）
+     */
+    virtual void finish() {}
+};
+
+namespace parser {
+    /**
+     * @brief 解析 TOML 数据并把键值对逐个交给写入目标，不构建文档树。
+     * @param data 输入的 TOML 数据。
+     * @param target 根表的写入目标，解析完毕后调用其 finish()
+     * @param options 解析选项。
+     * @throws TomlParseException 如果解析失败，抛出异常；目标抛出的异常原样传出。
+     */
+    void parseInto(std::string_view    data,
+                   TomlDecodeTarget&   target,
+                   const ParseOptions& options = ParseOptions());
+}  // namespace parser
+
+/**
+ * @class TomlTreeTarget
+ * @brief 把写入的内容组装为 TomlValue 的写入目标。
+ *
+ * TomlSchema 在字段没有子模式（如 std::map、TomlValue 成员）却以表头写入时使用，
+ * 组装完毕后再按成员类型解码。
+ */
+class TomlTreeTarget final : public TomlDecodeTarget {
+  public:
+    /**
+     * @brief 构造函数。
+     * @param node 目标节点（表，或元素为表的数组，此时写入其最后一个元素）
+     */
+    explicit TomlTreeTarget(TomlValue& node) noexcept : m_node(&node) {}
+
+    ~TomlTreeTarget() override;
+
+    void              value(std::string_view key, TomlValue&& value) override;
+    TomlDecodeTarget& table(std::string_view key) override;
+    TomlDecodeTarget& append(std::string_view key) override;
+
+  private:
+    /**
+     * @brief 获取当前写入的表（节点为数组时为其最后一个元素）
+     * @throws TomlException 如果不是表，抛出异常。
+     */
+    TomlValue& current() const;
+
+    /**
+     * @brief 创建子节点的写入目标（与当前目标同生命周期）
+     */
+    TomlDecodeTarget& child(TomlValue& node);
+
+    TomlValue*                                   m_node;      ///< 目标节点。
+    std::vector<std::unique_ptr<TomlTreeTarget>> m_children;  ///< 已创建的子表目标。
+};
+
+/**
+ * @brief 解码过程中的键路径，仅在出错时才拼接为字符串。
+ */
+struct TomlKeyPath {
+    const TomlKeyPath* parent;  ///< 上一级路径（根为 nullptr）
+    std::string_view   key;     ///< 键名（根和数组元素为空）
+    size_t             index;   ///< 数组下标（非数组元素为 npos）
+
+    /**
+     * @brief 转换为 a.b[1].c 形式的字符串（根为空串）
+     */
+    std::string toString() const {
+        std::string prefix = parent != nullptr ? parent->toString() : std::string();
+        if (index != std::string_view::npos) {
+            return prefix + "[" + std::to_string(index) + "]";
+        }
+        return prefix.empty() ? std::string(key) : prefix + "." + std::string(key);
+    }
+};
+
+/**
+ * @brief TomlSchema 中字段的写入目标（内部使用）
+ */
+class TomlFieldTarget {
+  public:
+    virtual ~TomlFieldTarget() = default;
+
+    /**
+     * @brief 以表头或点分键进入字段。
+     * @return 字段对应表的写入目标（表数组为其最后一个元素）
+     */
+    virtual TomlDecodeTarget& enter() = 0;
+
+    /**
+     * @brief 为表数组字段追加一个元素（[[key]] 表头）
+     * @return 新元素的写入目标。
+     */
+    virtual TomlDecodeTarget& push() = 0;
+
+    /**
+     * @brief 字段所在的表结束：解码累积的值并检查必需键。
+     */
+    virtual void finish() = 0;
+};
+
+/**
+ * @class TomlSchema
+ * @brief 描述结构体与 TOML 表之间映射的解码表。
+ *
+ * 以 C++ DSL 声明字段，首次解码时为键建立完美哈希表；解码时对每个键只做一次哈希和一次比较，
+ * 按字段类型校验后把值（字符串与子树直接移动）写入结构体成员。load() 不构建文档树，
+ * 解析器按表头把键值对直接交给对应的结构体成员。类型错误、重复键、缺少必需键以及
+ * 严格模式下的未知键都会抛出带键路径的 TomlSchemaException。
+ *
+ * @code
+ * struct Server { std::string host; int port; };
+ * struct Config { std::string name; std::vector<Server> servers; std::optional<bool> debug; };
+ *
+ * const auto server = TomlSchema<Server>().field("host", &Server::host).field("port", &Server::port);
+ * const auto config = TomlSchema<Config>()
+ *                         .field("name", &Config::name)
+ *                         .field("servers", &Config::servers, server)
+ *                         .field("debug", &Config::debug);  // std::optional 成员可以缺省
+ * Config cfg = config.load(text);
+ * @endcode
+ *
+ * @tparam S 目标结构体类型（需可默认构造）
+ */
+template <typename S>
+class TomlSchema {
+    template <typename>
+    friend class TomlSchema;
+
+  public:
+    using Path = TomlKeyPath;  ///< 解码过程中的键路径。
+
+    /**
+     * @brief 声明一个字段。
+     * @tparam M 成员类型（数值、bool、字符串、TomlDate、TomlValue、std::optional 或支持 fromToml 的类型）
+     * @param key TOML 中的键名。
+     * @param member 成员指针。
+     * @param required 是否必需（std::optional 成员总是可缺省）
+     * @return 自身引用。
+     * @throws TomlException 如果键重复，抛出异常。
+     */
+    template <typename M>
+    TomlSchema& field(std::string_view key, M S::*member, bool required = true) {
+        return addField(key, required && !IsOptional<M>::value,
+                        std::make_shared<MemberBinding<M>>(member));
+    }
+
+    /**
+     * @brief 声明一个嵌套表字段，使用子模式解码。
+     * @tparam M 成员类型。
+     * @param key TOML 中的键名。
+     * @param member 成员指针。
+     * @param schema 成员类型的模式。
+     * @param required 是否必需。
+     * @return 自身引用。
+     */
+    template <typename M>
+    TomlSchema&
+    field(std::string_view key, M S::*member, const TomlSchema<M>& schema, bool required = true) {
+        return addField(key, required, std::make_shared<SchemaBinding<M>>(member, schema));
+    }
+
+    /**
+     * @brief 声明一个表数组字段，每个元素使用子模式解码。
+     * @tparam E 元素类型。
+     * @param key TOML 中的键名。
+     * @param member 成员指针。
+     * @param schema 元素类型的模式。
+     * @param required 是否必需。
+     * @return 自身引用。
+     */
+    template <typename E>
+    TomlSchema& field(std::string_view     key,
+                      std::vector<E> S::*  member,
+                      const TomlSchema<E>& schema,
+                      bool                 required = true) {
+        return addField(key, required, std::make_shared<ArrayBinding<E>>(member, schema));
+    }
+
+    /**
+     * @brief 设置严格模式：出现模式中未声明的键时报错。
+     * @param enable 是否启用。
+     * @return 自身引用。
+     */
+    TomlSchema& strict(bool enable = true) {
+        m_strict = enable;
+        return *this;
+    }
+
+    /**
+     * @brief 按模式解码（移动 root 中的字符串与子树）。
+     * @param root 根表。
+     * @param out 目标结构体。
+     * @throws TomlSchemaException 如果不符合模式，抛出异常。
+     */
+    void decode(TomlValue&& root, S& out) const {
+        decodeInto(std::move(root), out, Path{nullptr, {}, std::string_view::npos});
+    }
+
+    /**
+     * @brief 按模式解码（只复制写入成员的值，不复制整棵树）。
+     * @param root 根表。
+     * @param out 目标结构体。
+     * @throws TomlSchemaException 如果不符合模式，抛出异常。
+     */
+    void decode(const TomlValue& root, S& out) const {
+        decodeInto(root, out, Path{nullptr, {}, std::string_view::npos});
+    }
+
+    /**
+     * @brief 按模式解析 TOML 文本，直接写入结构体而不构建文档树。
+     *
+     * 模式之外的键只做语法检查；其余行为与 decode(parser::parse(data), out) 相同。
+     * @param data TOML 文本。
+     * @return 解码得到的结构体。
+     * @throws TomlParseException 如果解析失败，抛出异常。
+     * @throws TomlSchemaException 如果不符合模式，抛出异常。
+     */
+    S load(std::string_view data) const {
+        S      out{};
+        Target target(*this, out, Path{nullptr, {}, std::string_view::npos});
+        parser::parseInto(data, target);
+        return out;
+    }
+
+    /**
+     * @brief 将一个表解码到结构体（供嵌套模式使用，移动表中的值）
+     * @param value 表。
+     * @param out 目标结构体。
+     * @param path 当前键路径。
+     */
+    void decodeInto(TomlValue&& value, S& out, const Path& path) const {
+        decodeTable(std::move(value), out, path);
+    }
+
+    /**
+     * @brief 将一个表解码到结构体（供嵌套模式使用，复制写入成员的值）
+     * @param value 表。
+     * @param out 目标结构体。
+     * @param path 当前键路径。
+     */
+    void decodeInto(const TomlValue& value, S& out, const Path& path) const {
+        decodeTable(value, out, path);
+    }
+
+  private:
+    template <typename T>
+    struct IsOptional : std::false_type {};
+
+    template <typename T>
+    struct IsOptional<std::optional<T>> : std::true_type {};
+
+    static constexpr uint32_t NO_FIELD = UINT32_MAX;  ///< 完美哈希表空槽。
+
+    /**
+     * @brief 键的完美哈希表，在首次解码时构建（模式可能被多个线程同时使用）
+     */
+    struct Index {
+        std::once_flag        once;      ///< 保证只构建一次。
+        std::vector<uint32_t> table;     ///< 键哈希 -> 字段下标。
+        uint32_t              seed = 0;  ///< 完美哈希种子。
+    };
+
+    /**
+     * @brief 字段的解码方式。
+     */
+    class Binding {
+      public:
+        virtual ~Binding() = default;
+
+        /**
+         * @brief 解码一个值并写入成员（移动）
+         */
+        virtual void decode(TomlValue&& value, S& out, const Path& path) const = 0;
+
+        /**
+         * @brief 解码一个值并写入成员（复制）
+         */
+        virtual void decode(const TomlValue& value, S& out, const Path& path) const = 0;
+
+        /**
+         * @brief 创建以表头写入成员时的写入目标。
+         */
+        virtual std::unique_ptr<TomlFieldTarget> open(S& out, const Path& path) const = 0;
+    };
+
+    /**
+     * @brief 字段解码表项。
+     */
+    struct Field {
+        std::string                    key;       ///< 键名。
+        bool                           required;  ///< 是否必需。
+        std::shared_ptr<const Binding> binding;   ///< 解码并写入成员。
+    };
+
+    /**
+     * @brief 已出现的字段集合，用于检查重复键与必需键。
+     */
+    class Seen {
+      public:
+        explicit Seen(size_t fields) : m_more(fields > 64 ? fields : 0) {}
+
+        bool contains(size_t index) const {
+            return index < 64 ? (m_bits >> index) & 1 : m_more[index];
+        }
+
+        void insert(size_t index) {
+            if (index < 64) {
+                m_bits |= uint64_t(1) << index;
+            } else {
+                m_more[index] = true;
+            }
+        }
+
+        void clear() {
+            m_bits = 0;
+            std::fill(m_more.begin(), m_more.end(), false);
+        }
+
+      private:
+        uint64_t          m_bits = 0;  ///< 前 64 个字段。
+        std::vector<bool> m_more;      ///< 其余字段。
+    };
+
+    /**
+     * @brief 按模式解析时结构体的写入目标。
+     */
+    class Target final : public TomlDecodeTarget, public TomlFieldTarget {
+      public:
+        Target(const TomlSchema& schema, S& out, const Path& path)
+            : m_schema(&schema), m_table(&schema.index()), m_out(&out), m_path(path),
+              m_seen(schema.m_fields.size()) {}
+
+        /**
+         * @brief 改为写入另一个结构体（表数组的各元素复用同一个目标）
+         */
+        void reset(S& out, const Path& path) {
+            m_out  = &out;
+            m_path = path;
+            m_seen.clear();
+            m_fields.clear();
+        }
+
+        void value(std::string_view key, TomlValue&& value) override {
+            const uint32_t index = field(key);
+            if (index == NO_FIELD) {
+                return;
+            }
+            const Path child{&m_path, m_schema->m_fields[index].key, std::string_view::npos};
+            if (m_seen.contains(index)) {
+                throw TomlSchemaException(child.toString(), "duplicate key");
+            }
+            m_seen.insert(index);
+            withPath(child, [&] {
+                m_schema->m_fields[index].binding->decode(std::move(value), *m_out, child);
+            });
+        }
+
+        TomlDecodeTarget& table(std::string_view key) override {
+            TomlFieldTarget* target = open(key);
+            return target != nullptr ? target->enter() : ignored();
+        }
+
+        TomlDecodeTarget& append(std::string_view key) override {
+            TomlFieldTarget* target = open(key);
+            return target != nullptr ? target->push() : ignored();
+        }
+
+        TomlDecodeTarget& enter() override {
+            return *this;
+        }
+
+        TomlDecodeTarget& push() override {
+            throw TomlSchemaException(m_path.toString(), "expected table, got array");
+        }
+
+        void finish() override {
+            for (auto& target : m_fields) {
+                if (target) {
+                    target->finish();
+                }
+            }
+            m_schema->checkRequired(m_seen, m_path);
+        }
+
+      private:
+        /**
+         * @brief 查找键对应的字段，严格模式下未知键报错。
+         */
+        uint32_t field(std::string_view key) const {
+            const uint32_t index = m_schema->lookup(*m_table, key);
+            if (index == NO_FIELD && m_schema->m_strict) {
+                throw TomlSchemaException(Path{&m_path, key, std::string_view::npos}.toString(),
+                                          "unknown key");
+            }
+            return index;
+        }
+
+        /**
+         * @brief 获取以表头写入的字段的目标，首次出现时创建。
+         * @return 字段的写入目标，模式之外的键返回 nullptr。
+         */
+        TomlFieldTarget* open(std::string_view key) {
+            const uint32_t index = field(key);
+            if (index == NO_FIELD) {
+                return nullptr;
+            }
+            if (m_fields.empty()) {
+                m_fields.resize(m_schema->m_fields.size());
+            }
+            auto& target = m_fields[index];
+            if (!target) {
+                const Path child{&m_path, m_schema->m_fields[index].key, std::string_view::npos};
+                if (m_seen.contains(index)) {
+                    throw TomlSchemaException(child.toString(), "duplicate key");
+                }
+                m_seen.insert(index);
+                target = m_schema->m_fields[index].binding->open(*m_out, child);
+            }
+            return target.get();
+        }
+
+        const TomlSchema*                             m_schema;  ///< 所属模式。
+        const Index*                                  m_table;   ///< 模式的完美哈希表。
+        S*                                            m_out;     ///< 目标结构体。
+        Path                                          m_path;    ///< 当前键路径。
+        Seen                                          m_seen;    ///< 已出现的字段。
+        std::vector<std::unique_ptr<TomlFieldTarget>> m_fields;  ///< 以表头写入的字段。
+    };
+
+    /**
+     * @brief 按成员类型解码的字段。
+     */
+    template <typename M>
+    class MemberBinding final : public Binding {
+      public:
+        explicit MemberBinding(M S::*member) : m_member(member) {}
+
+        void decode(TomlValue&& value, S& out, const Path& path) const override {
+            decodeMember(std::move(value), out.*m_member, path);
+        }
+
+        void decode(const TomlValue& value, S& out, const Path& path) const override {
+            decodeMember(value, out.*m_member, path);
+        }
+
+        std::unique_ptr<TomlFieldTarget> open(S& out, const Path& path) const override {
+            return std::make_unique<MemberTarget<M>>(out.*m_member, path);
+        }
+
+      private:
+        M S::*m_member;  ///< 成员指针。
+    };
+
+    /**
+     * @brief 以表头写入普通成员时先组装为 TomlValue，字段结束时再按成员类型解码。
+     */
+    template <typename M>
+    class MemberTarget final : public TomlFieldTarget {
+      public:
+        MemberTarget(M& out, const Path& path) : m_out(out), m_path(path), m_tree(m_value) {}
+
+        TomlDecodeTarget& enter() override {
+            return m_tree;
+        }
+
+        TomlDecodeTarget& push() override {
+            if (m_value.isObject() && m_value.asObject().empty()) {
+                m_value = TomlArray();
+            }
+            if (!m_value.isArray()) {
+                throw TomlSchemaException(m_path.toString(), mismatch("array", m_value));
+            }
+            m_value.push_back(TomlObject());
+            return m_tree;
+        }
+
+        void finish() override {
+            withPath(m_path, [&] { decodeMember(std::move(m_value), m_out, m_path); });
+        }
+
+      private:
+        M&             m_out;    ///< 目标成员。
+        Path           m_path;   ///< 成员的键路径。
+        TomlValue      m_value;  ///< 累积的值。
+        TomlTreeTarget m_tree;   ///< 写入 m_value 的目标。
+    };
+
+    /**
+     * @brief 使用子模式解码的嵌套表字段。
+     */
+    template <typename M>
+    class SchemaBinding final : public Binding {
+      public:
+        SchemaBinding(M S::*member, const TomlSchema<M>& schema)
+            : m_member(member), m_schema(schema) {}
+
+        void decode(TomlValue&& value, S& out, const Path& path) const override {
+            m_schema.decodeInto(std::move(value), out.*m_member, path);
+        }
+
+        void decode(const TomlValue& value, S& out, const Path& path) const override {
+            m_schema.decodeInto(value, out.*m_member, path);
+        }
+
+        std::unique_ptr<TomlFieldTarget> open(S& out, const Path& path) const override {
+            return std::make_unique<typename TomlSchema<M>::Target>(m_schema, out.*m_member, path);
+        }
+
+      private:
+        M S::*        m_member;  ///< 成员指针。
+        TomlSchema<M> m_schema;  ///< 成员类型的模式。
+    };
+
+    /**
+     * @brief 每个元素使用子模式解码的表数组字段。
+     */
+    template <typename E>
+    class ArrayBinding final : public Binding {
+      public:
+        ArrayBinding(std::vector<E> S::*member, const TomlSchema<E>& schema)
+            : m_member(member), m_schema(schema) {}
+
+        void decode(TomlValue&& value, S& out, const Path& path) const override {
+            decodeArray(std::move(value), out, path);
+        }
+
+        void decode(const TomlValue& value, S& out, const Path& path) const override {
+            decodeArray(value, out, path);
+        }
+
+        std::unique_ptr<TomlFieldTarget> open(S& out, const Path& path) const override {
+            return std::make_unique<ArrayTarget<E>>(m_schema, out.*m_member, path);
+        }
+
+      private:
+        template <typename V>
+        void decodeArray(V&& value, S& out, const Path& path) const {
+            if (!value.isArray()) {
+                throw TomlSchemaException(path.toString(), mismatch("array", value));
+            }
+            auto& items  = value.asArray();
+            auto& target = out.*m_member;
+            target.clear();
+            target.reserve(items.size());
+            for (size_t i = 0; i < items.size(); ++i) {
+                const Path child{&path, {}, i};
+                m_schema.decodeInto(forwardTomlElement<V>(items[i]), target.emplace_back(), child);
+            }
+        }
+
+        std::vector<E> S::*m_member;  ///< 成员指针。
+        TomlSchema<E>      m_schema;  ///< 元素类型的模式。
+    };
+
+    /**
+     * @brief [[key]] 表数组的写入目标：每个元素在下一个元素开始前完成检查，元素目标被复用。
+     */
+    template <typename E>
+    class ArrayTarget final : public TomlFieldTarget {
+      public:
+        ArrayTarget(const TomlSchema<E>& schema, std::vector<E>& out, const Path& path)
+            : m_schema(schema), m_out(out), m_path(path) {
+            m_out.clear();
+        }
+
+        TomlDecodeTarget& enter() override {
+            if (!m_element) {
+                throw TomlSchemaException(m_path.toString(), "expected array, got table");
+            }
+            return *m_element;
+        }
+
+        TomlDecodeTarget& push() override {
+            if (m_element) {
+                m_element->finish();
+            }
+            E&         element = m_out.emplace_back();
+            const Path path{&m_path, {}, m_out.size() - 1};
+            if (m_element) {
+                m_element->reset(element, path);
+            } else {
+                m_element = std::make_unique<ElementTarget>(m_schema, element, path);
+            }
+            return *m_element;
+        }
+
+        void finish() override {
+            if (m_element) {
+                m_element->finish();
+            }
+        }
+
+      private:
+        using ElementTarget = typename TomlSchema<E>::Target;
+
+        const TomlSchema<E>&           m_schema;   ///< 元素类型的模式。
+        std::vector<E>&                m_out;      ///< 目标成员。
+        Path                           m_path;     ///< 成员的键路径。
+        std::unique_ptr<ElementTarget> m_element;  ///< 当前元素的写入目标。
+    };
+
+    /**
+     * @brief 模式之外的键的写入目标（丢弃所有内容）
+     */
+    class Ignored final : public TomlDecodeTarget {
+      public:
+        void value(std::string_view, TomlValue&&) override {}
+
+        TomlDecodeTarget& table(std::string_view) override {
+            return *this;
+        }
+
+        TomlDecodeTarget& append(std::string_view) override {
+            return *this;
+        }
+    };
+
+    /**
+     * @brief 获取共享的丢弃目标（无状态，可跨线程使用）
+     */
+    static TomlDecodeTarget& ignored() {
+        static Ignored target;
+        return target;
+    }
+
+    /**
+     * @brief 带种子的 FNV-1a 哈希。
+     */
+    static uint32_t hashKey(std::string_view key, uint32_t seed) noexcept {
+        uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+        for (unsigned char c : key) {
+            hash = (hash ^ c) * 16777619u;
+        }
+        return hash ^ (hash >> 15);
+    }
+
+    /**
+     * @brief 获取值类型的名称（用于报错）
+     */
+    static std::string mismatch(const char* expected, const TomlValue& value) {
+        static const char* const names[] = {"boolean", "integer", "float",  "string",
+                                            "datetime", "array",  "table"};
+        return std::string("expected ") + expected + ", got " +
+               names[static_cast<int>(value.type())];
+    }
+
+    /**
+     * @brief 执行 body，把其中的 TomlException 转换为带键路径的 TomlSchemaException。
+     */
+    template <typename F>
+    static void withPath(const Path& path, F&& body) {
+        try {
+            body();
+        } catch (const TomlSchemaException&) {
+            throw;
+        } catch (const TomlException& e) {
+            throw TomlSchemaException(path.toString(), e.what());
+        }
+    }
+
+    /**
+     * @brief 按成员类型校验并写入值（value 为右值时移动字符串与子树）
+     */
+    template <typename M, typename V>
+    static void decodeMember(V&& value, M& out, const Path& path) {
+        if constexpr (std::is_same_v<M, bool>) {
+            if (!value.isBoolean()) {
+                throw TomlSchemaException(path.toString(), mismatch("boolean", value));
+            }
+            out = static_cast<bool>(value);
+        } else if constexpr (std::is_integral_v<M>) {
+            if (value.type() != TomlType::Integer) {
+                throw TomlSchemaException(path.toString(), mismatch("integer", value));
+            }
+            const auto number = static_cast<int64_t>(value);
+            if constexpr (std::is_unsigned_v<M>) {
+                if (number < 0 || static_cast<uint64_t>(number) > std::numeric_limits<M>::max()) {
+                    throw TomlSchemaException(path.toString(), "integer out of range");
+                }
+            } else if constexpr (sizeof(M) < sizeof(int64_t)) {
+                if (number < std::numeric_limits<M>::min() ||
+                    number > std::numeric_limits<M>::max()) {
+                    throw TomlSchemaException(path.toString(), "integer out of range");
+                }
+            }
+            out = static_cast<M>(number);
+        } else if constexpr (std::is_floating_point_v<M>) {
+            if (!value.isNumber()) {
+                throw TomlSchemaException(path.toString(), mismatch("float", value));
+            }
+            out = static_cast<M>(static_cast<double>(value));
+        } else if constexpr (std::is_same_v<M, std::string>) {
+            if (!value.isString()) {
+                throw TomlSchemaException(path.toString(), mismatch("string", value));
+            }
+            if constexpr (std::is_lvalue_reference_v<V>) {
+                out = M(value.asString());
+            } else {
+                out = M(std::move(value.asString()));
+            }
+        } else if constexpr (std::is_same_v<M, TomlDate>) {
+            if (!value.isDate()) {
+                throw TomlSchemaException(path.toString(), mismatch("datetime", value));
+            }
+            out = value.asDate();
+        } else if constexpr (IsOptional<M>::value) {
+            typename M::value_type inner{};
+            decodeMember(std::forward<V>(value), inner, path);
+            out = std::move(inner);
+        } else {
+            // 容器及自定义类型交给 fromToml
+            out = fromTomlElement<M>(std::forward<V>(value));
+        }
+    }
+
+    /**
+     * @brief 将一个表解码到结构体（value 为右值时移动表中的值）
+     */
+    template <typename V>
+    void decodeTable(V&& value, S& out, const Path& path) const {
+        if (!value.isObject()) {
+            throw TomlSchemaException(path.toString(), mismatch("table", value));
+        }
+        Seen         seen(m_fields.size());
+        const Index& table = index();
+        for (auto& [key, item] : value.asObject()) {
+            const Path child{&path, key, std::string_view::npos};
+            const auto index = lookup(table, key);
+            if (index == NO_FIELD) {
+                if (m_strict) {
+                    throw TomlSchemaException(child.toString(), "unknown key");
+                }
+                continue;
+            }
+            withPath(child, [&] {
+                m_fields[index].binding->decode(forwardTomlElement<V>(item), out, child);
+            });
+            seen.insert(index);
+        }
+        checkRequired(seen, path);
+    }
+
+    /**
+     * @brief 检查必需键是否都已出现。
+     * @throws TomlSchemaException 如果缺少必需键，抛出异常。
+     */
+    void checkRequired(const Seen& seen, const Path& path) const {
+        for (size_t i = 0; i < m_fields.size(); ++i) {
+            if (m_fields[i].required && !seen.contains(i)) {
+                throw TomlSchemaException(
+                    Path{&path, m_fields[i].key, std::string_view::npos}.toString(),
+                    "missing required key");
+            }
+        }
+    }
+
+    /**
+     * @brief 添加字段，并丢弃已构建的完美哈希表（下次解码时重建）
+     */
+    TomlSchema&
+    addField(std::string_view key, bool required, std::shared_ptr<const Binding> binding) {
+        for (const auto& field : m_fields) {
+            if (field.key == key) {
+                throw TomlException("Duplicate schema key: " + std::string(key));
+            }
+        }
+        m_fields.push_back({std::string(key), required, std::move(binding)});
+        m_index = std::make_shared<Index>();
+        return *this;
+    }
+
+    /**
+     * @brief 获取完美哈希表，首次调用时构建。
+     */
+    const Index& index() const {
+        std::call_once(m_index->once, [this] { buildIndex(*m_index); });
+        return *m_index;
+    }
+
+    /**
+     * @brief 寻找使所有键互不冲突的种子与表长（完美哈希）
+     * @param index 待填充的哈希表。
+     */
+    void buildIndex(Index& index) const {
+        size_t size = 1;
+        while (size < m_fields.size() * 2) {
+            size <<= 1;
+        }
+        for (;; size <<= 1) {
+            for (uint32_t seed = 0; seed < 64; ++seed) {
+                std::vector<uint32_t> table(size, NO_FIELD);
+                bool                  collision = false;
+                for (size_t i = 0; i < m_fields.size() && !collision; ++i) {
+                    auto& slot = table[hashKey(m_fields[i].key, seed) & (size - 1)];
+                    collision  = slot != NO_FIELD;
+                    slot       = static_cast<uint32_t>(i);
+                }
+                if (!collision) {
+                    index.seed  = seed;
+                    index.table = std::move(table);
+                    return;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 查找键对应的字段下标。
+     * @param index 完美哈希表。
+     * @param key 键名。
+     * @return 字段下标，不存在时返回 NO_FIELD。
+     */
+    uint32_t lookup(const Index& index, std::string_view key) const noexcept {
+        if (index.table.empty()) {
+            return NO_FIELD;
+        }
+        const auto slot = index.table[hashKey(key, index.seed) & (index.table.size() - 1)];
+        return slot != NO_FIELD && m_fields[slot].key == key ? slot : NO_FIELD;
+    }
+
+  private:
+    std::vector<Field>     m_fields;                              ///< 字段表。
+    std::shared_ptr<Index> m_index  = std::make_shared<Index>();  ///< 延迟构建的完美哈希表。
+    bool                   m_strict = false;                      ///< 是否拒绝未知键。
+};
+
+/**
+ * @brief 将字符串字面量转为TomlValue
+ * @param data 字符串指针
+ * @param length 字符串长度
+ * @return 解析后的TomlValue
  * @note 解析调用TomlParser::parse且不支持任何扩展
  */
-inline TomlValue operator""_toml(const char* data, size_t length) {
-    return parser::parse({data, length});
+inline TomlValue operator""_toml(const char* data, size_t length) {
+    return parser::parse({data, length});
+}
+
+#    if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L &&           \
+        defined(__cpp_consteval) && defined(__cpp_lib_constexpr_vector) &&                          \
+        defined(__cpp_lib_constexpr_string) && defined(__cpp_lib_bit_cast)
+/**
+ * @brief 可作为模板参数的字符串字面量（C++20）
+ * @tparam N 字面量长度（含结尾的 '\0'）
+ */
+template <size_t N>
+struct TomlLiteral {
+    char data[N]{};  ///< 字面量内容。
+
+    /**
+     * @brief 从字符串字面量构造。
+     */
+    constexpr TomlLiteral(const char (&literal)[N]) {
+        for (size_t i = 0; i < N; ++i) {
+            data[i] = literal[i];
+        }
+    }
+
+    /**
+     * @brief 获取字面量内容（不含结尾的 '\0'）
+     */
+    constexpr std::string_view view() const {
+        return {data, N - 1};
+    }
+};
+
+/**
+ * @brief 编译期解析 TOML 字面量的实现细节。
+ *
+ * 语法与运行期的 parser::parse 一致，但表与键的重复定义按 TOML 1.0 严格检查，
+ * 差异见 operator""_tomlc；出错时在常量求值中抛出异常，表现为编译错误，
+ * 诊断信息的调用栈中包含出错原因。
+ */
+namespace literal {
+
+/**
+ * @brief 条件不成立时使常量求值失败。
+ * @param ok 条件。
+ * @param message 错误信息（出现在编译诊断中）
+ */
+constexpr void require(bool ok, const char* message) {
+    if (!ok) {
+        throw TomlParseException(message, 0);
+    }
+}
+
+/**
+ * @brief 十进制转浮点时使用的无符号大整数（32 位一块，低位在前，无高位零块）
+ */
+class BigInt {
+  public:
+    constexpr BigInt() = default;
+
+    constexpr explicit BigInt(uint32_t value) {
+        if (value != 0) {
+            m_limbs.push_back(value);
+        }
+    }
+
+    constexpr bool isZero() const noexcept {
+        return m_limbs.empty();
+    }
+
+    /**
+     * @brief *this = *this * factor + addend
+     */
+    constexpr void mulAdd(uint32_t factor, uint32_t addend) {
+        uint64_t carry = addend;
+        for (auto& limb : m_limbs) {
+            const uint64_t product = uint64_t(limb) * factor + carry;
+            limb                   = static_cast<uint32_t>(product);
+            carry                  = product >> 32;
+        }
+        if (carry != 0) {
+            m_limbs.push_back(static_cast<uint32_t>(carry));
+        }
+    }
+
+    /**
+     * @brief 左移 bits 位。
+     */
+    constexpr void shiftLeft(size_t bits) {
+        if (isZero()) {
+            return;
+        }
+        if (const size_t rest = bits % 32; rest != 0) {
+            uint32_t carry = 0;
+            for (auto& limb : m_limbs) {
+                const uint32_t next = limb >> (32 - rest);
+                limb                = (limb << rest) | carry;
+                carry               = next;
+            }
+            if (carry != 0) {
+                m_limbs.push_back(carry);
+            }
+        }
+        m_limbs.insert(m_limbs.begin(), bits / 32, 0);
+    }
+
+    /**
+     * @brief 右移 1 位。
+     */
+    constexpr void shiftRightOne() {
+        for (size_t i = 0; i < m_limbs.size(); ++i) {
+            const uint32_t high = i + 1 < m_limbs.size() ? m_limbs[i + 1] << 31 : 0;
+            m_limbs[i]          = (m_limbs[i] >> 1) | high;
+        }
+        trim();
+    }
+
+    /**
+     * @brief 有效位数（0 的位数为 0）
+     */
+    constexpr size_t bitLength() const noexcept {
+        if (isZero()) {
+            return 0;
+        }
+        size_t length = (m_limbs.size() - 1) * 32;
+        for (uint32_t top = m_limbs.back(); top != 0; top >>= 1) {
+            ++length;
+        }
+        return length;
+    }
+
+    /**
+     * @brief 获取第 index 位。
+     */
+    constexpr bool bit(size_t index) const noexcept {
+        return index / 32 < m_limbs.size() && ((m_limbs[index / 32] >> (index % 32)) & 1) != 0;
+    }
+
+    /**
+     * @brief 三路比较。
+     */
+    constexpr int compare(const BigInt& other) const noexcept {
+        if (m_limbs.size() != other.m_limbs.size()) {
+            return m_limbs.size() < other.m_limbs.size() ? -1 : 1;
+        }
+        for (size_t i = m_limbs.size(); i-- > 0;) {
+            if (m_limbs[i] != other.m_limbs[i]) {
+                return m_limbs[i] < other.m_limbs[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief *this -= other，调用方保证 *this >= other。
+     */
+    constexpr void subtract(const BigInt& other) {
+        int64_t borrow = 0;
+        for (size_t i = 0; i < m_limbs.size(); ++i) {
+            int64_t diff = int64_t(m_limbs[i]) - borrow -
+                           (i < other.m_limbs.size() ? int64_t(other.m_limbs[i]) : 0);
+            borrow     = diff < 0;
+            m_limbs[i] = static_cast<uint32_t>(diff + (borrow << 32));
+        }
+        trim();
+    }
+
+    /**
+     * @brief 取最高的 64 位（不足 64 位时左对齐）
+     * @param sticky 输出：其余低位是否非零。
+     */
+    constexpr uint64_t top64(bool& sticky) const noexcept {
+        const size_t length = bitLength();
+        const size_t low    = length > 64 ? length - 64 : 0;
+        uint64_t     result = 0;
+        for (size_t i = length; i-- > low;) {
+            result = (result << 1) | uint64_t(bit(i));
+        }
+        sticky = false;
+        for (size_t i = 0; i < low && !sticky; ++i) {
+            sticky = bit(i);
+        }
+        return length < 64 ? result << (64 - length) : result;
+    }
+
+  private:
+    constexpr void trim() {
+        while (!m_limbs.empty() && m_limbs.back() == 0) {
+            m_limbs.pop_back();
+        }
+    }
+
+  private:
+    std::vector<uint32_t> m_limbs;  ///< 数据块，低位在前。
+};
+
+/**
+ * @brief 将 mantissa × 10^exponent 就近舍入（偶数优先）为 double，结果与运行期的
+ * std::from_chars 一致；溢出或下溢为 0 时报错。
+ * @param mantissa 十进制有效数字。
+ * @param digits 有效数字的位数。
+ * @param exponent 十进制指数。
+ * @return 非负的 double 值。
+ */
+constexpr double decimalToDouble(BigInt mantissa, int64_t digits, int64_t exponent) {
+    if (mantissa.isZero()) {
+        return 0.0;
+    }
+    require(digits + exponent <= 310 && digits + exponent >= -330, "Float out of range");
+    // 求 64 位的 q 与指数 e2, 使 mantissa × 10^exponent = (q + 低位) × 2^e2
+    uint64_t q      = 0;
+    bool     sticky = false;
+    int64_t  e2     = 0;
+    if (exponent >= 0) {
+        for (int64_t i = 0; i < exponent; ++i) {
+            mantissa.mulAdd(10, 0);
+        }
+        q  = mantissa.top64(sticky);
+        e2 = int64_t(mantissa.bitLength()) - 64;
+    } else {
+        BigInt divisor(1);
+        for (int64_t i = 0; i < -exponent; ++i) {
+            divisor.mulAdd(10, 0);
+        }
+        // 对齐位长使商落在 [2^62, 2^64), 再逐位做除法
+        const int64_t shift =
+            int64_t(divisor.bitLength()) + 63 - int64_t(mantissa.bitLength());
+        if (shift >= 0) {
+            mantissa.shiftLeft(size_t(shift));
+        } else {
+            divisor.shiftLeft(size_t(-shift));
+        }
+        divisor.shiftLeft(63);
+        for (int bit = 63; bit >= 0; --bit) {
+            if (mantissa.compare(divisor) >= 0) {
+                mantissa.subtract(divisor);
+                q |= uint64_t(1) << bit;
+            }
+            divisor.shiftRightOne();
+        }
+        sticky = !mantissa.isZero();
+        e2     = -shift;
+    }
+    if ((q >> 63) == 0) {
+        q <<= 1;
+        --e2;
+    }
+
+    // 保留 53 位（次正规数更少）, 舍去的位与 sticky 决定进位
+    int64_t exp = 63 + e2;
+    require(exp <= 1023, "Float out of range");
+    const int64_t drop = exp >= -1022 ? 11 : 11 + (-1022 - exp);
+    require(drop <= 64, "Float out of range");
+    const uint64_t rest = drop == 64 ? q : q & ((uint64_t(1) << drop) - 1);
+    const uint64_t half = uint64_t(1) << (drop - 1);
+    uint64_t       bits = drop == 64 ? 0 : q >> drop;
+    if (rest > half || (rest == half && (sticky || (bits & 1) != 0))) {
+        ++bits;
+    }
+    if (exp >= -1022) {
+        if (bits == uint64_t(1) << 53) {
+            bits >>= 1;
+            ++exp;
+            require(exp <= 1023, "Float out of range");
+        }
+        bits = uint64_t(exp + 1023) << 52 | (bits & ((uint64_t(1) << 52) - 1));
+    }
+    require(bits != 0, "Float out of range");
+    return std::bit_cast<double>(bits);
+}
+
+/**
+ * @brief 已打包的日期（字段含义同 TomlDate）
+ */
+struct Date {
+    TomlDate::TomlDateTimeType type      = TomlDate::TomlDateTimeType::INVALID;
+    int64_t                    core      = 0;
+    int64_t                    subSecond = 0;
+};
+
+/**
+ * @brief 获取指定年月的天数（考虑闰年）
+ */
+constexpr int daysInMonth(int year, int month) noexcept {
+    constexpr int kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool    isLeap  = (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+    return month == 2 && isLeap ? 29 : kDays[month - 1];
+}
+
+/**
+ * @brief 词法分析日期/时间字面量，规则与打包方式同 TomlDate::lex()
+ * @param text 输入。
+ * @param position 起始位置，成功时更新为字面量之后的位置。
+ * @param date 输出的日期。
+ * @return 是否为合法的日期/时间字面量。
+ */
+constexpr bool lexDate(std::string_view text, size_t& position, Date& date) noexcept {
+    const size_t size    = text.size();
+    auto         isDigit = [&](size_t i) { return i < size && '0' <= text[i] && text[i] <= '9'; };
+    auto         twoDigits = [&](size_t i) { return (text[i] - '0') * 10 + (text[i + 1] - '0'); };
+
+    size_t  p       = position;
+    auto    type    = TomlDate::TomlDateTimeType::INVALID;
+    int64_t core    = 0;
+    int64_t sub     = 0;
+    bool    hasTime = true;
+
+    // 日期部分 YYYY-MM-DD
+    if (p + 10 <= size && text[p + 4] == '-') {
+        if (!isDigit(p) || !isDigit(p + 1) || !isDigit(p + 2) || !isDigit(p + 3) ||
+            !isDigit(p + 5) || !isDigit(p + 6) || text[p + 7] != '-' || !isDigit(p + 8) ||
+            !isDigit(p + 9)) {
+            return false;
+        }
+        const int year  = twoDigits(p) * 100 + twoDigits(p + 2);
+        const int month = twoDigits(p + 5);
+        const int day   = twoDigits(p + 8);
+        if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)) {
+            return false;
+        }
+        core = (int64_t(year) << 48) | (int64_t(month) << 44) | (int64_t(day) << 39);
+        type = TomlDate::TomlDateTimeType::LOCAL_DATE;
+        p += 10;
+        hasTime = p < size && (text[p] == 'T' || text[p] == 't' ||
+                               (text[p] == ' ' && isDigit(p + 1) && isDigit(p + 2) &&
+                                p + 3 < size && text[p + 3] == ':'));
+        if (hasTime) {
+            ++p;
+        }
+    }
+
+    // 时间部分 hh:mm:ss[.fraction]
+    if (hasTime) {
+        if (!isDigit(p) || !isDigit(p + 1) || p + 8 > size || text[p + 2] != ':' ||
+            !isDigit(p + 3) || !isDigit(p + 4) || text[p + 5] != ':' || !isDigit(p + 6) ||
+            !isDigit(p + 7)) {
+            return false;
+        }
+        const int hour = twoDigits(p), minute = twoDigits(p + 3), second = twoDigits(p + 6);
+        if (hour > 23 || minute > 59 || second > 59) {
+            return false;
+        }
+        core |= (int64_t(hour) << 34) | (int64_t(minute) << 28) | (int64_t(second) << 22);
+        p += 8;
+        if (p < size && text[p] == '.') {
+            const size_t start = ++p;
+            while (isDigit(p)) {
+                if (p - start < 9) {
+                    sub = sub * 10 + (text[p] - '0');
+                }
+                ++p;
+            }
+            if (p == start) {
+                return false;
+            }
+            for (size_t count = p - start; count < 9; ++count) {
+                sub *= 10;
+            }
+        }
+        if (type == TomlDate::TomlDateTimeType::INVALID) {
+            type = TomlDate::TomlDateTimeType::LOCAL_TIME;
+        } else {
+            type = TomlDate::TomlDateTimeType::LOCAL_DATE_TIME;
+            if (p < size && (text[p] == 'Z' || text[p] == 'z')) {
+                ++p;
+                type = TomlDate::TomlDateTimeType::OFFSET_DATE_TIME;
+            } else if (p < size && (text[p] == '+' || text[p] == '-')) {
+                if (!isDigit(p + 1) || !isDigit(p + 2) || p + 6 > size || text[p + 3] != ':' ||
+                    !isDigit(p + 4) || !isDigit(p + 5)) {
+                    return false;
+                }
+                const int offsetHour = twoDigits(p + 1), offsetMinute = twoDigits(p + 4);
+                if (offsetHour > 23 || offsetMinute > 59) {
+                    return false;
+                }
+                const int64_t offset = (text[p] == '+' ? 1 : -1) * (offsetHour * 60 + offsetMinute);
+                core |= (offset & 0xFFF) << 10;
+                p += 6;
+                type = TomlDate::TomlDateTimeType::OFFSET_DATE_TIME;
+            }
+        }
+    }
+
+    date     = {type, core, sub};
+    position = p;
+    return true;
+}
+
+/**
+ * @brief 编译期解析得到的临时节点，子节点以 Parser::values() 中的下标引用。
+ */
+struct Value {
+    /**
+     * @brief 表/数组的来源，决定之后能否再以表头或点分键扩展。
+     */
+    enum class Origin {
+        Value,     ///< 普通值（含静态数组）
+        Implicit,  ///< 由表头路径隐式创建的表
+        Header,    ///< 由 [table] 或 [[table]] 定义的表
+        Dotted,    ///< 由点分键创建的表
+        Inline,    ///< 内联表
+        Tables     ///< 表数组
+    };
+
+    TomlType                 type    = TomlType::Object;  ///< 类型
+    Origin                   origin  = Origin::Value;     ///< 来源
+    bool                     boolean = false;             ///< 布尔值
+    int64_t                  integer = 0;                 ///< 整数值
+    double                   number  = 0;                 ///< 浮点值
+    Date                     date;                        ///< 日期
+    std::string              string;                      ///< 字符串
+    std::vector<size_t>      children;  ///< 数组元素或对象成员的下标
+    std::vector<std::string> keys;      ///< 对象成员的键，与 children 一一对应
+};
+
+/**
+ * @class Parser
+ * @brief 常量求值中使用的 TOML 解析器，把文档解析为 Value 列表（下标 0 为根表）
+ */
+class Parser {
+  public:
+    /**
+     * @brief 解析整个文档。
+     * @param text TOML 文本。
+     */
+    constexpr explicit Parser(std::string_view text) : m_text(text) {
+        validateUtf8();
+        parseDocument();
+    }
+
+    /**
+     * @brief 获取解析得到的全部节点。
+     */
+    constexpr const std::vector<Value>& values() const noexcept {
+        return m_values;
+    }
+
+  private:
+    static constexpr size_t npos = size_t(-1);
+
+    constexpr char peek(size_t offset = 0) const noexcept {
+        return m_position + offset < m_text.size() ? m_text[m_position + offset] : '\0';
+    }
+
+    constexpr bool eof() const noexcept {
+        return m_position >= m_text.size();
+    }
+
+    constexpr bool startsWith(std::string_view prefix) const noexcept {
+        return m_text.substr(m_position, prefix.size()) == prefix;
+    }
+
+    static constexpr bool isControl(char c, bool allowNewline) noexcept {
+        const auto uc = static_cast<unsigned char>(c);
+        return (uc <= 0x1F && c != '\t' && !(allowNewline && (c == '\n' || c == '\r'))) ||
+               uc == 0x7F;
+    }
+
+    /**
+     * @brief 校验整个输入是合法的 UTF-8。
+     */
+    constexpr void validateUtf8() const {
+        for (size_t i = 0; i < m_text.size();) {
+            const auto lead   = static_cast<unsigned char>(m_text[i]);
+            size_t     length = lead < 0x80 ? 1 : lead < 0xC2 ? 0 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3
+                                                             : lead < 0xF5      ? 4
+                                                                                : 0;
+            require(length != 0 && i + length <= m_text.size(), "Invalid UTF-8");
+            uint32_t codePoint = length == 1 ? lead : lead & (0x7F >> length);
+            for (size_t k = 1; k < length; ++k) {
+                const auto next = static_cast<unsigned char>(m_text[i + k]);
+                require((next & 0xC0) == 0x80, "Invalid UTF-8");
+                codePoint = (codePoint << 6) | (next & 0x3F);
+            }
+            constexpr uint32_t kMinimum[] = {0, 0, 0x80, 0x800, 0x10000};
+            require(codePoint >= kMinimum[length] && codePoint <= 0x10FFFF &&
+                        (codePoint < 0xD800 || codePoint > 0xDFFF),
+                    "Invalid UTF-8");
+            i += length;
+        }
+    }
+
+    constexpr void skipWhitespace() noexcept {
+        while (peek() == ' ' || peek() == '\t') {
+            ++m_position;
+        }
+    }
+
+    /**
+     * @brief 跳过到行尾的注释。
+     */
+    constexpr void skipComment() {
+        if (peek() != '#') {
+            return;
+        }
+        for (++m_position; !eof() && peek() != '\n' && peek() != '\r'; ++m_position) {
+            require(!isControl(peek(), false), "Control character not allowed in comment");
+        }
+    }
+
+    /**
+     * @brief 跳过一个换行符（\n 或 \r\n）
+     * @return 是否跳过了换行符。
+     */
+    constexpr bool skipNewline() {
+        if (peek() == '\n') {
+            ++m_position;
+            return true;
+        }
+        if (peek() == '\r') {
+            require(peek(1) == '\n', "Bare carriage return");
+            m_position += 2;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief 跳过空白、注释与换行。
+     */
+    constexpr void skipTrivia() {
+        do {
+            skipWhitespace();
+            skipComment();
+        } while (skipNewline());
+    }
+
+    /**
+     * @brief 值或表头之后只能是注释与换行。
+     */
+    constexpr void expectLineEnd() {
+        skipWhitespace();
+        skipComment();
+        require(eof() || skipNewline(), "A line break is required after the value");
+    }
+
+    constexpr size_t make(TomlType type, Value::Origin origin = Value::Origin::Value) {
+        Value value;
+        value.type   = type;
+        value.origin = origin;
+        m_values.push_back(std::move(value));
+        return m_values.size() - 1;
+    }
+
+    constexpr size_t find(size_t table, std::string_view key) const noexcept {
+        const auto& keys = m_values[table].keys;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] == key) {
+                return m_values[table].children[i];
+            }
+        }
+        return npos;
+    }
+
+    constexpr size_t add(size_t table, const std::string& key, size_t child) {
+        m_values[table].keys.push_back(key);
+        m_values[table].children.push_back(child);
+        return child;
+    }
+
+    constexpr void parseDocument() {
+        size_t table = make(TomlType::Object, Value::Origin::Header);
+        while (true) {
+            skipTrivia();
+            if (eof()) {
+                return;
+            }
+            if (peek() == '[') {
+                const bool array = peek(1) == '[';
+                m_position += array ? 2 : 1;
+                const auto keys = parseKeys();
+                require(peek() == ']' && (!array || peek(1) == ']'), "Expected ']' after table");
+                m_position += array ? 2 : 1;
+                table = array ? appendTable(keys) : defineTable(keys);
+            } else {
+                parseKeyValue(table);
+            }
+            expectLineEnd();
+        }
+    }
+
+    /**
+     * @brief 沿表头路径进入一级：不存在则隐式创建，表数组进入最后一个元素。
+     */
+    constexpr size_t descend(size_t table, const std::string& key) {
+        const size_t member = find(table, key);
+        if (member == npos) {
+            return add(table, key, make(TomlType::Object, Value::Origin::Implicit));
+        }
+        const Value& value = m_values[member];
+        if (value.type == TomlType::Object && value.origin != Value::Origin::Inline) {
+            return member;
+        }
+        require(value.type == TomlType::Array && value.origin == Value::Origin::Tables,
+                "Key is not a table");
+        return value.children.back();
+    }
+
+    /**
+     * @brief 处理 [a.b.c] 表头。
+     * @return 表头定义的表。
+     */
+    constexpr size_t defineTable(const std::vector<std::string>& keys) {
+        size_t table = 0;
+        for (size_t i = 0; i + 1 < keys.size(); ++i) {
+            table = descend(table, keys[i]);
+        }
+        const size_t member = find(table, keys.back());
+        if (member == npos) {
+            return add(table, keys.back(), make(TomlType::Object, Value::Origin::Header));
+        }
+        Value& value = m_values[member];
+        require(value.type == TomlType::Object && value.origin == Value::Origin::Implicit,
+                "Table redefined");
+        value.origin = Value::Origin::Header;
+        return member;
+    }
+
+    /**
+     * @brief 处理 [[a.b.c]] 表头。
+     * @return 新追加的表。
+     */
+    constexpr size_t appendTable(const std::vector<std::string>& keys) {
+        size_t table = 0;
+        for (size_t i = 0; i + 1 < keys.size(); ++i) {
+            table = descend(table, keys[i]);
+        }
+        size_t array = find(table, keys.back());
+        if (array == npos) {
+            array = add(table, keys.back(), make(TomlType::Array, Value::Origin::Tables));
+        }
+        require(m_values[array].type == TomlType::Array &&
+                    m_values[array].origin == Value::Origin::Tables,
+                "Cannot append to a value that is not an array of tables");
+        const size_t element = make(TomlType::Object, Value::Origin::Header);
+        m_values[array].children.push_back(element);
+        return element;
+    }
+
+    /**
+     * @brief 解析点分键，如 a."b.c".'d'
+     */
+    constexpr std::vector<std::string> parseKeys() {
+        std::vector<std::string> keys;
+        do {
+            skipWhitespace();
+            if (peek() == '"') {
+                parseBasicString(keys.emplace_back());
+            } else if (peek() == '\'') {
+                parseLiteralString(keys.emplace_back());
+            } else {
+                // 逐字符追加: 以指针构造 std::string 会做空指针检查, 开启 -fsanitize=null 时
+                // GCC 无法在常量求值中比较模板参数对象的地址
+                auto& key = keys.emplace_back();
+                for (char c = peek(); ('A' <= c && c <= 'Z') || ('a' <= c && c <= 'z') ||
+                                      ('0' <= c && c <= '9') || c == '_' || c == '-';
+                     c      = peek()) {
+                    key.push_back(c);
+                    ++m_position;
+                }
+                require(!key.empty(), "Invalid key");
+            }
+            skipWhitespace();
+        } while (peek() == '.' && ++m_position);
+        return keys;
+    }
+
+    /**
+     * @brief 解析 key = value 并放入 table（点分键只能扩展由点分键创建的表）
+     */
+    constexpr void parseKeyValue(size_t table) {
+        const auto keys = parseKeys();
+        require(peek() == '=', "Expect = after a key");
+        ++m_position;
+        skipWhitespace();
+        const size_t value = parseValue();
+        for (size_t i = 0; i + 1 < keys.size(); ++i) {
+            size_t member = find(table, keys[i]);
+            if (member == npos) {
+                member = add(table, keys[i], make(TomlType::Object, Value::Origin::Dotted));
+            }
+            require(m_values[member].type == TomlType::Object &&
+                        m_values[member].origin == Value::Origin::Dotted,
+                    "Cannot extend a table with dotted keys");
+            table = member;
+        }
+        require(find(table, keys.back()) == npos, "Duplicate key");
+        add(table, keys.back(), value);
+    }
+
+    constexpr size_t parseValue() {
+        const char c = peek();
+        if (c == '"' || c == '\'') {
+            const size_t node   = make(TomlType::String);
+            std::string& result = m_values[node].string;
+            if (startsWith("\"\"\"")) {
+                parseMultiBasicString(result);
+            } else if (c == '"') {
+                parseBasicString(result);
+            } else if (startsWith("'''")) {
+                parseMultiLiteralString(result);
+            } else {
+                parseLiteralString(result);
+            }
+            return node;
+        }
+        if (c == '[') {
+            return parseArray();
+        }
+        if (c == '{') {
+            return parseInlineTable();
+        }
+        if (startsWith("true") || startsWith("false")) {
+            const size_t node      = make(TomlType::Boolean);
+            m_values[node].boolean = c == 't';
+            m_position += c == 't' ? 4 : 5;
+            return node;
+        }
+        const bool date = (m_position + 5 <= m_text.size() && m_text[m_position + 4] == '-' &&
+                           isDigitAt(0) && isDigitAt(1) && isDigitAt(2) && isDigitAt(3)) ||
+                          (isDigitAt(0) && isDigitAt(1) && peek(2) == ':');
+        if (date) {
+            const size_t node = make(TomlType::Date);
+            require(lexDate(m_text, m_position, m_values[node].date), "Invalid date/time literal");
+            return node;
+        }
+        require(c == '+' || c == '-' || c == 'i' || c == 'n' || isDigitAt(0), "invalid value");
+        return parseNumber();
+    }
+
+    constexpr bool isDigitAt(size_t offset) const noexcept {
+        return '0' <= peek(offset) && peek(offset) <= '9';
+    }
+
+    constexpr size_t parseArray() {
+        ++m_position;
+        const size_t array = make(TomlType::Array);
+        while (true) {
+            skipTrivia();
+            if (peek() == ']') {
+                ++m_position;
+                return array;
+            }
+            const size_t element = parseValue();
+            m_values[array].children.push_back(element);
+            skipTrivia();
+            if (peek() == ',') {
+                ++m_position;
+                continue;
+            }
+            require(peek() == ']', "Expected ',' or ']' in array");
+            ++m_position;
+            return array;
+        }
+    }
+
+    constexpr size_t parseInlineTable() {
+        ++m_position;
+        const size_t table = make(TomlType::Object, Value::Origin::Inline);
+        skipWhitespace();
+        if (peek() == '}') {
+            ++m_position;
+            return table;
+        }
+        while (true) {
+            parseKeyValue(table);
+            skipWhitespace();
+            if (peek() == ',') {
+                ++m_position;
+                continue;
+            }
+            require(peek() == '}', "Expected ',' or '}' in inline table");
+            ++m_position;
+            return table;
+        }
+    }
+
+    /**
+     * @brief 解析 \\uXXXX 或 \\UXXXXXXXX 转义并以 UTF-8 追加（position 指向 u/U）
+     */
+    constexpr void parseUnicodeEscape(std::string& result) {
+        const size_t length    = peek() == 'u' ? 4 : 8;
+        uint32_t     codePoint = 0;
+        ++m_position;
+        require(m_position + length <= m_text.size(), "Unexpected end in Unicode escape");
+        for (size_t i = 0; i < length; ++i) {
+            const char c = m_text[m_position++];
+            const int  digit = '0' <= c && c <= '9'   ? c - '0'
+                               : 'a' <= c && c <= 'f' ? c - 'a' + 10
+                               : 'A' <= c && c <= 'F' ? c - 'A' + 10
+                                                      : -1;
+            require(digit >= 0, "Invalid hexadecimal string");
+            codePoint = (codePoint << 4) | uint32_t(digit);
+        }
+        require(codePoint <= 0x10FFFF && (codePoint < 0xD800 || codePoint > 0xDFFF),
+                "Invalid Unicode code point");
+        if (codePoint <= 0x7F) {
+            result += char(codePoint);
+        } else if (codePoint <= 0x7FF) {
+            result += char(0xC0 | (codePoint >> 6));
+            result += char(0x80 | (codePoint & 0x3F));
+        } else if (codePoint <= 0xFFFF) {
+            result += char(0xE0 | (codePoint >> 12));
+            result += char(0x80 | ((codePoint >> 6) & 0x3F));
+            result += char(0x80 | (codePoint & 0x3F));
+        } else {
+            result += char(0xF0 | (codePoint >> 18));
+            result += char(0x80 | ((codePoint >> 12) & 0x3F));
+            result += char(0x80 | ((codePoint >> 6) & 0x3F));
+            result += char(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    /**
+     * @brief 解析反斜杠之后的转义字符（position 指向反斜杠之后）
+     */
+    constexpr void parseEscape(std::string& result) {
+        switch (peek()) {
+            case 'b': result += '\b'; break;
+            case 't': result += '\t'; break;
+            case 'n': result += '\n'; break;
+            case 'f': result += '\f'; break;
+            case 'r': result += '\r'; break;
+            case '"': result += '"'; break;
+            case '\\': result += '\\'; break;
+            case 'u':
+            case 'U': parseUnicodeEscape(result); return;
+            default: require(false, "Unknown escape");
+        }
+        ++m_position;
+    }
+
+    constexpr void parseBasicString(std::string& result) {
+        for (++m_position;;) {
+            require(!eof(), "Unterminated basic string");
+            const char c = m_text[m_position++];
+            if (c == '"') {
+                return;
+            }
+            if (c == '\\') {
+                parseEscape(result);
+            } else {
+                require(!isControl(c, false), "Control character not allowed in basic string");
+                result += c;
+            }
+        }
+    }
+
+    constexpr void parseMultiBasicString(std::string& result) {
+        m_position += 3;
+        skipNewline();
+        while (true) {
+            require(!eof(), "Unterminated multi-line basic string");
+            if (startsWith("\"\"\"")) {
+                // 结束符前最多还可以有两个引号属于内容
+                size_t quotes = 3;
+                while (peek(quotes) == '"') {
+                    ++quotes;
+                }
+                require(quotes <= 5, "not allow 3 \" in multi-basic string");
+                result.append(quotes - 3, '"');
+                m_position += quotes;
+                return;
+            }
+            const char c = m_text[m_position++];
+            if (c == '\\') {
+                // 行尾的反斜杠去掉其后所有的空白与换行
+                size_t ahead = 0;
+                while (peek(ahead) == ' ' || peek(ahead) == '\t') {
+                    ++ahead;
+                }
+                if (peek(ahead) == '\n' || (peek(ahead) == '\r' && peek(ahead + 1) == '\n')) {
+                    m_position += ahead;
+                    while (peek() == ' ' || peek() == '\t' || skipNewline()) {
+                        if (peek() == ' ' || peek() == '\t') {
+                            ++m_position;
+                        }
+                    }
+                } else {
+                    parseEscape(result);
+                }
+            } else {
+                require(!isControl(c, true) && (c != '\r' || peek() == '\n'),
+                        "Control character not allowed in multi-line basic string");
+                result += c;
+            }
+        }
+    }
+
+    constexpr void parseLiteralString(std::string& result) {
+        for (++m_position;;) {
+            require(!eof(), "Unterminated literal string");
+            const char c = m_text[m_position++];
+            if (c == '\'') {
+                return;
+            }
+            require(!isControl(c, false), "Control character not allowed in literal string");
+            result += c;
+        }
+    }
+
+    constexpr void parseMultiLiteralString(std::string& result) {
+        m_position += 3;
+        skipNewline();
+        while (true) {
+            require(!eof(), "Unterminated multi-line literal string");
+            if (startsWith("'''")) {
+                size_t quotes = 3;
+                while (peek(quotes) == '\'') {
+                    ++quotes;
+                }
+                require(quotes <= 5, "not allow 3 ' in multi-literal string");
+                result.append(quotes - 3, '\'');
+                m_position += quotes;
+                return;
+            }
+            const char c = m_text[m_position++];
+            require(!isControl(c, true) && (c != '\r' || peek() == '\n'),
+                    "Control character not allowed in multi-line literal string");
+            result += c;
+        }
+    }
+
+    /**
+     * @brief 读取一段数字（下划线只能出现在两个数字之间）
+     * @param base 进制。
+     * @return 去掉下划线后的数字。
+     */
+    constexpr std::string parseDigits(int base) {
+        std::string digits;
+        bool        underscore = false;
+        while (true) {
+            const char c = peek();
+            if (c == '_') {
+                require(!digits.empty() && !underscore, "Underscore must be between digits");
+                underscore = true;
+                ++m_position;
+                continue;
+            }
+            const bool valid = base == 16 ? (('0' <= c && c <= '9') || ('a' <= c && c <= 'f') ||
+                                             ('A' <= c && c <= 'F'))
+                                          : ('0' <= c && c < char('0' + base));
+            if (!valid) {
+                break;
+            }
+            digits += c;
+            underscore = false;
+            ++m_position;
+        }
+        require(!underscore, "Underscore must be followed by a digit");
+        return digits;
+    }
+
+    constexpr size_t parseNumber() {
+        const size_t start    = m_position;
+        bool         negative = false;
+        if (peek() == '+' || peek() == '-') {
+            negative = peek() == '-';
+            ++m_position;
+        }
+        if (startsWith("inf") || startsWith("nan")) {
+            const size_t node     = make(TomlType::Double);
+            const double infinity = std::numeric_limits<double>::infinity();
+            m_values[node].number = peek() == 'n' ? std::numeric_limits<double>::quiet_NaN()
+                                                  : (negative ? -infinity : infinity);
+            m_position += 3;
+            return node;
+        }
+
+        int base = 10;
+        if (peek() == '0' && (peek(1) == 'x' || peek(1) == 'o' || peek(1) == 'b')) {
+            require(m_position == start, "Sign is only allowed in decimal numbers");
+            base = peek(1) == 'x' ? 16 : peek(1) == 'o' ? 8 : 2;
+            m_position += 2;
+        }
+        const std::string integral = parseDigits(base);
+        require(!integral.empty(), "Invalid number");
+        require(base != 10 || integral.size() == 1 || integral[0] != '0',
+                "Leading zeros are not allowed");
+
+        std::string fraction;
+        bool        isFloat  = false;
+        int64_t     exponent = 0;
+        if (base == 10 && peek() == '.') {
+            ++m_position;
+            isFloat  = true;
+            fraction = parseDigits(10);
+            require(!fraction.empty(), "Expected digits after '.'");
+        }
+        if (base == 10 && (peek() == 'e' || peek() == 'E')) {
+            ++m_position;
+            isFloat                = true;
+            const bool negativeExp = peek() == '-';
+            if (peek() == '+' || peek() == '-') {
+                ++m_position;
+            }
+            const std::string digits = parseDigits(10);
+            require(!digits.empty(), "Expected digits after exponent");
+            for (char digit : digits) {
+                exponent = exponent < 100000 ? exponent * 10 + (digit - '0') : exponent;
+            }
+            exponent = negativeExp ? -exponent : exponent;
+        }
+
+        if (isFloat) {
+            BigInt  mantissa;
+            int64_t digits = 0;
+            for (char digit : integral + fraction) {
+                mantissa.mulAdd(10, uint32_t(digit - '0'));
+                digits += !mantissa.isZero();
+            }
+            const double value = decimalToDouble(std::move(mantissa), digits,
+                                                 exponent - int64_t(fraction.size()));
+            const size_t node     = make(TomlType::Double);
+            m_values[node].number = negative ? -value : value;
+            return node;
+        }
+
+        // 负数可以取到 2^63
+        const uint64_t limit = uint64_t(INT64_MAX) + (negative ? 1 : 0);
+        uint64_t       value = 0;
+        for (char digit : integral) {
+            const uint64_t d = '0' <= digit && digit <= '9'   ? uint64_t(digit - '0')
+                               : 'a' <= digit && digit <= 'f' ? uint64_t(digit - 'a' + 10)
+                                                              : uint64_t(digit - 'A' + 10);
+            require(value <= (limit - d) / uint64_t(base), "Invalid integer");
+            value = value * uint64_t(base) + d;
+        }
+        const size_t node      = make(TomlType::Integer);
+        m_values[node].integer = negative ? int64_t(0 - value) : int64_t(value);
+        return node;
+    }
+
+  private:
+    std::string_view   m_text;          ///< 输入
+    size_t             m_position = 0;  ///< 当前位置
+    std::vector<Value> m_values;        ///< 全部节点（下标 0 为根表）
+};
+
+/**
+ * @brief 冻结布局所需的节点数、日期数与字符数。
+ */
+struct Sizes {
+    size_t nodes = 0;  ///< 节点数
+    size_t dates = 0;  ///< 日期数
+    size_t chars = 0;  ///< 字符串与键的总长度
+};
+
+/**
+ * @brief 在编译期解析一次，统计冻结布局的大小。
+ * @param text TOML 文本。
+ */
+consteval Sizes measure(std::string_view text) {
+    const Parser parser(text);
+    Sizes        sizes;
+    for (const auto& value : parser.values()) {
+        ++sizes.nodes;
+        sizes.dates += value.type == TomlType::Date;
+        sizes.chars += value.string.size();
+        for (const auto& key : value.keys) {
+            sizes.chars += key.size();
+        }
+    }
+    return sizes;
+}
+
+}  // namespace literal
+
+/**
+ * @brief 编译期构造的冻结树：内存布局与 TomlFrozen 的连续内存完全相同（头部、节点、日期、字符），
+ * 以 constexpr 变量存放在只读数据段中，通过 TomlFrozen::View 访问。
+ * @tparam NodeCount 节点数。
+ * @tparam DateCount 日期数。
+ * @tparam CharCount 字符串与键的总长度。
+ */
+template <size_t NodeCount, size_t DateCount, size_t CharCount>
+struct TomlStaticImage {
+    TomlFrozen::Header header{};                ///< 头部
+    TomlFrozen::Node   nodes[NodeCount];        ///< 节点（紧跟在头部之后）
+    TomlDate           dates[DateCount + 1];    ///< 日期（多留一项以避免零长数组）
+    char               chars[CharCount + 1]{};  ///< 字符数据
+
+    /**
+     * @brief 在编译期解析 text 并按 TomlFrozen::freezeTree() 的顺序写入节点。
+     * @param text TOML 文本。
+     */
+    consteval explicit TomlStaticImage(std::string_view text) {
+        const literal::Parser parser(text);
+        const auto&           values = parser.values();
+        header = {NodeCount, offsetof(TomlStaticImage, dates), offsetof(TomlStaticImage, chars),
+                  sizeof(TomlStaticImage)};
+
+        size_t nextNode = 1, nextDate = 0, nextChar = 0;
+        auto   copyChars = [&](std::string_view text) {
+            for (char c : text) {
+                chars[nextChar++] = c;
+            }
+            return uint32_t(nextChar - text.size());
+        };
+        std::vector<std::pair<size_t, size_t>> pending{{0, 0}};
+        while (!pending.empty()) {
+            const auto [source, index] = pending.back();
+            pending.pop_back();
+            const literal::Value& value = values[source];
+            TomlFrozen::Node&     node  = nodes[index];
+            node.type                   = value.type;
+            switch (value.type) {
+                case TomlType::Boolean: node.boolean = value.boolean; break;
+                case TomlType::Integer: node.iNumber = value.integer; break;
+                case TomlType::Double: node.dNumber = value.number; break;
+                case TomlType::String:
+                    node.length = uint32_t(value.string.size());
+                    node.offset = copyChars(value.string);
+                    break;
+                case TomlType::Date:
+                    dates[nextDate] = TomlDate(value.date.type, value.date.core, value.date.subSecond);
+                    node.offset     = nextDate++;
+                    break;
+                case TomlType::Array: {
+                    const size_t first = nextNode;
+                    node.length        = uint32_t(value.children.size());
+                    node.offset        = first;
+                    nextNode += value.children.size();
+                    for (size_t i = value.children.size(); i-- > 0;) {
+                        pending.emplace_back(value.children[i], first + i);
+                    }
+                    break;
+                }
+                case TomlType::Object: {
+                    // 成员按键排序, 查找时可直接二分
+                    std::vector<size_t> order(value.keys.size());
+                    for (size_t i = 0; i < order.size(); ++i) {
+                        size_t j = i;
+                        for (; j > 0 && value.keys[i] < value.keys[order[j - 1]]; --j) {
+                            order[j] = order[j - 1];
+                        }
+                        order[j] = i;
+                    }
+                    const size_t first = nextNode;
+                    node.length        = uint32_t(order.size());
+                    node.offset        = first;
+                    nextNode += order.size();
+                    for (size_t i = 0; i < order.size(); ++i) {
+                        nodes[first + i].keyOffset = copyChars(value.keys[order[i]]);
+                        nodes[first + i].keyLength = uint32_t(value.keys[order[i]].size());
+                    }
+                    for (size_t i = order.size(); i-- > 0;) {
+                        pending.emplace_back(value.children[order[i]], first + i);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 获取根节点。
+     */
+    TomlFrozen::View root() const noexcept {
+        static_assert(offsetof(TomlStaticImage, nodes) == sizeof(TomlFrozen::Header),
+                      "nodes must directly follow the header");
+        return TomlFrozen::viewOf(&header);
+    }
+};
+
+/**
+ * @brief 在编译期把字符串字面量解析为只读的冻结树（C++20）
+ *
+ * 解析在常量求值中完成，结果是与 TomlFrozen 布局相同、位于只读数据段中的节点表，
+ * 运行期没有任何解析或分配，返回的 View 在整个程序运行期间都有效：
+ * @code
+ * auto defaults = R"(port = 8080)"_tomlc;
+ * int64_t port = defaults["port"].asInteger();
+ * @endcode
+ * 字面量有语法错误时编译失败。较大的字面量可能需要放宽编译器的常量求值步数限制
+ * （如 GCC 的 -fconstexpr-ops-limit）。
+ *
+ * 与 parser::parse 的差异：两者得到的值完全一致，但 _tomlc 按 TOML 1.0 拒绝重复定义，
+ * 以下文档 parser::parse（以及 CCTOML_STATIC_TOML）可以解析，_tomlc 则编译失败：
+ * - 同一个表的表头出现两次，如 "[a]\nb = 1\n[a]\nc = 2"
+ * - 以表头重新定义由点分键创建的表，如 "a.b = 1\n[a]\nc = 2"
+ * - 以点分键扩展由表头定义的表或内联表，如 "[a.b]\n[a]\nb.c = 1"、"t = {x = 1}\nt.y = 2"
+ * - 内联表中的重复键，如 "t = {b = 1, b = 2}"
+ * - 以表头扩展内联表或静态数组，如 "a = {}\n[a.b]"、"a = []\n[[a]]"
+ *
+ * @tparam Literal 字面量内容。
+ * @return 根节点的只读视图。
+ * @note C++17 下请使用 CCTOML_STATIC_TOML 宏（运行期解析一次）。
+ */
+template <TomlLiteral Literal>
+TomlFrozen::View operator""_tomlc() noexcept {
+    static constexpr literal::Sizes sizes = literal::measure(Literal.view());
+    static constexpr TomlStaticImage<sizes.nodes, sizes.dates, sizes.chars> image(Literal.view());
+    return image.root();
 }
+#    endif
+
+/**
+ * @brief 将字符串字面量解析为只读的冻结树，每个调用点只在首次执行时解析一次。
+ *
+ * 与 _tomlc 返回相同的 TomlFrozen::View，是 C++17 下的运行期回退写法：
+ * auto defaults = CCTOML_STATIC_TOML(R"(port = 8080)");
+ */
+#    define CCTOML_STATIC_TOML(literal)                                                            \
+        ([]() -> ::cctoml::TomlFrozen::View {                                                      \
+            static const ::cctoml::TomlFrozen frozen(::cctoml::parser::parse(literal));            \
+            return frozen.root();                                                                  \
+        }())
 
 }  // namespace cctoml
 
@@ -2,524 +2,3700 @@
 #pragma ide diagnostic ignored "misc-no-recursion"
 #include "cctoml.h"
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
 #include <charconv>
 #include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
 #include <iomanip>
 #include <iostream>
+#include <list>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
+#include <unordered_map>
 #include <variant>
 
+#if defined(__unix__) || defined(__APPLE__)
+#    include <fcntl.h>
+#    include <sys/stat.h>
+#    include <sys/uio.h>
+#    include <unistd.h>
+#    define CCTOML_HAVE_POSIX_STAT
+#    define CCTOML_HAVE_WRITEV
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#    include <immintrin.h>
+#    if defined(__GNUC__) || defined(__clang__)
+// GCC/Clang：按函数启用指令集，运行时根据 CPU 选择实现
+#        define CCTOML_TARGET(isa) __attribute__((target(isa)))
+#        define CCTOML_UTF8_RUNTIME_DISPATCH
+#        define CCTOML_UTF8_AVX2
+#        define CCTOML_UTF8_SSE41
+#    else
+#        define CCTOML_TARGET(isa)
+#        if defined(__AVX2__)
+#            define CCTOML_UTF8_AVX2
+#        endif
+#        if defined(__AVX__) || defined(__SSE4_1__)
+#            define CCTOML_UTF8_SSE41
+#        endif
+#    endif
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#    include <arm_neon.h>
+#    define CCTOML_UTF8_NEON
+#endif
+
 namespace cctoml {
 /*—————————————————————————————————TomlDate—————————————————————————————————————*/
-TomlDate::TomlDate(const TomlDate& date) noexcept {
-    m_type      = date.m_type;
-    m_core      = date.m_core;
-    m_subSecond = date.m_subSecond;
-}
-
-TomlDate::TomlDate(TomlDate&& date) noexcept {
-    m_type      = date.m_type;
-    m_core      = date.m_core;
-    m_subSecond = date.m_subSecond;
-    // 赋值原date
-    date.m_type = TomlDateTimeType::INVALID;
-    date.m_core = date.m_subSecond = 0;
-}
-
-TomlDate& TomlDate::operator=(const cctoml::TomlDate& date) noexcept = default;
-
-TomlDate& TomlDate::operator=(cctoml::TomlDate&& date) noexcept {
-    m_type      = date.m_type;
-    m_core      = date.m_core;
-    m_subSecond = date.m_subSecond;
-    // 赋值原date
-    date.m_type = TomlDateTimeType::INVALID;
-    date.m_core = date.m_subSecond = 0;
+#define IS_DIGIT(c) ('0' <= (c) && (c) <= '9')
+
+/**
+ * @brief 以小端序从指针处读取 8 个字节（与平台字节序无关）。
+ * @param p 起始指针，调用方保证至少 8 字节可读。
+ * @return 读取到的 64 位整数，p[0] 位于最低字节。
+ */
+static inline uint64_t loadLittleEndian64(const char* p) noexcept {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+/**
+ * @brief 使用 SWAR 解析形如 "NN?NN?NN" 的 8 字节定宽字段（? 为分隔符）。
+ *
+ * 一次 64 位读取同时校验 6 个数字和 2 个分隔符，并将相邻两位数字合并为两位数。
+ * hh:mm:ss 直接使用本函数；YYYY-MM-DD 则从第 3 个字节开始读取 "YY-MM-DD"。
+ *
+ * @param p 字段起始指针，调用方保证至少 8 字节可读。
+ * @param separator 分隔符（'-' 或 ':'）
+ * @param first 输出：第一个两位数。
+ * @param second 输出：第二个两位数。
+ * @param third 输出：第三个两位数。
+ * @return 如果格式合法，返回 true，否则返回 false。
+ */
+static inline bool
+parseSwarTriple(const char* p, char separator, int& first, int& second, int& third) noexcept {
+    // 第 2、5 字节为分隔符，其余 6 个字节为数字
+    constexpr uint64_t kSeparatorMask = 0x0000FF0000FF0000ULL;
+    constexpr uint64_t kDigitMask     = ~kSeparatorMask;
+    constexpr uint64_t kHighNibble    = 0xF0F000F0F000F0F0ULL;
+    constexpr uint64_t kZeros         = 0x3030003030003030ULL;
+    constexpr uint64_t kSixes         = 0x0606000606000606ULL;
+
+    const uint64_t value = loadLittleEndian64(p);
+    const uint64_t sep   = static_cast<uint64_t>(static_cast<unsigned char>(separator)) *
+                         0x0000010000010000ULL;
+    // '0'~'9' 的高半字节为 3，且加 6 后不会进位到 4
+    const bool ok = ((value & kSeparatorMask) == sep) & ((value & kHighNibble) == kZeros) &
+                    (((value + kSixes) & kHighNibble) == kZeros);
+    if (!ok) {
+        return false;
+    }
+    // 每个数字字节减去 '0' 后，相邻两字节合并为 d0 * 10 + d1，落在第 0、3、6 字节
+    const uint64_t digits = (value & kDigitMask) - kZeros;
+    const uint64_t pairs  = digits * 10 + (digits >> 8);
+    first                 = static_cast<int>(pairs & 0xFF);
+    second                = static_cast<int>((pairs >> 24) & 0xFF);
+    third                 = static_cast<int>((pairs >> 48) & 0xFF);
+    return true;
+}
+
+/**
+ * @brief 获取指定年月的天数（考虑闰年）。
+ * @param year 年份。
+ * @param month 月份（1-12）
+ * @return 该月的天数。
+ */
+static constexpr int daysInMonth(int year, int month) noexcept {
+    constexpr int kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool    isLeap  = (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+    return month == 2 && isLeap ? 29 : kDays[month - 1];
+}
+
+bool TomlDate::lex(std::string_view sv, size_t& position, TomlDate& date) noexcept {
+    static constexpr int64_t kPow10[] = {1,      10,      100,      1000,      10000,
+                                         100000, 1000000, 10000000, 100000000, 1000000000};
+
+    const char*       p   = sv.data() + position;
+    const char* const end = sv.data() + sv.size();
+
+    TomlDateTimeType type      = TomlDateTimeType::INVALID;
+    int64_t          core      = 0;
+    int64_t          subSecond = 0;
+    bool             hasTime   = true;
+
+    // 解析日期部分 YYYY-MM-DD
+    if (end - p >= 10 && p[4] == '-') {
+        int yearLow, month, day;
+        if (!IS_DIGIT(p[0]) || !IS_DIGIT(p[1]) || !parseSwarTriple(p + 2, '-', yearLow, month, day)) {
+            return false;
+        }
+        const int year = (p[0] - '0') * 1000 + (p[1] - '0') * 100 + yearLow;
+        if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)) {
+            return false;
+        }
+        core = (static_cast<int64_t>(year) << 48) | (static_cast<int64_t>(month) << 44) |
+               (static_cast<int64_t>(day) << 39);
+        type = TomlDateTimeType::LOCAL_DATE;
+        p += 10;
+        // 日期与时间之间的分隔符：T/t 后必须是时间；空格仅在其后确为时间时才视为分隔符
+        hasTime = p < end && (*p == 'T' || *p == 't' ||
+                              (*p == ' ' && end - p > 3 && IS_DIGIT(p[1]) && IS_DIGIT(p[2]) &&
+                               p[3] == ':'));
+        if (hasTime) {
+            ++p;
+        }
+    }
+
+    // 解析时间部分 hh:mm:ss
+    if (hasTime) {
+        int hour, minute, second;
+        if (end - p < 8 || !parseSwarTriple(p, ':', hour, minute, second) || hour > 23 ||
+            minute > 59 || second > 59) {
+            return false;
+        }
+        core |= (static_cast<int64_t>(hour) << 34) | (static_cast<int64_t>(minute) << 28) |
+                (static_cast<int64_t>(second) << 22);
+        p += 8;
+
+        // 解析可选的亚秒部分，超出纳秒精度的数字被截断
+        if (p < end && *p == '.') {
+            const char* fracStart = ++p;
+            while (p < end && IS_DIGIT(*p)) {
+                if (p - fracStart < 9) {
+                    subSecond = subSecond * 10 + (*p - '0');
+                }
+                ++p;
+            }
+            const auto count = p - fracStart;
+            if (count == 0) {
+                return false;
+            }
+            if (count < 9) {
+                subSecond *= kPow10[9 - count];
+            }
+        }
+
+        if (type == TomlDateTimeType::INVALID) {
+            type = TomlDateTimeType::LOCAL_TIME;
+        } else {
+            type = TomlDateTimeType::LOCAL_DATE_TIME;
+            // 解析可选的时区偏移 Z 或 ±hh:mm
+            if (p < end && (*p == 'Z' || *p == 'z')) {
+                ++p;
+                type = TomlDateTimeType::OFFSET_DATE_TIME;
+            } else if (p < end && (*p == '+' || *p == '-')) {
+                if (end - p < 6 || !IS_DIGIT(p[1]) || !IS_DIGIT(p[2]) || p[3] != ':' ||
+                    !IS_DIGIT(p[4]) || !IS_DIGIT(p[5])) {
+                    return false;
+                }
+                const int offsetHour   = (p[1] - '0') * 10 + (p[2] - '0');
+                const int offsetMinute = (p[4] - '0') * 10 + (p[5] - '0');
+                if (offsetHour > 23 || offsetMinute > 59) {
+                    return false;
+                }
+                const int64_t offset =
+                    (*p == '+' ? 1 : -1) * static_cast<int64_t>(offsetHour * 60 + offsetMinute);
+                // 时区偏移：12位，startBit=10，bitCount=12
+                core |= (offset & 0xFFF) << 10;
+                p += 6;
+                type = TomlDateTimeType::OFFSET_DATE_TIME;
+            }
+        }
+    }
+
+    date.m_type      = type;
+    date.m_core      = core;
+    date.m_subSecond = subSecond;
+    position         = static_cast<size_t>(p - sv.data());
+    return true;
+}
+
+void TomlDate::parse(const std::string_view& sv) {
+    // 为确保重入安全，先清空所有可选成员
+    this->reset();
+    if (sv.empty()) {
+        throw TomlException("Cannot parse an empty string.");
+    }
+    // 必须完全匹配整个字符串
+    size_t position = 0;
+    if (!lex(sv, position, *this) || position != sv.size()) {
+        this->reset();
+        throw TomlException("String does not match any valid TOML date/time format: " +
+                            std::string(sv));
+    }
+}
+
+/**
+ * @brief 两位十进制数字表，"00" ~ "99" 依次排列，用于一次写出两个字符。
+ */
+static constexpr char kTwoDigits[] = "00010203040506070809"
+                                     "10111213141516171819"
+                                     "20212223242526272829"
+                                     "30313233343536373839"
+                                     "40414243444546474849"
+                                     "50515253545556575859"
+                                     "60616263646566676869"
+                                     "70717273747576777879"
+                                     "80818283848586878889"
+                                     "90919293949596979899";
+
+/**
+ * @brief 写出一个两位数（0-99）。
+ * @param out 输出指针。
+ * @param value 要写出的值。
+ * @return 写入后的输出指针。
+ */
+static inline char* writeTwoDigits(char* out, int64_t value) noexcept {
+    std::memcpy(out, kTwoDigits + value * 2, 2);
+    return out + 2;
+}
+
+size_t TomlDate::format(char* out) const noexcept {
+    if (m_type == TomlDateTimeType::INVALID) {
+        return 0;
+    }
+    char* p = out;
+    // YYYY-MM-dd
+    if (m_type != TomlDateTimeType::LOCAL_TIME) {
+        const int64_t year = getSignedBits(m_core, 48, 16);
+        p                  = writeTwoDigits(p, year / 100 % 100);
+        p                  = writeTwoDigits(p, year % 100);
+        *p++               = '-';
+        p                  = writeTwoDigits(p, getBits(m_core, 44, 4));
+        *p++               = '-';
+        p                  = writeTwoDigits(p, getBits(m_core, 39, 5));
+        if (m_type == TomlDateTimeType::LOCAL_DATE) {
+            return static_cast<size_t>(p - out);
+        }
+        *p++ = 'T';
+    }
+    // hh:mm:ss
+    p    = writeTwoDigits(p, getBits(m_core, 34, 5));
+    *p++ = ':';
+    p    = writeTwoDigits(p, getBits(m_core, 28, 6));
+    *p++ = ':';
+    p    = writeTwoDigits(p, getBits(m_core, 22, 6));
+    // 亚秒：补足 9 位后去掉尾部零（TOML spec）
+    int64_t subSecond = m_subSecond & 0x3FFFFFFF;
+    if (subSecond > 0) {
+        *p++ = '.';
+        char digits[10];
+        digits[0] = static_cast<char>('0' + subSecond / 100000000);
+        subSecond %= 100000000;
+        for (int i = 1; i < 9; i += 2) {
+            writeTwoDigits(digits + i, subSecond / 1000000);
+            subSecond = subSecond % 1000000 * 100;
+        }
+        int length = 9;
+        while (digits[length - 1] == '0') {
+            --length;
+        }
+        std::memcpy(p, digits, static_cast<size_t>(length));
+        p += length;
+    }
+    // 时区偏移
+    if (m_type == TomlDateTimeType::OFFSET_DATE_TIME) {
+        const int64_t offset = getSignedBits(m_core, 10, 12);
+        if (offset == 0) {
+            *p++ = 'Z';
+        } else {
+            const int64_t absOffset = offset < 0 ? -offset : offset;
+            *p++                    = offset > 0 ? '+' : '-';
+            p                       = writeTwoDigits(p, absOffset / 60);
+            *p++                    = ':';
+            p                       = writeTwoDigits(p, absOffset % 60);
+        }
+    }
+    return static_cast<size_t>(p - out);
+}
+
+std::string TomlDate::toString() const noexcept {
+    char buffer[FORMAT_BUFFER_SIZE];
+    return {buffer, format(buffer)};
+}
+
+std::chrono::system_clock::time_point TomlDate::toSystemTimePoint() const {
+    if (m_type == TomlDateTimeType::INVALID) {
+        throw TomlException("An invalid date cannot be converted to a system_clock::time_point.");
+    }
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(toUnixNanos())));
+}
+
+TomlDate TomlDate::fromUnixNanos(int64_t nanos, TomlDateTimeType type, int tzOffset) noexcept {
+    constexpr int64_t kNanosPerSecond = 1000000000;
+    constexpr int64_t kNanosPerDay    = 86400 * kNanosPerSecond;
+
+    TomlDate date;
+    if (type == TomlDateTimeType::INVALID) {
+        return date;
+    }
+    if (type != TomlDateTimeType::OFFSET_DATE_TIME) {
+        tzOffset = 0;
+    }
+    // 先换算为偏移后的本地时间, 再按天向下取整拆分
+    const int64_t local      = nanos + static_cast<int64_t>(tzOffset) * 60 * kNanosPerSecond;
+    int64_t       days       = local / kNanosPerDay;
+    int64_t       nanosOfDay = local % kNanosPerDay;
+    if (nanosOfDay < 0) {
+        nanosOfDay += kNanosPerDay;
+        --days;
+    }
+
+    date.m_type = type;
+    if (type != TomlDateTimeType::LOCAL_TIME) {
+        int64_t  year;
+        unsigned month, day;
+        civilFromDays(days, year, month, day);
+        date.setYear(static_cast<int>(year));
+        date.setMonth(static_cast<int>(month));
+        date.setDay(static_cast<int>(day));
+    }
+    if (type != TomlDateTimeType::LOCAL_DATE) {
+        const int64_t seconds = nanosOfDay / kNanosPerSecond;
+        date.setHour(static_cast<int>(seconds / 3600));
+        date.setMinute(static_cast<int>(seconds / 60 % 60));
+        date.setSecond(static_cast<int>(seconds % 60));
+        date.m_subSecond = nanosOfDay % kNanosPerSecond;
+    }
+    if (type == TomlDateTimeType::OFFSET_DATE_TIME) {
+        date.setTzOffset(tzOffset);
+    }
+    return date;
+}
+
+void TomlDate::batchToUnixNanos(const TomlDate* dates, size_t count, int64_t* out) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = dates[i].toUnixNanos();
+    }
+}
+
+std::vector<int64_t> TomlDate::batchToUnixNanos(const TomlArray& array) {
+    std::vector<int64_t> result(array.size());
+    for (size_t i = 0; i < array.size(); ++i) {
+        result[i] = array[i].asDate().toUnixNanos();
+    }
+    return result;
+}
+
+void TomlDate::batchFromUnixNanos(const int64_t*   nanos,
+                                  size_t           count,
+                                  TomlDate*        out,
+                                  TomlDateTimeType type,
+                                  int              tzOffset) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = fromUnixNanos(nanos[i], type, tzOffset);
+    }
+}
+
+void TomlDate::reset() noexcept {
+    m_type      = TomlDateTimeType::INVALID;
+    m_core      = 0;
+    m_subSecond = 0;
+}
+
+/*—————————————————————————————————TomlDateArray——————————————————————————————————————*/
+
+/**
+ * @brief 将系统时间点转换为距 Unix 纪元的纳秒数。
+ * @param timePoint 系统时间点。
+ * @return 纳秒数。
+ */
+static inline int64_t toUnixNanos(std::chrono::system_clock::time_point timePoint) noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(timePoint.time_since_epoch())
+        .count();
+}
+
+TomlDateArray::TomlDateArray(const TomlArray& array) {
+    m_entries.reserve(array.size());
+    for (const auto& item : array) {
+        m_entries.emplace_back(item.asDate());
+    }
+}
+
+void TomlDateArray::sort() {
+    std::sort(m_entries.begin(), m_entries.end());
+}
+
+bool TomlDateArray::isSorted() const noexcept {
+    return std::is_sorted(m_entries.begin(), m_entries.end());
+}
+
+size_t TomlDateArray::lowerBound(int64_t nanos) const noexcept {
+    auto it = std::partition_point(m_entries.begin(), m_entries.end(),
+                                   [nanos](const Entry& entry) { return entry.nanos < nanos; });
+    return static_cast<size_t>(it - m_entries.begin());
+}
+
+size_t TomlDateArray::lowerBound(std::chrono::system_clock::time_point timePoint) const noexcept {
+    return lowerBound(toUnixNanos(timePoint));
+}
+
+size_t TomlDateArray::upperBound(int64_t nanos) const noexcept {
+    auto it = std::partition_point(m_entries.begin(), m_entries.end(),
+                                   [nanos](const Entry& entry) { return entry.nanos <= nanos; });
+    return static_cast<size_t>(it - m_entries.begin());
+}
+
+size_t TomlDateArray::upperBound(std::chrono::system_clock::time_point timePoint) const noexcept {
+    return upperBound(toUnixNanos(timePoint));
+}
+
+TomlArray TomlDateArray::toArray() const {
+    TomlArray array;
+    array.reserve(m_entries.size());
+    for (const auto& entry : m_entries) {
+        array.emplace_back(entry.toDate());
+    }
+    return array;
+}
+
+/*———————————————————————————————————TomlValue—————————————————————————————————————————*/
+
+#if defined(CCTOML_USE_PMR)
+namespace {
+thread_local std::pmr::memory_resource* tCurrentResource = nullptr;  ///< TomlResourceScope 设置的资源
+}  // namespace
+
+TomlResourceScope::TomlResourceScope(std::pmr::memory_resource* resource) noexcept
+    : m_previous(tCurrentResource) {
+    tCurrentResource = resource;
+}
+
+TomlResourceScope::~TomlResourceScope() {
+    tCurrentResource = m_previous;
+}
+
+std::pmr::memory_resource* TomlValue::currentResource() noexcept {
+    return tCurrentResource != nullptr ? tCurrentResource : std::pmr::get_default_resource();
+}
+
+std::pmr::memory_resource* TomlValue::resource() const noexcept {
+    switch (m_type) {
+        case TomlType::String: return storageResource(m_value.string);
+        case TomlType::Date: return storageResource(m_value.date);
+        case TomlType::Array: return storageResource(m_value.array);
+        case TomlType::Object:
+            if (m_value.object != nullptr) {
+                return storageResource(m_value.object);
+            }
+            break;
+        default: break;
+    }
+    return currentResource();
+}
+
+TomlValue::TomlValue(std::allocator_arg_t, const allocator_type& alloc, const TomlValue& other)
+    : m_type(other.m_type) {
+    std::pmr::memory_resource* target = alloc.resource();
+    switch (other.m_type) {
+        case TomlType::Boolean: m_value.boolean = other.m_value.boolean; break;
+        case TomlType::Integer: m_value.iNumber = other.m_value.iNumber; break;
+        case TomlType::Double: m_value.dNumber = other.m_value.dNumber; break;
+        case TomlType::String:
+            m_value.string = createStorageIn<TomlString>(target, *other.m_value.string);
+            break;
+        case TomlType::Date:
+            m_value.date = createStorageIn<TomlDate>(target, *other.m_value.date);
+            break;
+        // 元素经 uses-allocator 构造递归回到本构造函数, 整棵树都落在 target 中
+        case TomlType::Array:
+            m_value.array = createStorageIn<TomlArray>(target, *other.m_value.array);
+            break;
+        case TomlType::Object:
+            m_value.object = other.m_value.object != nullptr
+                                 ? createStorageIn<TomlObject>(target, *other.m_value.object)
+                                 : createStorageIn<TomlObject>(target);
+            break;
+    }
+}
+
+TomlValue::TomlValue(std::allocator_arg_t, const allocator_type& alloc, TomlValue&& other)
+    : m_type(other.m_type) {
+    std::pmr::memory_resource* target = alloc.resource();
+    bool                       steal  = true;
+    switch (other.m_type) {
+        case TomlType::String:
+            steal = storageResource(other.m_value.string)->is_equal(*target);
+            break;
+        case TomlType::Date: steal = storageResource(other.m_value.date)->is_equal(*target); break;
+        case TomlType::Array:
+            steal = storageResource(other.m_value.array)->is_equal(*target);
+            break;
+        case TomlType::Object:
+            steal = other.m_value.object == nullptr ||
+                    storageResource(other.m_value.object)->is_equal(*target);
+            break;
+        default: break;
+    }
+    if (steal) {
+        m_value              = other.m_value;
+        other.m_type         = TomlType::Object;
+        other.m_value.object = nullptr;
+        if (m_type == TomlType::Object && m_value.object == nullptr) {
+            m_value.object = createStorageIn<TomlObject>(target);
+        }
+        return;
+    }
+    // 资源不同: 在 target 中逐层移动, other 保留已被移空的容器, 由其析构函数释放
+    switch (m_type) {
+        case TomlType::String:
+            m_value.string = createStorageIn<TomlString>(target, std::move(*other.m_value.string));
+            break;
+        case TomlType::Date:
+            m_value.date = createStorageIn<TomlDate>(target, *other.m_value.date);
+            break;
+        case TomlType::Array:
+            m_value.array = createStorageIn<TomlArray>(target, std::move(*other.m_value.array));
+            break;
+        default:
+            m_value.object = createStorageIn<TomlObject>(target, std::move(*other.m_value.object));
+            break;
+    }
+}
+
+TomlValue::TomlValue(const TomlValue& other)
+    : TomlValue(std::allocator_arg, allocator_type(other.resource()), other) {}
+
+TomlValue::TomlValue(TomlValue&& other) noexcept : m_type(other.m_type) {
+    m_value              = other.m_value;
+    other.m_type         = TomlType::Object;
+    other.m_value.object = nullptr;
+}
+
+TomlValue& TomlValue::operator=(const TomlValue& other) {
+    if (this != &other) {
+        // 目标已有字符串/容器存储时沿用其资源, 否则沿用源值的资源
+        bool      owned = m_type == TomlType::String || m_type == TomlType::Array ||
+                     (m_type == TomlType::Object && m_value.object != nullptr);
+        TomlValue copy(std::allocator_arg, allocator_type(owned ? resource() : other.resource()),
+                       other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+#else
+TomlValue::TomlValue(const TomlValue& other) : m_type(other.m_type) {
+    switch (other.m_type) {
+        case TomlType::Boolean: m_value.boolean = other.m_value.boolean; break;
+        case TomlType::Integer: m_value.iNumber = other.m_value.iNumber; break;
+        case TomlType::Double: m_value.dNumber = other.m_value.dNumber; break;
+        case TomlType::String: m_value.string = new TomlString(*other.m_value.string); break;
+        case TomlType::Date: m_value.date = new TomlDate(*other.m_value.date); break;
+        case TomlType::Array: m_value.array = new TomlArray(*other.m_value.array); break;
+        case TomlType::Object: m_value.object = new TomlObject(*other.m_value.object); break;
+    }
+}
+
+TomlValue::TomlValue(TomlValue&& other) noexcept : m_type(other.m_type) {
+    m_value              = other.m_value;
+    other.m_type         = TomlType::Object;
+    other.m_value.object = nullptr;
+}
+
+TomlValue& TomlValue::operator=(const TomlValue& other) {
+    if (this != &other) {
+        destroyValue();
+        m_type = other.m_type;
+        switch (m_type) {
+            case TomlType::Boolean: m_value.boolean = other.m_value.boolean; break;
+            case TomlType::Integer: m_value.iNumber = other.m_value.iNumber; break;
+            case TomlType::Double: m_value.dNumber = other.m_value.dNumber; break;
+            case TomlType::String: m_value.string = new TomlString(*other.m_value.string); break;
+            case TomlType::Date: m_value.date = new TomlDate(*other.m_value.date); break;
+            case TomlType::Array: m_value.array = new TomlArray(*other.m_value.array); break;
+            case TomlType::Object: m_value.object = new TomlObject(*other.m_value.object); break;
+        }
+    }
     return *this;
 }
+#endif
+
+TomlValue& TomlValue::operator=(TomlValue&& other) noexcept {
+    if (this != &other) {
+        destroyValue();
+        m_type               = other.m_type;
+        m_value              = other.m_value;
+        other.m_type         = TomlType::Object;
+        other.m_value.object = nullptr;
+    }
+    return *this;
+}
+
+TomlValue::~TomlValue() {
+    destroyValue();
+}
+
+TomlValue::operator bool() const {
+    if (!isBoolean()) {
+        throw TomlException("Cannot convert to bool");
+    }
+    return m_value.boolean;
+}
+
+TomlValue::operator int16_t() const {
+    if (!isNumber()) {
+        throw TomlException("Cannot convert to int16_t");
+    }
+    if (m_type == TomlType::Integer) {
+        return static_cast<int16_t>(m_value.iNumber);
+    }
+    return static_cast<int16_t>(m_value.dNumber);
+}
+
+TomlValue::operator int32_t() const {
+    if (!isNumber()) {
+        throw TomlException("Cannot convert to int32_t");
+    }
+    if (m_type == TomlType::Integer) {
+        return static_cast<int32_t>(m_value.iNumber);
+    }
+    return static_cast<int32_t>(m_value.dNumber);
+}
+
+TomlValue::operator int64_t() const {
+    if (!isNumber()) {
+        throw TomlException("Cannot convert to int64_t");
+    }
+    if (m_type == TomlType::Integer) {
+        return m_value.iNumber;
+    }
+    return static_cast<int64_t>(m_value.dNumber);
+}
+
+TomlValue::operator float() const {
+    if (!isNumber()) {
+        throw TomlException("Cannot convert to float");
+    }
+    if (m_type == TomlType::Double) {
+        return static_cast<float>(m_value.dNumber);
+    }
+    return static_cast<float>(m_value.iNumber);
+}
+
+TomlValue::operator double() const {
+    if (!isNumber()) {
+        throw TomlException("Cannot convert to double");
+    }
+    if (m_type == TomlType::Double) {
+        return m_value.dNumber;
+    }
+    return static_cast<double>(m_value.iNumber);
+}
+
+TomlValue::operator std::string() const {
+    if (!isString()) {
+        throw TomlException("Cannot convert to string");
+    }
+    return std::string(*m_value.string);
+}
+
+void TomlValue::destroyValue() noexcept {
+    ++m_version;
+    switch (m_type) {
+        // 动态分配的内存
+        case TomlType::String:
+            destroyStorage(m_value.string);
+            m_value.string = nullptr;
+            break;
+        case TomlType::Date:
+            destroyStorage(m_value.date);
+            m_value.date = nullptr;
+            break;
+        case TomlType::Array:
+        case TomlType::Object: {
+            // 非递归释放: 子数组/子对象先移到显式栈中, 每次 delete 只释放一层,
+            // 避免很深的树在析构时耗尽调用栈
+            std::vector<TomlValue> pending;
+            auto                   detach = [&pending](TomlValue& value) {
+                auto take = [&pending](TomlValue& child) {
+                    if ((child.m_type == TomlType::Array && child.m_value.array != nullptr) ||
+                        (child.m_type == TomlType::Object && child.m_value.object != nullptr)) {
+                        pending.emplace_back(std::move(child));
+                    }
+                };
+                if (value.m_type == TomlType::Array) {
+                    if (value.m_value.array != nullptr) {
+                        for (auto& child : *value.m_value.array) {
+                            take(child);
+                        }
+                        destroyStorage(value.m_value.array);
+                        value.m_value.array = nullptr;
+                    }
+                } else if (value.m_value.object != nullptr) {
+                    for (auto& [_, child] : *value.m_value.object) {
+                        take(child);
+                    }
+                    destroyStorage(value.m_value.object);
+                    value.m_value.object = nullptr;
+                }
+            };
+            detach(*this);
+            while (!pending.empty()) {
+                TomlValue value = std::move(pending.back());
+                pending.pop_back();
+                detach(value);
+            }
+            break;
+        }
+        default: break;
+    }
+}
+
+/*————————————————————————————————————后台释放————————————————————————————————————————*/
+namespace {
+/**
+ * @class TomlReclaimer
+ * @brief 在后台线程中释放 TomlValue 的回收器。
+ *
+ * 线程在第一次 releaseAsync() 时才启动；程序退出时会先释放完所有待回收的值再结束线程。
+ */
+class TomlReclaimer {
+  public:
+    /**
+     * @brief 获取全局回收器。
+     */
+    static TomlReclaimer& instance() {
+        static TomlReclaimer reclaimer;
+        return reclaimer;
+    }
+
+    ~TomlReclaimer() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wakeup.notify_one();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    /**
+     * @brief 将值交给后台线程释放。
+     * @param value 要释放的值。
+     */
+    void push(TomlValue&& value) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_thread.joinable()) {
+                m_thread = std::thread(&TomlReclaimer::run, this);
+            }
+            m_pending.emplace_back(std::move(value));
+        }
+        m_wakeup.notify_one();
+    }
+
+    /**
+     * @brief 阻塞直到所有已提交的值都被释放。
+     */
+    void flush() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this] { return m_pending.empty() && !m_busy; });
+    }
+
+  private:
+    /**
+     * @brief 后台线程主循环：成批取出待释放的值并在锁外析构。
+     */
+    void run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_wakeup.wait(lock, [this] { return m_stop || !m_pending.empty(); });
+            if (m_pending.empty()) {
+                return;
+            }
+            std::vector<TomlValue> batch;
+            batch.swap(m_pending);
+            m_busy = true;
+            lock.unlock();
+            batch.clear();
+            lock.lock();
+            m_busy = false;
+            if (m_pending.empty()) {
+                m_idle.notify_all();
+            }
+        }
+    }
+
+  private:
+    std::mutex              m_mutex;         ///< 保护以下成员
+    std::condition_variable m_wakeup;        ///< 有新的待释放值或需要退出
+    std::condition_variable m_idle;          ///< 所有值都已释放
+    std::vector<TomlValue>  m_pending;       ///< 待释放的值
+    std::thread             m_thread;        ///< 后台线程
+    bool                    m_busy = false;  ///< 后台线程是否正在释放
+    bool                    m_stop = false;  ///< 是否需要退出
+};
+}  // namespace
+
+void TomlValue::releaseAsync() {
+    if (m_type != TomlType::Array && m_type != TomlType::Object) {
+        // 标量的释放代价很小, 直接在当前线程完成
+        destroyValue();
+    } else {
+        TomlReclaimer::instance().push(std::move(*this));
+    }
+    m_type         = TomlType::Object;
+    m_value.object = createStorage<TomlObject>();
+}
+
+void TomlValue::flushReleased() {
+    TomlReclaimer::instance().flush();
+}
+
+/*————————————————————————————————————内存统计————————————————————————————————————————*/
+namespace {
+/**
+ * @brief 先序遍历整棵树；栈帧先放在定长数组中，超过 kInlineDepth 层才溢出到堆上。
+ * @tparam Node TomlValue 或 const TomlValue。
+ * @param root 根节点。
+ * @param visit 对每个节点调用，在访问其子节点之前。
+ */
+template <typename Node, typename Visit>
+void forEachNode(Node& root, Visit&& visit) {
+    constexpr bool kConst = std::is_const_v<Node>;
+    using Array           = std::conditional_t<kConst, const TomlArray, TomlArray>;
+    using Object          = std::conditional_t<kConst, const TomlObject, TomlObject>;
+    using ObjectIterator  = decltype(std::declval<Object&>().begin());
+    struct Frame {
+        Array*         array  = nullptr;  ///< 正在遍历的数组
+        Object*        object = nullptr;  ///< 正在遍历的对象
+        size_t         index  = 0;        ///< 数组的下一个下标
+        ObjectIterator it{};              ///< 对象的下一个成员
+    };
+    constexpr size_t                kInlineDepth = 64;
+    std::array<Frame, kInlineDepth> frames;
+    std::vector<Frame>              spilled;
+    size_t                          depth = 0;
+
+    auto enter = [&](Node& node) {
+        visit(node);
+        if (!node.isArray() && !node.isObject()) {
+            return;
+        }
+        Frame& frame = depth < kInlineDepth ? frames[depth] : spilled.emplace_back();
+        if (node.isArray()) {
+            frame = Frame{&node.asArray(), nullptr, 0, {}};
+        } else {
+            frame = Frame{nullptr, &node.asObject(), 0, node.asObject().begin()};
+        }
+        ++depth;
+    };
+    // 取栈顶容器的下一个子节点, 没有则返回 nullptr
+    auto next = [&]() -> Node* {
+        Frame& frame =
+            depth <= kInlineDepth ? frames[depth - 1] : spilled[depth - 1 - kInlineDepth];
+        if (frame.array != nullptr) {
+            return frame.index < frame.array->size() ? &(*frame.array)[frame.index++] : nullptr;
+        }
+        return frame.it != frame.object->end() ? &(frame.it++)->second : nullptr;
+    };
+    enter(root);
+    while (depth > 0) {
+        if (Node* child = next()) {
+            enter(*child);
+        } else {
+            if (depth > kInlineDepth) {
+                spilled.pop_back();
+            }
+            --depth;
+        }
+    }
+}
+
+/**
+ * @brief 字符串在堆上占用的字节数，短字符串存放在对象内部时为 0。
+ */
+size_t heapStringBytes(const TomlString& string) noexcept {
+    static const size_t inlineCapacity = TomlString().capacity();
+    return string.capacity() > inlineCapacity ? string.capacity() + 1 : 0;
+}
+
+/**
+ * @brief 把单个节点（不含子节点）占用的内存计入统计。
+ */
+void addNodeUsage(const TomlValue& node, TomlMemoryUsage& usage) {
+    // std::map 每个节点额外的红黑树指针与颜色
+    constexpr size_t kMapNodeOverhead = 4 * sizeof(void*);
+    auto             addString        = [&usage](const TomlString& string) {
+        size_t heap = heapStringBytes(string);
+        usage.strings += heap;
+        usage.stringSlack += heap != 0 ? string.capacity() - string.size() : 0;
+    };
+    ++usage.nodeCount;
+    usage.nodes += sizeof(TomlValue);
+    switch (node.type()) {
+        case TomlType::String:
+            usage.strings += sizeof(TomlString);
+            addString(node.asString());
+            break;
+        case TomlType::Date: usage.dates += sizeof(TomlDate); break;
+        case TomlType::Array: {
+            const auto& array = node.asArray();
+            usage.arrays += sizeof(TomlArray);
+            usage.arraySlack += (array.capacity() - array.size()) * sizeof(TomlValue);
+            break;
+        }
+        case TomlType::Object:
+            usage.mapNodes += sizeof(TomlObject);
+            for (const auto& [key, _] : node.asObject()) {
+                usage.mapNodes += kMapNodeOverhead;
+                usage.strings += sizeof(TomlString);
+                addString(key);
+            }
+            break;
+        default: break;
+    }
+}
+}  // namespace
+
+TomlMemoryUsage TomlValue::memoryUsage() const {
+    TomlMemoryUsage usage;
+    forEachNode(*this, [&usage](const TomlValue& node) { addNodeUsage(node, usage); });
+    return usage;
+}
+
+size_t TomlValue::shrinkToFit() {
+    size_t released = 0;
+    forEachNode(*this, [&released](TomlValue& node) {
+        if (node.m_type == TomlType::String) {
+            size_t before = heapStringBytes(*node.m_value.string);
+            node.m_value.string->shrink_to_fit();
+            released += before - heapStringBytes(*node.m_value.string);
+        } else if (node.m_type == TomlType::Array) {
+            auto& array = *node.m_value.array;
+            released += (array.capacity() - array.size()) * sizeof(TomlValue);
+            array.shrink_to_fit();
+        }
+    });
+    return released;
+}
+
+const TomlValue* TomlValue::find(std::string_view key) const noexcept {
+    if (m_type != TomlType::Object) {
+        return nullptr;
+    }
+    auto it = m_value.object->find(key);
+    return it != m_value.object->end() ? &it->second : nullptr;
+}
+
+TomlValue* TomlValue::find(std::string_view key) noexcept {
+    return const_cast<TomlValue*>(static_cast<const TomlValue*>(this)->find(key));
+}
+
+const TomlValue* TomlValue::findPath(std::string_view path) const noexcept {
+    const TomlValue* node     = this;
+    size_t           position = 0;
+    while (node != nullptr && position < path.size()) {
+        if (path[position] == '[') {
+            // 数组下标
+            auto close = path.find(']', position);
+            if (close == std::string_view::npos || !node->isArray()) {
+                return nullptr;
+            }
+            size_t index = 0;
+            auto [ptr, ec] =
+                std::from_chars(path.data() + position + 1, path.data() + close, index);
+            if (ec != std::errc() || ptr != path.data() + close ||
+                index >= node->m_value.array->size()) {
+                return nullptr;
+            }
+            node     = &(*node->m_value.array)[index];
+            position = close + 1;
+        } else {
+            // 键, 直到下一个 . 或 [ (除第一个键外, 前面必须是 .)
+            if (position > 0) {
+                if (path[position] != '.') {
+                    return nullptr;
+                }
+                ++position;
+            }
+            auto end = path.find_first_of(".[", position);
+            if (end == std::string_view::npos) {
+                end = path.size();
+            }
+            if (end == position) {
+                return nullptr;
+            }
+            node     = node->find(path.substr(position, end - position));
+            position = end;
+        }
+    }
+    return node;
+}
+
+TomlValue* TomlValue::findPath(std::string_view path) noexcept {
+    return const_cast<TomlValue*>(static_cast<const TomlValue*>(this)->findPath(path));
+}
+
+size_t TomlValue::lowerBound(std::chrono::system_clock::time_point timePoint) const {
+    const auto&   array = asArray();
+    const int64_t nanos = toUnixNanos(timePoint);
+    auto          it    = std::partition_point(
+        array.begin(), array.end(),
+        [nanos](const TomlValue& item) { return item.asDate().toUnixNanos() < nanos; });
+    return static_cast<size_t>(it - array.begin());
+}
+
+TomlValue& TomlValue::insert(std::string_view key, const TomlValue& value) {
+    if (m_type != TomlType::Object) {
+        destroyValue();
+        m_type         = TomlType::Object;
+        m_value.object = createStorage<TomlObject>();
+    }
+    if (auto it = m_value.object->find(key); it != m_value.object->end()) {
+        it->second = value;
+    } else {
+        m_value.object->emplace(TomlString(key), value);
+    }
+    return *this;
+}
+
+TomlValue& TomlValue::push_back(const TomlValue& value) {
+    if (!isArray()) {
+        destroyValue();
+        m_type        = TomlType::Array;
+        m_value.array = createStorage<TomlArray>();
+    }
+    m_value.array->emplace_back(value);
+    return *this;
+}
+
+/**
+ * @brief 生成 MergeByKey 匹配用的键（类型标记加内容）
+ * @param value 元素中用于匹配的字段，可为 nullptr。
+ * @return 匹配键；字段不存在或不是标量时返回空。
+ */
+static std::optional<std::string> mergeKeyOf(const TomlValue* value) {
+    if (value == nullptr) {
+        return std::nullopt;
+    }
+    switch (value->type()) {
+        case TomlType::String:
+            return 's' + std::string(value->asString());
+        case TomlType::Integer:
+            return 'i' + std::to_string(static_cast<int64_t>(*value));
+        case TomlType::Boolean:
+            return std::string(static_cast<bool>(*value) ? "bt" : "bf");
+        case TomlType::Date:
+            return 'd' + value->asDate().toString();
+        default:
+            return std::nullopt;
+    }
+}
+
+/**
+ * @brief 将覆盖层合并到基础层。
+ * @param base 基础层。
+ * @param overlay 覆盖层（被移动）
+ * @param policy 合并策略。
+ * @param path 当前键路径（用于查找数组规则，递归时临时追加）
+ */
+static void
+mergeValue(TomlValue& base, TomlValue&& overlay, const TomlMergePolicy& policy, std::string& path) {
+    if (base.isObject() && overlay.isObject()) {
+        auto& target = base.asObject();
+        auto& source = overlay.asObject();
+        for (auto it = source.begin(); it != source.end();) {
+            auto next = std::next(it);
+            auto hint = target.lower_bound(it->first);
+            if (hint == target.end() || hint->first != it->first) {
+                // 基础层没有该键, 分配器相同时直接转移整个节点, 否则按值移动
+                // (CCTOML_USE_PMR 下两棵树可能来自不同的内存资源, 节点不能跨分配器转移)
+                if (target.get_allocator() == source.get_allocator()) {
+                    target.insert(hint, source.extract(it));
+                } else {
+                    target.emplace_hint(hint, it->first, std::move(it->second));
+                }
+            } else {
+                const size_t length = path.size();
+                if (!path.empty()) {
+                    path += '.';
+                }
+                path += it->first;
+                mergeValue(hint->second, std::move(it->second), policy, path);
+                path.resize(length);
+            }
+            it = next;
+        }
+        return;
+    }
+    if (base.isArray() && overlay.isArray()) {
+        const auto& rule   = policy.ruleFor(path);
+        auto&       target = base.asArray();
+        auto&       items  = overlay.asArray();
+        if (rule.mode == TomlArrayMerge::Append) {
+            target.reserve(target.size() + items.size());
+            std::move(items.begin(), items.end(), std::back_inserter(target));
+            return;
+        }
+        if (rule.mode == TomlArrayMerge::MergeByKey) {
+            std::unordered_map<std::string, size_t> index;
+            index.reserve(target.size());
+            for (size_t i = 0; i < target.size(); ++i) {
+                if (auto key = mergeKeyOf(target[i].find(rule.key))) {
+                    index.emplace(std::move(*key), i);
+                }
+            }
+            for (auto& item : items) {
+                auto key = mergeKeyOf(item.find(rule.key));
+                auto it  = key ? index.find(*key) : index.end();
+                if (it != index.end()) {
+                    mergeValue(target[it->second], std::move(item), policy, path);
+                } else {
+                    if (key) {
+                        index.emplace(std::move(*key), target.size());
+                    }
+                    target.emplace_back(std::move(item));
+                }
+            }
+            return;
+        }
+    }
+    base = std::move(overlay);
+}
+
+void merge(TomlValue& base, TomlValue&& overlay, const TomlMergePolicy& policy) {
+    std::string path;
+    mergeValue(base, std::move(overlay), policy, path);
+}
+
+void merge(TomlValue& base, const TomlValue& overlay, const TomlMergePolicy& policy) {
+    merge(base, TomlValue(overlay), policy);
+}
+
+TomlOverlayView TomlOverlayView::operator[](std::string_view key) const {
+    TomlOverlayView child;
+    for (auto layer = m_layers.rbegin(); layer != m_layers.rend(); ++layer) {
+        const TomlValue* item = (*layer)->find(key);
+        if (item == nullptr) {
+            continue;
+        }
+        if (!item->isObject()) {
+            // 非表的值遮蔽更低的层, 也不与更高层的表叠加
+            if (child.m_layers.empty()) {
+                child.m_layers.push_back(item);
+            }
+            break;
+        }
+        child.m_layers.push_back(item);
+    }
+    std::reverse(child.m_layers.begin(), child.m_layers.end());
+    return child;
+}
+
+const TomlValue* TomlOverlayView::find(std::string_view key) const noexcept {
+    for (auto layer = m_layers.rbegin(); layer != m_layers.rend(); ++layer) {
+        if (const TomlValue* item = (*layer)->find(key)) {
+            return item;
+        }
+    }
+    return nullptr;
+}
+
+const TomlValue* TomlOverlayView::findPath(std::string_view path) const noexcept {
+    // 从高到低逐层查找, 第一个完整命中的层即为结果
+    for (auto layer = m_layers.rbegin(); layer != m_layers.rend(); ++layer) {
+        const TomlValue* node     = *layer;
+        size_t           position = 0;
+        while (node != nullptr && position < path.size()) {
+            if (path[position] == '[') {
+                // 数组遮蔽更低的层, 下标在本层中解析
+                return node->findPath(path.substr(position));
+            }
+            if (!node->isObject()) {
+                // 非表的值遮蔽更低的层
+                return nullptr;
+            }
+            if (position > 0) {
+                if (path[position] != '.') {
+                    return nullptr;
+                }
+                ++position;
+            }
+            auto end = path.find_first_of(".[", position);
+            if (end == std::string_view::npos) {
+                end = path.size();
+            }
+            if (end == position) {
+                return nullptr;
+            }
+            node     = node->find(path.substr(position, end - position));
+            position = end;
+        }
+        if (node != nullptr) {
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::string_view> TomlOverlayView::keys() const {
+    std::vector<std::string_view> result;
+    if (!isObject()) {
+        return result;
+    }
+    for (const TomlValue* layer : m_layers) {
+        if (layer->isObject()) {
+            for (const auto& [key, item] : layer->asObject()) {
+                result.emplace_back(key);
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+TomlValue TomlOverlayView::materialize(const TomlMergePolicy& policy) const {
+    if (m_layers.empty()) {
+        return {};
+    }
+    TomlValue result = *m_layers.front();
+    for (size_t i = 1; i < m_layers.size(); ++i) {
+        merge(result, *m_layers[i], policy);
+    }
+    return result;
+}
+
+TomlIndexKey::TomlIndexKey(const TomlValue& value) noexcept : m_type(value.type()) {
+    switch (m_type) {
+        case TomlType::Boolean: m_value.boolean = static_cast<bool>(value); break;
+        case TomlType::Integer: m_value.iNumber = static_cast<int64_t>(value); break;
+        case TomlType::Double: m_value.dNumber = static_cast<double>(value); break;
+        case TomlType::String: m_string = value.asString(); break;
+        case TomlType::Date: m_value.date = &value.asDate(); break;
+        default: break;
+    }
+}
+
+size_t TomlIndexKey::hash() const noexcept {
+    size_t hash = 0;
+    switch (m_type) {
+        case TomlType::Boolean: hash = m_value.boolean; break;
+        case TomlType::Integer: hash = std::hash<int64_t>()(m_value.iNumber); break;
+        case TomlType::Double:
+            // 所有 NaN 彼此相等, 哈希值也需相同
+            hash = std::isnan(m_value.dNumber) ? ~size_t(0) : std::hash<double>()(m_value.dNumber);
+            break;
+        case TomlType::String: hash = std::hash<std::string_view>()(m_string); break;
+        case TomlType::Date: hash = std::hash<int64_t>()(m_value.date->toUnixNanos()); break;
+        default: break;
+    }
+    return hash ^ (static_cast<size_t>(m_type) * 0x9E3779B97F4A7C15ull);
+}
+
+int TomlIndexKey::compare(const TomlValue* value) const noexcept {
+    return value == nullptr ? 1 : compare(TomlIndexKey(*value));
+}
+
+int TomlIndexKey::compare(const TomlIndexKey& other) const noexcept {
+    if (m_type != other.m_type) {
+        return m_type < other.m_type ? -1 : 1;
+    }
+    switch (m_type) {
+        case TomlType::Boolean: return int(m_value.boolean) - int(other.m_value.boolean);
+        case TomlType::Integer:
+            return (m_value.iNumber > other.m_value.iNumber) -
+                   (m_value.iNumber < other.m_value.iNumber);
+        case TomlType::Double: {
+            // NaN 与任何数都不可比, 排在所有浮点数之后并彼此相等, 以保持严格弱序
+            const bool lhsNan = std::isnan(m_value.dNumber);
+            const bool rhsNan = std::isnan(other.m_value.dNumber);
+            if (lhsNan || rhsNan) {
+                return int(lhsNan) - int(rhsNan);
+            }
+            return (m_value.dNumber > other.m_value.dNumber) -
+                   (m_value.dNumber < other.m_value.dNumber);
+        }
+        case TomlType::String: return m_string.compare(other.m_string);
+        case TomlType::Date:
+            return *m_value.date < *other.m_value.date ? -1 : (*other.m_value.date < *m_value.date);
+        default:
+            // 数组和表不参与比较, 视为不相等
+            return 1;
+    }
+}
+
+TomlArrayIndex::TomlArrayIndex(const TomlValue& array, std::vector<std::string> fields, Kind kind)
+    : m_source(&array), m_fields(std::move(fields)), m_kind(kind) {
+    if (m_fields.empty()) {
+        throw TomlException("Index requires at least one field");
+    }
+    rebuild();
+}
+
+bool TomlArrayIndex::valid() const noexcept {
+    return m_source->isArray() && &m_source->asArray() == m_array &&
+           m_source->version() == m_version && m_array->data() == m_elements &&
+           m_array->size() * m_fields.size() == m_keys.size();
+}
+
+void TomlArrayIndex::rebuild() {
+    const auto& array = m_source->asArray();
+    if (array.size() >= EMPTY_SLOT) {
+        throw TomlException("Array too large to index");
+    }
+    m_array    = &array;
+    m_elements = array.data();
+    m_version  = m_source->version();
+
+    // 收集各元素的字段值, 缺少字段的元素不参与索引
+    const size_t                  fieldCount = m_fields.size();
+    std::vector<const TomlValue*> values(array.size() * fieldCount);
+    size_t                        chars = 0, dates = 0;
+    m_order.clear();
+    m_order.reserve(array.size());
+    for (uint32_t i = 0; i < array.size(); ++i) {
+        bool complete = array[i].isObject();
+        for (size_t f = 0; f < fieldCount && complete; ++f) {
+            const TomlValue* value        = array[i].findPath(m_fields[f]);
+            values[i * fieldCount + f] = value;
+            complete                      = value != nullptr;
+        }
+        if (!complete) {
+            continue;
+        }
+        m_order.push_back(i);
+        for (size_t f = 0; f < fieldCount; ++f) {
+            const TomlValue* value = values[i * fieldCount + f];
+            chars += value->isString() ? value->asString().size() : 0;
+            dates += value->isDate();
+        }
+    }
+
+    // 复制字段值: 预留好空间后字符串与日期不再移动, 键可以直接引用它们
+    m_keys.assign(values.size(), TomlIndexKey(false));
+    m_strings.clear();
+    m_strings.reserve(chars);
+    m_dates.clear();
+    m_dates.reserve(dates);
+    for (uint32_t element : m_order) {
+        for (size_t f = 0; f < fieldCount; ++f) {
+            const TomlValue& value = *values[element * fieldCount + f];
+            TomlIndexKey&    key   = m_keys[element * fieldCount + f];
+            if (value.isString()) {
+                const auto& string = value.asString();
+                key = std::string_view(m_strings.data() + m_strings.size(), string.size());
+                m_strings.insert(m_strings.end(), string.begin(), string.end());
+            } else if (value.isDate()) {
+                key = m_dates.emplace_back(value.asDate());
+            } else {
+                key = TomlIndexKey(value);
+            }
+        }
+    }
+
+    m_slots.clear();
+    if (m_kind == Kind::Sorted) {
+        auto less = [this, fieldCount](uint32_t a, uint32_t b) {
+            for (size_t f = 0; f < fieldCount; ++f) {
+                if (int order = keyOf(a, f).compare(keyOf(b, f))) {
+                    return order < 0;
+                }
+            }
+            return false;
+        };
+        std::stable_sort(m_order.begin(), m_order.end(), less);
+        return;
+    }
+
+    // 线性探测的开放寻址表, 负载因子不超过 0.5; 同键元素按数组顺序排在探测序列上
+    size_t capacity = 16;
+    while (capacity < m_order.size() * 2) {
+        capacity <<= 1;
+    }
+    m_slots.assign(capacity, Slot{0, EMPTY_SLOT});
+    for (uint32_t element : m_order) {
+        const size_t hash = hashKeys(&keyOf(element, 0), fieldCount);
+        size_t       slot = hash & (capacity - 1);
+        while (m_slots[slot].element != EMPTY_SLOT) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        m_slots[slot] = {hash, element};
+    }
+}
+
+void TomlArrayIndex::check(size_t count) const {
+    if (!valid()) {
+        throw TomlException("Index is stale, the array has been modified");
+    }
+    if (count != m_fields.size()) {
+        throw TomlException("Key count does not match index fields");
+    }
+}
+
+bool TomlArrayIndex::matches(uint32_t element, const TomlIndexKey* keys) const noexcept {
+    for (size_t f = 0; f < m_fields.size(); ++f) {
+        if (keys[f].compare(keyOf(element, f)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int TomlArrayIndex::compare(const TomlIndexKey* keys,
+                            size_t              count,
+                            uint32_t            element) const noexcept {
+    for (size_t f = 0; f < count; ++f) {
+        if (int order = keys[f].compare(keyOf(element, f))) {
+            return order;
+        }
+    }
+    return 0;
+}
+
+size_t TomlArrayIndex::hashKeys(const TomlIndexKey* keys, size_t count) noexcept {
+    size_t hash = 0;
+    for (size_t f = 0; f < count; ++f) {
+        hash ^= keys[f].hash() + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+const TomlValue* TomlArrayIndex::find(const TomlIndexKey* keys, size_t count) const {
+    check(count);
+    const auto& array = *m_array;
+    if (m_kind == Kind::Sorted) {
+        auto it = std::partition_point(m_order.begin(), m_order.end(), [&](uint32_t element) {
+            return compare(keys, count, element) > 0;
+        });
+        return it != m_order.end() && compare(keys, count, *it) == 0 ? &array[*it] : nullptr;
+    }
+    const size_t hash = hashKeys(keys, count);
+    const size_t mask = m_slots.size() - 1;
+    for (size_t slot = hash & mask; m_slots[slot].element != EMPTY_SLOT; slot = (slot + 1) & mask) {
+        if (m_slots[slot].hash == hash && matches(m_slots[slot].element, keys)) {
+            return &array[m_slots[slot].element];
+        }
+    }
+    return nullptr;
+}
+
+std::pair<const uint32_t*, const uint32_t*>
+TomlArrayIndex::equalRange(const TomlIndexKey* keys, size_t count) const noexcept {
+    const uint32_t* begin = m_order.data();
+    const uint32_t* end   = begin + m_order.size();
+    const uint32_t* first = std::partition_point(
+        begin, end, [&](uint32_t element) { return compare(keys, count, element) > 0; });
+    const uint32_t* last = std::partition_point(
+        first, end, [&](uint32_t element) { return compare(keys, count, element) == 0; });
+    return {first, last};
+}
+
+std::vector<const TomlValue*>
+TomlArrayIndex::findAll(std::initializer_list<TomlIndexKey> keys) const {
+    std::vector<const TomlValue*> result;
+    forEachMatch(keys.begin(), keys.size(), [&result](const TomlValue& element) {
+        result.push_back(&element);
+        return true;
+    });
+    return result;
+}
+
+std::vector<const TomlValue*> TomlArrayIndex::range(const TomlIndexKey& low,
+                                                    const TomlIndexKey& high) const {
+    if (m_kind != Kind::Sorted) {
+        throw TomlException("Range query requires a sorted index");
+    }
+    if (!valid()) {
+        throw TomlException("Index is stale, the array has been modified");
+    }
+    auto bound = [this](const TomlIndexKey& key) {
+        return std::partition_point(m_order.begin(), m_order.end(), [this, &key](uint32_t element) {
+            return key.compare(keyOf(element, 0)) > 0;
+        });
+    };
+    std::vector<const TomlValue*> result;
+    for (auto first = bound(low), last = bound(high); first < last; ++first) {
+        result.push_back(&(*m_array)[*first]);
+    }
+    return result;
+}
+
+const TomlArrayIndex& TomlIndexCache::get(const TomlValue&                array,
+                                          const std::vector<std::string>& fields,
+                                          TomlArrayIndex::Kind            kind) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // 以引用组成的元组查找, 命中时不复制字段列表
+    auto it = m_indexes.find(
+        std::tuple<const TomlValue*, const std::vector<std::string>&, TomlArrayIndex::Kind>(
+            &array, fields, kind));
+    if (it == m_indexes.end()) {
+        auto index = std::make_unique<TomlArrayIndex>(array, fields, kind);
+        it         = m_indexes.emplace(Key(&array, fields, kind), std::move(index)).first;
+    } else if (!it->second->valid()) {
+        it->second->rebuild();
+    }
+    return *it->second;
+}
+
+void TomlIndexCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_indexes.clear();
+}
+
+/**
+ * @brief 编译后的查询计划：步骤序列加过滤表达式表。
+ */
+struct TomlQuery::Plan {
+    using Visitor = std::function<bool(const TomlValue&)>;
+
+    /**
+     * @brief 过滤表达式中 @ 之后路径的一段。
+     */
+    struct Segment {
+        std::string key;      ///< 键名。
+        int64_t     index;    ///< 数组下标（isIndex 时有效）
+        bool        isIndex;  ///< 是否为数组下标。
+    };
+
+    /**
+     * @brief 过滤表达式运算符。
+     */
+    enum class Op { Exists, Eq, Ne, Lt, Le, Gt, Ge, And, Or, Not };
+
+    /**
+     * @brief 比较运算的操作数：@ 路径或字面量。
+     */
+    struct Operand {
+        std::vector<Segment> path;            ///< @ 之后的路径。
+        TomlValue            literal;         ///< 字面量。
+        bool                 isPath = false;  ///< 是否为路径。
+    };
+
+    /**
+     * @brief 过滤表达式节点。
+     */
+    struct Expr {
+        explicit Expr(Op op) : op(op) {}
+
+        Op                       op;
+        Operand                  left, right;       ///< 比较运算的操作数。
+        size_t                   lhs = 0;           ///< And/Or/Not 的子表达式。
+        size_t                   rhs = 0;           ///< And/Or 的子表达式。
+        std::vector<std::string> indexFields;       ///< 可使用索引时的字段路径（@.a.b == '字符串'）
+        size_t                   indexLiteral = 0;  ///< 可使用索引时字面量所在的操作数（0 左，1 右）
+    };
+
+    /**
+     * @brief 查询步骤类型。
+     */
+    enum class Kind { Key, Wildcard, Index, Slice, Filter };
+
+    /**
+     * @brief 查询步骤。
+     */
+    struct Step {
+        Step(Kind kind, bool recursive = false) : kind(kind), recursive(recursive) {}
+
+        Kind                     kind;
+        bool                     recursive = false;  ///< 是否递归下降。
+        std::vector<std::string> keys;               ///< Key：键名。
+        std::vector<int64_t>     indexes;            ///< Index：下标。
+        std::optional<int64_t>   start, end;         ///< Slice：起止下标。
+        size_t                   filter = 0;         ///< Filter：表达式根节点。
+    };
+
+    std::vector<Step> steps;  ///< 步骤序列。
+    std::vector<Expr> exprs;  ///< 过滤表达式节点。
+
+    /*———————————————————————————————————— 编译 ————————————————————————————————————*/
+
+    /**
+     * @brief 编译查询表达式。
+     */
+    static std::shared_ptr<const Plan> compile(std::string_view text) {
+        auto   plan     = std::make_shared<Plan>();
+        size_t position = 0;
+        skipSpaces(text, position);
+        if (position < text.size() && text[position] == '$') {
+            ++position;
+        } else if (position < text.size() && text[position] != '.' && text[position] != '[') {
+            // 省略 $ 时允许直接以键名开头
+            plan->steps.push_back(Step(Kind::Key));
+            plan->steps.back().keys.push_back(parseName(text, position));
+        }
+        while (position < text.size() && !isSpace(text[position])) {
+            bool recursive = false;
+            if (text[position] == '.') {
+                ++position;
+                if (position < text.size() && text[position] == '.') {
+                    recursive = true;
+                    ++position;
+                }
+                if (position < text.size() && text[position] == '[' && recursive) {
+                    plan->parseBracket(text, position, true);
+                } else if (position < text.size() && text[position] == '*') {
+                    ++position;
+                    plan->steps.push_back(Step(Kind::Wildcard, recursive));
+                } else {
+                    plan->steps.push_back(Step(Kind::Key, recursive));
+                    plan->steps.back().keys.push_back(parseName(text, position));
+                }
+            } else if (text[position] == '[') {
+                plan->parseBracket(text, position, false);
+            } else {
+                throw TomlParseException("Unexpected character in query", position);
+            }
+        }
+        skipSpaces(text, position);
+        if (position != text.size()) {
+            throw TomlParseException("Unexpected character in query", position);
+        }
+        return plan;
+    }
+
+    static bool isSpace(char c) noexcept {
+        return c == ' ' || c == '\t';
+    }
+
+    static void skipSpaces(std::string_view text, size_t& position) noexcept {
+        while (position < text.size() && isSpace(text[position])) {
+            ++position;
+        }
+    }
+
+    static void expect(std::string_view text, size_t& position, char c) {
+        skipSpaces(text, position);
+        if (position >= text.size() || text[position] != c) {
+            throw TomlParseException(std::string("Expected '") + c + "' in query", position);
+        }
+        ++position;
+    }
+
+    /**
+     * @brief 解析裸键名（A-Za-z0-9_-）
+     */
+    static std::string parseName(std::string_view text, size_t& position) {
+        const size_t start = position;
+        while (position < text.size() &&
+               (std::isalnum(static_cast<unsigned char>(text[position])) || text[position] == '_' ||
+                text[position] == '-')) {
+            ++position;
+        }
+        if (position == start) {
+            throw TomlParseException("Expected key in query", position);
+        }
+        return std::string(text.substr(start, position - start));
+    }
+
+    /**
+     * @brief 解析单引号或双引号字符串，支持 \ 转义引号与反斜杠。
+     */
+    static std::string parseQuoted(std::string_view text, size_t& position) {
+        const char  quote = text[position++];
+        std::string result;
+        while (position < text.size() && text[position] != quote) {
+            if (text[position] == '\\' && position + 1 < text.size()) {
+                ++position;
+            }
+            result += text[position++];
+        }
+        if (position >= text.size()) {
+            throw TomlParseException("Unterminated string in query", position);
+        }
+        ++position;
+        return result;
+    }
+
+    /**
+     * @brief 解析整数（可带负号）
+     */
+    static int64_t parseInteger(std::string_view text, size_t& position) {
+        int64_t value = 0;
+        auto [ptr, ec] = std::from_chars(text.data() + position, text.data() + text.size(), value);
+        if (ec != std::errc()) {
+            throw TomlParseException("Expected integer in query", position);
+        }
+        position = ptr - text.data();
+        return value;
+    }
+
+    /**
+     * @brief 解析 [...] 选择器。
+     */
+    void parseBracket(std::string_view text, size_t& position, bool recursive) {
+        ++position;
+        skipSpaces(text, position);
+        if (position >= text.size()) {
+            throw TomlParseException("Unterminated '[' in query", position);
+        }
+        Step step{Kind::Key, recursive};
+        const char c = text[position];
+        if (c == '*') {
+            ++position;
+            step.kind = Kind::Wildcard;
+        } else if (c == '?') {
+            ++position;
+            step.kind   = Kind::Filter;
+            step.filter = parseOr(text, position);
+        } else if (c == '\'' || c == '"') {
+            step.kind = Kind::Key;
+            step.keys.push_back(parseQuoted(text, position));
+            for (skipSpaces(text, position); position < text.size() && text[position] == ',';
+                 skipSpaces(text, position)) {
+                ++position;
+                skipSpaces(text, position);
+                if (position >= text.size() || (text[position] != '\'' && text[position] != '"')) {
+                    throw TomlParseException("Expected quoted key in query", position);
+                }
+                step.keys.push_back(parseQuoted(text, position));
+            }
+        } else {
+            if (c != ':') {
+                step.start = parseInteger(text, position);
+            }
+            skipSpaces(text, position);
+            if (position < text.size() && text[position] == ':') {
+                ++position;
+                skipSpaces(text, position);
+                step.kind = Kind::Slice;
+                if (position < text.size() && text[position] != ']') {
+                    step.end = parseInteger(text, position);
+                }
+            } else {
+                step.kind = Kind::Index;
+                step.indexes.push_back(*step.start);
+                while (position < text.size() && text[position] == ',') {
+                    ++position;
+                    skipSpaces(text, position);
+                    step.indexes.push_back(parseInteger(text, position));
+                    skipSpaces(text, position);
+                }
+            }
+        }
+        expect(text, position, ']');
+        steps.push_back(std::move(step));
+    }
+
+    size_t addExpr(Expr expr) {
+        exprs.push_back(std::move(expr));
+        return exprs.size() - 1;
+    }
+
+    size_t parseOr(std::string_view text, size_t& position) {
+        size_t left = parseAnd(text, position);
+        skipSpaces(text, position);
+        while (text.substr(position, 2) == "||") {
+            position += 2;
+            Expr expr(Op::Or);
+            expr.lhs = left;
+            expr.rhs = parseAnd(text, position);
+            left     = addExpr(std::move(expr));
+            skipSpaces(text, position);
+        }
+        return left;
+    }
+
+    size_t parseAnd(std::string_view text, size_t& position) {
+        size_t left = parseUnary(text, position);
+        skipSpaces(text, position);
+        while (text.substr(position, 2) == "&&") {
+            position += 2;
+            Expr expr(Op::And);
+            expr.lhs = left;
+            expr.rhs = parseUnary(text, position);
+            left     = addExpr(std::move(expr));
+            skipSpaces(text, position);
+        }
+        return left;
+    }
+
+    size_t parseUnary(std::string_view text, size_t& position) {
+        skipSpaces(text, position);
+        if (position < text.size() && text[position] == '!' && text.substr(position, 2) != "!=") {
+            ++position;
+            Expr expr(Op::Not);
+            expr.lhs = parseUnary(text, position);
+            return addExpr(std::move(expr));
+        }
+        if (position < text.size() && text[position] == '(') {
+            ++position;
+            size_t inner = parseOr(text, position);
+            expect(text, position, ')');
+            return inner;
+        }
+        return parseComparison(text, position);
+    }
+
+    size_t parseComparison(std::string_view text, size_t& position) {
+        Expr expr(Op::Exists);
+        expr.left = parseOperand(text, position);
+        skipSpaces(text, position);
+        static constexpr std::pair<std::string_view, Op> operators[] = {
+            {"==", Op::Eq}, {"!=", Op::Ne}, {"<=", Op::Le},
+            {">=", Op::Ge}, {"<", Op::Lt},  {">", Op::Gt}};
+        for (const auto& [token, op] : operators) {
+            if (text.substr(position, token.size()) == token) {
+                position += token.size();
+                expr.op    = op;
+                expr.right = parseOperand(text, position);
+                break;
+            }
+        }
+        if (expr.op == Op::Exists && !expr.left.isPath) {
+            throw TomlParseException("Expected comparison in query filter", position);
+        }
+        if (expr.op == Op::Eq && expr.left.isPath != expr.right.isPath) {
+            // @.a.b == '字符串' 或 true/false 可以使用哈希索引
+            const Operand& path    = expr.left.isPath ? expr.left : expr.right;
+            const Operand& literal = expr.left.isPath ? expr.right : expr.left;
+            const bool     keyed   = literal.literal.isString() || literal.literal.isBoolean();
+            bool           plain   = keyed && !path.path.empty();
+            for (const auto& segment : path.path) {
+                plain = plain && !segment.isIndex &&
+                        segment.key.find_first_of(".[") == std::string::npos;
+            }
+            if (plain) {
+                // 预先组成索引缓存的字段列表, 求值时直接用作缓存键
+                std::string field;
+                for (const auto& segment : path.path) {
+                    field += (field.empty() ? "" : ".") + segment.key;
+                }
+                expr.indexFields.push_back(std::move(field));
+                expr.indexLiteral = expr.left.isPath ? 1 : 0;
+            }
+        }
+        return addExpr(std::move(expr));
+    }
+
+    static Operand parseOperand(std::string_view text, size_t& position) {
+        skipSpaces(text, position);
+        if (position >= text.size()) {
+            throw TomlParseException("Expected operand in query filter", position);
+        }
+        Operand operand;
+        const char c = text[position];
+        if (c == '@') {
+            ++position;
+            operand.isPath = true;
+            while (position < text.size()) {
+                if (text[position] == '.') {
+                    ++position;
+                    operand.path.push_back({parseName(text, position), 0, false});
+                } else if (text[position] == '[') {
+                    ++position;
+                    skipSpaces(text, position);
+                    const bool quoted = position < text.size() &&
+                                        (text[position] == '\'' || text[position] == '"');
+                    if (quoted) {
+                        operand.path.push_back({parseQuoted(text, position), 0, false});
+                    } else {
+                        operand.path.push_back({{}, parseInteger(text, position), true});
+                    }
+                    expect(text, position, ']');
+                } else {
+                    break;
+                }
+            }
+        } else if (c == '\'' || c == '"') {
+            operand.literal = TomlValue(parseQuoted(text, position));
+        } else if (text.substr(position, 4) == "true") {
+            position += 4;
+            operand.literal = TomlValue(true);
+        } else if (text.substr(position, 5) == "false") {
+            position += 5;
+            operand.literal = TomlValue(false);
+        } else {
+            TomlDate date;
+            if (TomlDate::lex(text, position, date)) {
+                operand.literal = TomlValue(date);
+                return operand;
+            }
+            const size_t start = position;
+            while (position < text.size() &&
+                   (std::isalnum(static_cast<unsigned char>(text[position])) ||
+                    text[position] == '.' || text[position] == '-' || text[position] == '+')) {
+                ++position;
+            }
+            const std::string_view number = text.substr(start, position - start);
+            int64_t                integer = 0;
+            double                 real    = 0;
+            if (number.empty()) {
+                throw TomlParseException("Expected operand in query filter", start);
+            }
+            if (std::from_chars(number.data(), number.data() + number.size(), integer).ptr ==
+                number.data() + number.size()) {
+                operand.literal = TomlValue(integer);
+            } else if (std::from_chars(number.data(), number.data() + number.size(), real).ptr ==
+                           number.data() + number.size()) {
+                operand.literal = TomlValue(real);
+            } else {
+                throw TomlParseException("Invalid literal in query filter", start);
+            }
+        }
+        return operand;
+    }
+
+    /*———————————————————————————————————— 求值 ————————————————————————————————————*/
+
+    /**
+     * @brief 解析操作数对应的值。
+     */
+    static const TomlValue* resolve(const Operand& operand, const TomlValue& node) noexcept {
+        if (!operand.isPath) {
+            return &operand.literal;
+        }
+        const TomlValue* value = &node;
+        for (const auto& segment : operand.path) {
+            if (!segment.isIndex) {
+                value = value->find(segment.key);
+            } else if (value->isArray()) {
+                const auto&   array = value->asArray();
+                const int64_t index =
+                    segment.index < 0 ? segment.index + int64_t(array.size()) : segment.index;
+                value = index >= 0 && index < int64_t(array.size()) ? &array[index] : nullptr;
+            } else {
+                value = nullptr;
+            }
+            if (value == nullptr) {
+                return nullptr;
+            }
+        }
+        return value;
+    }
+
+    /**
+     * @brief 比较两个值：数字按数值、字符串按字典序、日期按时间；不可比较时返回 nullopt。
+     */
+    static std::optional<int> compareValues(const TomlValue& a, const TomlValue& b) noexcept {
+        if (a.type() == TomlType::Integer && b.type() == TomlType::Integer) {
+            const auto x = static_cast<int64_t>(a), y = static_cast<int64_t>(b);
+            return (x > y) - (x < y);
+        }
+        if (a.isNumber() && b.isNumber()) {
+            const auto x = static_cast<double>(a), y = static_cast<double>(b);
+            if (std::isnan(x) || std::isnan(y)) {
+                return std::nullopt;
+            }
+            return (x > y) - (x < y);
+        }
+        if (a.type() != b.type()) {
+            return std::nullopt;
+        }
+        switch (a.type()) {
+            case TomlType::Boolean: return int(static_cast<bool>(a)) - int(static_cast<bool>(b));
+            case TomlType::String: {
+                const int order = a.asString().compare(b.asString());
+                return (order > 0) - (order < 0);
+            }
+            case TomlType::Date:
+                return a.asDate() < b.asDate() ? -1 : int(b.asDate() < a.asDate());
+            default: return std::nullopt;
+        }
+    }
+
+    bool test(size_t index, const TomlValue& node) const noexcept {
+        const Expr& expr = exprs[index];
+        switch (expr.op) {
+            case Op::And: return test(expr.lhs, node) && test(expr.rhs, node);
+            case Op::Or: return test(expr.lhs, node) || test(expr.rhs, node);
+            case Op::Not: return !test(expr.lhs, node);
+            case Op::Exists: return resolve(expr.left, node) != nullptr;
+            default: break;
+        }
+        const TomlValue* left  = resolve(expr.left, node);
+        const TomlValue* right = resolve(expr.right, node);
+        if (left == nullptr || right == nullptr) {
+            return false;
+        }
+        const auto order = compareValues(*left, *right);
+        if (!order) {
+            return expr.op == Op::Ne;
+        }
+        switch (expr.op) {
+            case Op::Eq: return *order == 0;
+            case Op::Ne: return *order != 0;
+            case Op::Lt: return *order < 0;
+            case Op::Le: return *order <= 0;
+            case Op::Gt: return *order > 0;
+            case Op::Ge: return *order >= 0;
+            default: return false;
+        }
+    }
+
+    /**
+     * @brief 从第 index 步开始对 node 求值。
+     * @return false 表示访问者要求停止。
+     */
+    bool visit(size_t           index,
+               const TomlValue& node,
+               const Visitor&   visitor,
+               TomlIndexCache*  cache) const {
+        if (index == steps.size()) {
+            return visitor(node);
+        }
+        const Step& step = steps[index];
+        if (!select(index, node, visitor, cache)) {
+            return false;
+        }
+        if (step.recursive) {
+            if (node.isObject()) {
+                for (const auto& [key, child] : node.asObject()) {
+                    if (!visit(index, child, visitor, cache)) {
+                        return false;
+                    }
+                }
+            } else if (node.isArray()) {
+                for (const auto& child : node.asArray()) {
+                    if (!visit(index, child, visitor, cache)) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 对 node 应用第 index 步的选择器，并继续求值选中的子节点。
+     */
+    bool select(size_t           index,
+                const TomlValue& node,
+                const Visitor&   visitor,
+                TomlIndexCache*  cache) const {
+        const Step& step = steps[index];
+        switch (step.kind) {
+            case Kind::Key:
+                for (const auto& key : step.keys) {
+                    const TomlValue* child = node.find(key);
+                    if (child != nullptr && !visit(index + 1, *child, visitor, cache)) {
+                        return false;
+                    }
+                }
+                return true;
+            case Kind::Index:
+            case Kind::Slice: {
+                if (!node.isArray()) {
+                    return true;
+                }
+                const auto&   array  = node.asArray();
+                const int64_t size   = array.size();
+                auto          normal = [size](int64_t i) { return i < 0 ? i + size : i; };
+                if (step.kind == Kind::Index) {
+                    for (int64_t i : step.indexes) {
+                        i = normal(i);
+                        if (i >= 0 && i < size && !visit(index + 1, array[i], visitor, cache)) {
+                            return false;
+                        }
+                    }
+                    return true;
+                }
+                const int64_t first = std::clamp<int64_t>(normal(step.start.value_or(0)), 0, size);
+                const int64_t last  = std::clamp<int64_t>(normal(step.end.value_or(size)), 0, size);
+                for (int64_t i = first; i < last; ++i) {
+                    if (!visit(index + 1, array[i], visitor, cache)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case Kind::Filter: {
+                const Expr& expr = exprs[step.filter];
+                if (cache != nullptr && node.isArray() && !expr.indexFields.empty()) {
+                    // 每个数组只取一次索引, 逐个访问命中的元素
+                    const auto& literal = (expr.indexLiteral == 0 ? expr.left : expr.right).literal;
+                    const TomlIndexKey key(literal);
+                    return cache->get(node, expr.indexFields)
+                        .forEachMatch(&key, 1, [&](const TomlValue& child) {
+                            return visit(index + 1, child, visitor, cache);
+                        });
+                }
+                [[fallthrough]];
+            }
+            case Kind::Wildcard:
+                if (node.isObject()) {
+                    for (const auto& [key, child] : node.asObject()) {
+                        if ((step.kind == Kind::Wildcard || test(step.filter, child)) &&
+                            !visit(index + 1, child, visitor, cache)) {
+                            return false;
+                        }
+                    }
+                } else if (node.isArray()) {
+                    for (const auto& child : node.asArray()) {
+                        if ((step.kind == Kind::Wildcard || test(step.filter, child)) &&
+                            !visit(index + 1, child, visitor, cache)) {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+        }
+        return true;
+    }
+};
+
+TomlQuery::TomlQuery(std::string_view expression) : m_plan(Plan::compile(expression)) {}
+
+std::vector<const TomlValue*> TomlQuery::select(const TomlValue& root,
+                                                TomlIndexCache*  cache) const {
+    std::vector<const TomlValue*> result;
+    forEach(
+        root,
+        [&result](const TomlValue& value) {
+            result.push_back(&value);
+            return true;
+        },
+        cache);
+    return result;
+}
+
+const TomlValue* TomlQuery::first(const TomlValue& root, TomlIndexCache* cache) const {
+    const TomlValue* result = nullptr;
+    forEach(
+        root,
+        [&result](const TomlValue& value) {
+            result = &value;
+            return false;
+        },
+        cache);
+    return result;
+}
+
+void TomlQuery::forEach(const TomlValue&                              root,
+                        const std::function<bool(const TomlValue&)>& visitor,
+                        TomlIndexCache*                               cache) const {
+    m_plan->visit(0, root, visitor, cache);
+}
+
+
+/**
+ * @brief 64 位内容哈希（按 8 字节分块的乘法-移位混合，风格同 xxHash）
+ * @param data 内容。
+ * @return 哈希值。
+ */
+static uint64_t hashContent(std::string_view data) noexcept {
+    constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+    uint64_t           hash    = data.size() * kPrime1;
+    size_t             i       = 0;
+    for (; i + 8 <= data.size(); i += 8) {
+        uint64_t lane = loadLittleEndian64(data.data() + i) * kPrime2;
+        lane          = (lane << 31) | (lane >> 33);
+        hash ^= lane * kPrime1;
+        hash = ((hash << 27) | (hash >> 37)) * kPrime1 + kPrime2;
+    }
+    for (; i < data.size(); ++i) {
+        hash ^= static_cast<unsigned char>(data[i]) * kPrime1;
+        hash = ((hash << 11) | (hash >> 53)) * kPrime2;
+    }
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    return hash;
+}
+
+/**
+ * @brief 文件标识：设备号、inode、修改时间和大小，任一变化即视为文件已变化。
+ */
+struct FileIdentity {
+    uint64_t device = 0;
+    uint64_t inode  = 0;
+    int64_t  mtime  = 0;  ///< 修改时间（纳秒）
+    uint64_t size   = 0;
+
+    bool operator==(const FileIdentity& other) const noexcept {
+        return device == other.device && inode == other.inode && mtime == other.mtime &&
+               size == other.size;
+    }
+};
+
+/**
+ * @brief 获取文件标识。
+ * @param path 文件路径。
+ * @param identity 输出的文件标识。
+ * @return 文件存在且可访问时返回 true。
+ */
+static bool statFile(const std::string& path, FileIdentity& identity) noexcept {
+#if defined(CCTOML_HAVE_POSIX_STAT)
+    struct stat info {};
+    if (::stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+        return false;
+    }
+    identity.device = static_cast<uint64_t>(info.st_dev);
+    identity.inode  = static_cast<uint64_t>(info.st_ino);
+#    if defined(__APPLE__)
+    identity.mtime = int64_t(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#    else
+    identity.mtime = int64_t(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#    endif
+    identity.size = static_cast<uint64_t>(info.st_size);
+    return true;
+#else
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) {
+        return false;
+    }
+    identity.size  = std::filesystem::file_size(path, error);
+    identity.mtime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+    return !error;
+#endif
+}
+
+/**
+ * @brief TomlCache 的内部状态。
+ */
+struct TomlCache::State {
+    /**
+     * @brief 缓存条目。
+     */
+    struct Entry {
+        Document                         document;         ///< 已解析的文档。
+        FileIdentity                     identity;         ///< 解析时的文件标识。
+        uint64_t                         hash    = 0;      ///< 内容哈希（verifyContent 时有效）
+        size_t                           bytes   = 0;      ///< 估算内存。
+        bool                             loading = false;  ///< 是否正在加载。
+        std::shared_future<Document>     pending;          ///< 加载结果（loading 时有效）
+        std::list<std::string>::iterator lru;              ///< 在 LRU 链表中的位置。
+    };
+
+    Options                      options;  ///< 缓存选项。
+    mutable std::mutex           mutex;    ///< 保护以下所有成员。
+    std::map<std::string, Entry> entries;  ///< 按路径索引的条目。
+    std::list<std::string>       lru;      ///< 已加载的条目，越靠前越近被使用
+    Stats                        stats;    ///< 统计信息。
+
+    /**
+     * @brief 将条目移出 LRU 链表并扣除内存。
+     */
+    void unlink(Entry& entry) {
+        if (entry.document) {
+            lru.erase(entry.lru);
+            stats.memory -= entry.bytes;
+            entry.document.reset();
+        }
+    }
+
+    /**
+     * @brief 淘汰最久未使用的条目直到不超过预算（至少保留最近使用的一个）
+     */
+    void evict() {
+        while (stats.memory > options.memoryBudget && lru.size() > 1) {
+            auto it = entries.find(lru.back());
+            unlink(it->second);
+            if (!it->second.loading) {
+                entries.erase(it);
+            }
+            ++stats.evictions;
+        }
+    }
+};
+
+TomlCache::TomlCache() : TomlCache(Options()) {}
+
+TomlCache::TomlCache(Options options) : m_state(std::make_unique<State>()) {
+    m_state->options = std::move(options);
+}
+
+TomlCache::~TomlCache() = default;
+
+TomlCache& TomlCache::instance() {
+    static TomlCache cache;
+    return cache;
+}
+
+TomlCache::Document TomlCache::load(const std::string& path) {
+    FileIdentity identity;
+    if (!statFile(path, identity)) {
+        throw TomlException("Cannot open file: " + path);
+    }
+    State&                       state = *m_state;
+    std::unique_lock<std::mutex> lock(state.mutex);
+    auto                         it    = state.entries.try_emplace(path).first;
+    State::Entry&                entry = it->second;
+    if (entry.loading) {
+        // 其他线程正在加载同一文件, 等待其结果
+        auto pending = entry.pending;
+        ++state.stats.waits;
+        lock.unlock();
+        return pending.get();
+    }
+    // 元数据未变时直接命中; 开启 verifyContent 时只有元数据变化才读取文件并比较内容哈希
+    if (entry.document && entry.identity == identity) {
+        state.lru.splice(state.lru.begin(), state.lru, entry.lru);
+        ++state.stats.hits;
+        return entry.document;
+    }
+
+    // 由当前线程加载, 其余线程通过 pending 等待
+    std::promise<Document> promise;
+    entry.loading                = true;
+    entry.pending                = promise.get_future().share();
+    const Document previous      = entry.document;
+    const uint64_t previousHash  = entry.hash;
+    const bool     verifyContent = state.options.verifyContent;
+    const auto     parseOptions  = state.options.parseOptions;
+    lock.unlock();
+
+    Document document;
+    uint64_t hash  = 0;
+    size_t   bytes = 0;
+    bool     reuse = false;
+    try {
+        std::ifstream input(path, std::ios::binary);
+        if (!input) {
+            throw TomlException("Cannot open file: " + path);
+        }
+        std::string content(identity.size, '\0');
+        input.read(content.data(), static_cast<std::streamsize>(content.size()));
+        content.resize(static_cast<size_t>(input.gcount()));
+        if (verifyContent) {
+            hash  = hashContent(content);
+            reuse = previous && hash == previousHash;
+        }
+        if (reuse) {
+            document = previous;
+        } else {
+            document = std::make_shared<const TomlValue>(parser::parse(content, parseOptions));
+            bytes    = document->memoryUsage().total();
+        }
+    } catch (...) {
+        lock.lock();
+        entry.loading = false;
+        entry.pending = {};
+        if (!entry.document) {
+            state.entries.erase(it);
+        }
+        lock.unlock();
+        promise.set_exception(std::current_exception());
+        throw;
+    }
 
-#define IS_DIGIT(c) ('0' <= (c) && (c) <= '9')
+    lock.lock();
+    if (reuse) {
+        ++state.stats.hits;
+        if (entry.document) {
+            state.lru.splice(state.lru.begin(), state.lru, entry.lru);
+        } else {
+            // 加载期间条目已被其他线程淘汰, 重新挂回 LRU 链表并计入内存
+            state.lru.push_front(path);
+            entry.lru = state.lru.begin();
+            state.stats.memory += entry.bytes;
+        }
+    } else {
+        ++state.stats.loads;
+        state.unlink(entry);
+        state.lru.push_front(path);
+        entry.lru   = state.lru.begin();
+        entry.bytes = bytes;
+        state.stats.memory += bytes;
+    }
+    entry.document = document;
+    entry.identity = identity;
+    entry.hash     = hash;
+    entry.loading  = false;
+    entry.pending  = {};
+    state.evict();
+    state.stats.entries = state.lru.size();
+    lock.unlock();
+    promise.set_value(document);
+    return document;
+}
 
-bool TomlDate::parseTimePart(const std::string_view& sv, size_t& position) noexcept {
-    // 解析时间部分 hh:mm:ss
-    auto hour = ParseDigits(sv, position, 2);
-    if (!hour || *hour > 23 || position >= sv.size() || sv[position] != ':') {
-        return false;
+void TomlCache::invalidate(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    auto                        it = m_state->entries.find(path);
+    if (it != m_state->entries.end() && !it->second.loading) {
+        m_state->unlink(it->second);
+        m_state->entries.erase(it);
+        m_state->stats.entries = m_state->lru.size();
     }
-    position++;
-    // 解析分钟
-    auto minute = ParseDigits(sv, position, 2);
-    if (!minute || *minute > 59 || position >= sv.size() || sv[position] != ':') {
-        return false;
+}
+
+void TomlCache::clear() {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    for (auto it = m_state->entries.begin(); it != m_state->entries.end();) {
+        m_state->unlink(it->second);
+        it = it->second.loading ? std::next(it) : m_state->entries.erase(it);
     }
-    position++;
-    // 解析秒
-    auto second = ParseDigits(sv, position, 2);
-    if (!second || *second > 59) {
-        return false;
+    m_state->stats.entries = 0;
+}
+
+void TomlCache::setMemoryBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    m_state->options.memoryBudget = bytes;
+    m_state->evict();
+    m_state->stats.entries = m_state->lru.size();
+}
+
+TomlCache::Stats TomlCache::stats() const {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->stats;
+}
+
+/**
+ * @brief 池中空闲块的链表节点（复用块本身的内存）
+ */
+struct PoolFreeBlock {
+    PoolFreeBlock* next;
+};
+
+/**
+ * @brief 全局池：各大小级别的空闲块以及向上游申请的内存块。
+ */
+struct TomlPoolResource::Central {
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;  ///< 每次向上游申请的大小。
+    static constexpr size_t BATCH      = 32;         ///< 线程缓存与全局池交换的批大小。
+
+    std::pmr::memory_resource*            upstream;           ///< 上游资源。
+    std::mutex                            mutex;              ///< 保护以下成员。
+    std::vector<void*>                    free[CLASS_COUNT];  ///< 各级别的空闲块。
+    std::vector<std::pair<void*, size_t>> chunks;             ///< 已申请的内存块。
+    Stats                                 stats;              ///< 统计（largeBytes 除外）
+    std::atomic<size_t>                   largeBytes{0};      ///< 大块内存。
+
+    explicit Central(std::pmr::memory_resource* upstream) : upstream(upstream) {}
+
+    ~Central() {
+        for (const auto& [chunk, size] : chunks) {
+            upstream->deallocate(chunk, size, alignof(std::max_align_t));
+        }
     }
+};
 
-    // 存储时间部分
-    setHour(*hour);
-    setMinute(*minute);
-    setSecond(*second);
-    m_type = TomlDateTimeType::LOCAL_DATE_TIME;
+/**
+ * @brief 线程缓存：各大小级别的空闲链表，由所属线程独占访问。
+ */
+struct TomlPoolResource::ThreadCache {
+    /**
+     * @brief 单个大小级别的空闲链表。
+     */
+    struct List {
+        PoolFreeBlock* head  = nullptr;
+        size_t         count = 0;
+    };
 
-    // 解析可选的亚秒部分
-    if (position < sv.size() && sv[position] == '.') {
-        position++;
-        parseSubSecond(sv, position);
+    std::shared_ptr<Central> central;             ///< 所属的全局池。
+    List                     lists[CLASS_COUNT];  ///< 各级别的空闲链表。
+    size_t                   allocations   = 0;   ///< 尚未汇总的分配次数。
+    size_t                   deallocations = 0;   ///< 尚未汇总的释放次数。
+
+    explicit ThreadCache(std::shared_ptr<Central> central) : central(std::move(central)) {}
+
+    ~ThreadCache() {
+        release(SIZE_MAX);
     }
 
-    // 解析可选的时区偏移
-    if (position < sv.size()) {
-        parseTimezoneOffset(sv, position);
+    /**
+     * @brief 从全局池为级别 c 取一批空闲块，全局池为空时向上游申请新的内存块。
+     */
+    void refill(size_t c) {
+        std::lock_guard<std::mutex> lock(central->mutex);
+        foldCounters();
+        ++central->stats.refills;
+        auto& pool = central->free[c];
+        if (pool.empty()) {
+            const size_t blockSize = (c + 1) * CLASS_STEP;
+            char*        chunk     = static_cast<char*>(
+                central->upstream->allocate(Central::CHUNK_SIZE, alignof(std::max_align_t)));
+            central->chunks.emplace_back(chunk, Central::CHUNK_SIZE);
+            central->stats.reservedBytes += Central::CHUNK_SIZE;
+            const size_t count = Central::CHUNK_SIZE / blockSize;
+            for (size_t i = 0; i < count; ++i) {
+                pool.push_back(chunk + i * blockSize);
+            }
+        }
+        for (size_t i = 0; i < Central::BATCH && !pool.empty(); ++i) {
+            push(c, pool.back());
+            pool.pop_back();
+        }
     }
 
-    // 必须完全匹配整个字符串
-    return position == sv.size();
-}
+    /**
+     * @brief 将各级别中至多 count 个空闲块归还全局池。
+     */
+    void release(size_t count) {
+        std::lock_guard<std::mutex> lock(central->mutex);
+        foldCounters();
+        for (size_t c = 0; c < CLASS_COUNT; ++c) {
+            if (lists[c].count > 0) {
+                ++central->stats.flushes;
+            }
+            for (size_t i = 0; i < count && lists[c].head != nullptr; ++i) {
+                central->free[c].push_back(pop(c));
+            }
+        }
+    }
 
-void TomlDate::parseSubSecond(const std::string_view& sv, size_t& position) {
-    const size_t fracStart = position;
-    while (position < sv.size() && IS_DIGIT(sv[position])) {
-        position++;
+    void push(size_t c, void* pointer) noexcept {
+        auto* block   = static_cast<PoolFreeBlock*>(pointer);
+        block->next   = lists[c].head;
+        lists[c].head = block;
+        ++lists[c].count;
     }
 
-    if (position == fracStart) {
-        throw TomlException("'.' must be followed by digits in string: " + std::string(sv));
+    void* pop(size_t c) noexcept {
+        PoolFreeBlock* block = lists[c].head;
+        lists[c].head        = block->next;
+        --lists[c].count;
+        return block;
     }
 
-    // 提取小数部分并转换为纳秒
-    std::string sub(sv.substr(fracStart, position - fracStart));
-    // 补零至9位(纳秒精度)
-    sub.resize(9, '0');
-    // 字符串转数字
-    int64_t subSecond = 0;
-    auto [ptr, ec]    = std::from_chars(sub.data(), sub.data() + sub.size(), subSecond);
-    if (ec != std::errc() && ptr != sub.data() + sub.size()) {
-        throw TomlException("Invalid fractional second in string: " + std::string(sv));
+    /**
+     * @brief 将线程内的计数汇总到全局统计（需持有全局池的锁）
+     */
+    void foldCounters() noexcept {
+        central->stats.allocations += allocations;
+        central->stats.deallocations += deallocations;
+        allocations   = 0;
+        deallocations = 0;
     }
+};
 
-    m_subSecond = subSecond;
+TomlPoolResource::TomlPoolResource(std::pmr::memory_resource* upstream)
+    : m_central(std::make_shared<Central>(upstream)) {}
+
+TomlPoolResource::~TomlPoolResource() = default;
+
+TomlPoolResource& TomlPoolResource::instance() {
+    static TomlPoolResource pool;
+    return pool;
 }
 
-void TomlDate::parseTimezoneOffset(const std::string_view& sv, size_t& position) {
-    const char offsetChar = sv[position];
+TomlPoolResource::ThreadCache& TomlPoolResource::threadCache() {
+    static thread_local std::vector<std::unique_ptr<ThreadCache>> caches;
+    static thread_local ThreadCache*                              last = nullptr;
+    if (last != nullptr && last->central == m_central) {
+        return *last;
+    }
+    for (auto& cache : caches) {
+        if (cache->central == m_central) {
+            return *(last = cache.get());
+        }
+    }
+    // 丢弃已销毁资源的缓存 (只剩本线程持有其全局池)
+    caches.erase(std::remove_if(caches.begin(), caches.end(),
+                                [](const auto& cache) { return cache->central.use_count() == 1; }),
+                 caches.end());
+    caches.push_back(std::make_unique<ThreadCache>(m_central));
+    return *(last = caches.back().get());
+}
 
-    if (offsetChar == 'Z' || offsetChar == 'z') {
-        position++;
-        setTzOffset(0);
-        m_type = TomlDateTimeType::OFFSET_DATE_TIME;
+void* TomlPoolResource::do_allocate(size_t bytes, size_t alignment) {
+    if (bytes > MAX_BLOCK || alignment > CLASS_STEP) {
+        void* pointer = m_central->upstream->allocate(bytes, alignment);
+        m_central->largeBytes.fetch_add(bytes, std::memory_order_relaxed);
+        return pointer;
+    }
+    const size_t c     = bytes == 0 ? 0 : (bytes - 1) / CLASS_STEP;
+    ThreadCache& cache = threadCache();
+    if (cache.lists[c].head == nullptr) {
+        cache.refill(c);
+    }
+    ++cache.allocations;
+    return cache.pop(c);
+}
+
+void TomlPoolResource::do_deallocate(void* pointer, size_t bytes, size_t alignment) {
+    if (bytes > MAX_BLOCK || alignment > CLASS_STEP) {
+        m_central->largeBytes.fetch_sub(bytes, std::memory_order_relaxed);
+        m_central->upstream->deallocate(pointer, bytes, alignment);
         return;
     }
+    const size_t c     = bytes == 0 ? 0 : (bytes - 1) / CLASS_STEP;
+    ThreadCache& cache = threadCache();
+    cache.push(c, pointer);
+    ++cache.deallocations;
+    if (cache.lists[c].count >= 2 * Central::BATCH) {
+        // 成批归还, 避免只释放不分配的线程无限囤积
+        std::lock_guard<std::mutex> lock(m_central->mutex);
+        cache.foldCounters();
+        ++m_central->stats.flushes;
+        for (size_t i = 0; i < Central::BATCH; ++i) {
+            m_central->free[c].push_back(cache.pop(c));
+        }
+    }
+}
 
-    if (offsetChar != '+' && offsetChar != '-') {
-        return;  // 没有时区信息，保持当前类型
+TomlPoolResource::Stats TomlPoolResource::stats() const {
+    std::lock_guard<std::mutex> lock(m_central->mutex);
+    Stats                       result = m_central->stats;
+    result.largeBytes                  = m_central->largeBytes.load(std::memory_order_relaxed);
+    for (const auto& pool : m_central->free) {
+        result.centralBlocks += pool.size();
     }
+    return result;
+}
 
-    position++;
+void TomlPoolResource::flushThreadCache() {
+    threadCache().release(SIZE_MAX);
+}
 
-    // 解析时区偏移 ±HH:MM
-    auto offsetHour = ParseDigits(sv, position, 2);
-    if (!offsetHour || *offsetHour > 23 || position >= sv.size() || sv[position] != ':') {
-        throw TomlException("Invalid timezone offset hour in string: " + std::string(sv));
+/*————————————————————————————————————冻结————————————————————————————————————————*/
+
+TomlFrozen::TomlFrozen() : TomlFrozen(TomlValue()) {}
+
+TomlFrozen::TomlFrozen(const TomlValue& value, bool deduplicate)
+    : m_buffer(deduplicate ? freezeDeduplicated(value) : freezeTree(value)) {}
+
+std::shared_ptr<const std::byte[]> TomlFrozen::freezeTree(const TomlValue& value) {
+    // 第一遍: 统计节点、日期与字符数, 整棵树只分配一次内存
+    size_t nodeCount = 0, dateCount = 0, charCount = 0;
+    forEachNode(value, [&](const TomlValue& node) {
+        ++nodeCount;
+        if (node.isString()) {
+            charCount += node.asString().size();
+        } else if (node.isDate()) {
+            ++dateCount;
+        } else if (node.isObject()) {
+            for (const auto& [key, _] : node.asObject()) {
+                charCount += key.size();
+            }
+        }
+    });
+    if (nodeCount > UINT32_MAX || charCount > UINT32_MAX) {
+        throw TomlException("Document too large to freeze");
     }
-    position++;
+    const size_t dateOffset = sizeof(Header) + nodeCount * sizeof(Node);
+    const size_t charOffset = dateOffset + dateCount * sizeof(TomlDate);
+    const size_t bytes      = charOffset + charCount;
+
+    std::unique_ptr<std::byte[]> buffer(new std::byte[bytes]);
+    ::new (buffer.get()) Header{nodeCount, dateOffset, charOffset, bytes};
+    Node* nodes = reinterpret_cast<Node*>(buffer.get() + sizeof(Header));
+    std::uninitialized_default_construct_n(nodes, nodeCount);
+    auto*  dates    = reinterpret_cast<TomlDate*>(buffer.get() + dateOffset);
+    auto*  chars    = reinterpret_cast<char*>(buffer.get() + charOffset);
+    size_t nextNode = 1, nextDate = 0, nextChar = 0;
+    auto   copyChars = [&](std::string_view text) {
+        std::memcpy(chars + nextChar, text.data(), text.size());
+        nextChar += text.size();
+        return nextChar - text.size();
+    };
 
-    auto offsetMinute = ParseDigits(sv, position, 2);
-    if (!offsetMinute || *offsetMinute > 59) {
-        throw TomlException("Invalid timezone offset minute in string: " + std::string(sv));
+    // 第二遍: 每个容器的子节点分配为连续的一段, 逆序入栈使各段按深度优先顺序排列
+    std::vector<std::pair<const TomlValue*, Node*>> pending{{&value, nodes}};
+    while (!pending.empty()) {
+        auto [source, node] = pending.back();
+        pending.pop_back();
+        node->type = source->type();
+        switch (source->type()) {
+            case TomlType::Boolean: node->boolean = static_cast<bool>(*source); break;
+            case TomlType::Integer: node->iNumber = static_cast<int64_t>(*source); break;
+            case TomlType::Double: node->dNumber = static_cast<double>(*source); break;
+            case TomlType::String: {
+                const auto& string = source->asString();
+                node->length       = static_cast<uint32_t>(string.size());
+                node->offset       = copyChars(string);
+                break;
+            }
+            case TomlType::Date:
+                ::new (dates + nextDate) TomlDate(source->asDate());
+                node->offset = nextDate++;
+                break;
+            case TomlType::Array: {
+                const auto& array = source->asArray();
+                Node*       first = nodes + nextNode;
+                node->length      = static_cast<uint32_t>(array.size());
+                node->offset      = nextNode;
+                nextNode += array.size();
+                for (size_t i = array.size(); i-- > 0;) {
+                    pending.emplace_back(&array[i], first + i);
+                }
+                break;
+            }
+            case TomlType::Object: {
+                const auto& object = source->asObject();
+                Node*       first  = nodes + nextNode;
+                node->length       = static_cast<uint32_t>(object.size());
+                node->offset       = nextNode;
+                nextNode += object.size();
+                // 键按 std::map 的顺序写入, 查找时可直接二分
+                size_t i = 0;
+                for (const auto& [key, _] : object) {
+                    first[i].keyOffset   = static_cast<uint32_t>(copyChars(key));
+                    first[i++].keyLength = static_cast<uint32_t>(key.size());
+                }
+                for (auto it = object.rbegin(); it != object.rend(); ++it) {
+                    pending.emplace_back(&it->second, first + --i);
+                }
+                break;
+            }
+        }
     }
-
-    const int sign = (offsetChar == '+') ? 1 : -1;
-    setTzOffset(sign * (*offsetHour * 60 + *offsetMinute));
-    m_type = TomlDateTimeType::OFFSET_DATE_TIME;
+    return std::shared_ptr<const std::byte[]>(buffer.release());
 }
 
-std::optional<int>
-TomlDate::ParseDigits(const std::string_view& sv, size_t& position, int count) noexcept {
-    if (position + count > sv.size()) {
-        return std::nullopt;
-    }
+std::shared_ptr<const std::byte[]> TomlFrozen::freezeDeduplicated(const TomlValue& value) {
+    // 节点标识: 标量为值本身, 字符串/日期/容器为去重后的编号; 标识相同即结构相同
+    struct Ident {
+        TomlType type;
+        uint64_t value;
+    };
+    // 日期按 operator== (类型与打包字段) 去重, 相等的日期时间点相同, 可用 toUnixNanos() 散列
+    struct DateHash {
+        size_t operator()(const TomlDate& date) const noexcept {
+            return std::hash<int64_t>()(date.toUnixNanos()) ^ static_cast<size_t>(date.type());
+        }
+    };
+    // 去重后的容器: 签名为每个子节点的 (键编号 << 8 | 类型, 值) 两个字
+    struct Container {
+        TomlType type;
+        size_t   begin;  ///< 签名在 signatures 中的起始位置
+        size_t   count;  ///< 子节点数
+    };
+    std::vector<std::string_view>                    strings;
+    std::unordered_map<std::string_view, uint32_t>   stringIds;
+    std::vector<TomlDate>                            dates;
+    std::unordered_map<TomlDate, uint32_t, DateHash> dateIds;
+    std::vector<Container>                           containers;
+    std::vector<uint64_t>                            signatures;
+    std::unordered_multimap<uint64_t, uint32_t>      containerIds;
+    auto                                             internString = [&](std::string_view text) {
+        auto [it, inserted] = stringIds.emplace(text, static_cast<uint32_t>(strings.size()));
+        if (inserted) {
+            strings.push_back(text);
+        }
+        return it->second;
+    };
+    auto leaf = [&](const TomlValue& node) -> Ident {
+        switch (node.type()) {
+            case TomlType::Boolean: return {node.type(), static_cast<bool>(node) ? 1u : 0u};
+            case TomlType::Integer:
+                return {node.type(), static_cast<uint64_t>(static_cast<int64_t>(node))};
+            case TomlType::Double: {
+                double   number = static_cast<double>(node);
+                uint64_t bits   = 0;
+                std::memcpy(&bits, &number, sizeof(bits));
+                return {node.type(), bits};
+            }
+            case TomlType::String: return {node.type(), internString(node.asString())};
+            default: {
+                auto [it, inserted] =
+                    dateIds.emplace(node.asDate(), static_cast<uint32_t>(dates.size()));
+                if (inserted) {
+                    dates.push_back(node.asDate());
+                }
+                return {node.type(), it->second};
+            }
+        }
+    };
 
-    int value = 0;
-    for (int i = 0; i < count; ++i) {
-        const auto c = sv[position + i];
-        if (!IS_DIGIT(c)) {
-            return std::nullopt;
+    // 后序遍历: 子树的标识依次压入 idents, 容器在所有子节点完成后由它们的标识去重
+    struct Frame {
+        const TomlValue*           node;
+        size_t                     base;   ///< 第一个子节点标识在 idents 中的位置
+        size_t                     index;  ///< 数组的下一个下标
+        TomlObject::const_iterator it;     ///< 对象的下一个成员
+    };
+    std::vector<Ident> idents;
+    std::vector<Frame> stack;
+    auto               enter = [&](const TomlValue& node) {
+        if (node.isArray()) {
+            stack.push_back({&node, idents.size(), 0, {}});
+        } else if (node.isObject()) {
+            stack.push_back({&node, idents.size(), 0, node.asObject().begin()});
+        } else {
+            idents.push_back(leaf(node));
+        }
+    };
+    enter(value);
+    while (!stack.empty()) {
+        const TomlValue* child = nullptr;
+        {
+            Frame& frame = stack.back();
+            if (frame.node->isArray()) {
+                if (frame.index < frame.node->asArray().size()) {
+                    child = &frame.node->asArray()[frame.index++];
+                }
+            } else if (frame.it != frame.node->asObject().end()) {
+                child = &(frame.it++)->second;
+            }
+        }
+        if (child != nullptr) {
+            enter(*child);
+            continue;
+        }
+        const Frame frame = stack.back();
+        stack.pop_back();
+        const TomlType type  = frame.node->type();
+        const size_t   count = idents.size() - frame.base;
+        const size_t   begin = signatures.size();
+        uint64_t       hash  = static_cast<uint64_t>(type) * 0x9E3779B97F4A7C15ULL + count;
+        auto           keyIt = type == TomlType::Object ? frame.node->asObject().begin()
+                                                        : TomlObject::const_iterator();
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t key = 0;
+            if (type == TomlType::Object) {
+                key = static_cast<uint64_t>(internString((keyIt++)->first)) + 1;
+            }
+            const Ident& item = idents[frame.base + i];
+            signatures.push_back(key << 8 | static_cast<uint64_t>(item.type));
+            signatures.push_back(item.value);
+            for (size_t w = begin + 2 * i; w < begin + 2 * i + 2; ++w) {
+                hash = (hash ^ signatures[w]) * 0x100000001B3ULL;
+                hash ^= hash >> 29;
+            }
+        }
+        idents.resize(frame.base);
+        // 哈希相同时逐字比较签名, 找到已有的相同容器则丢弃刚写入的签名
+        auto id       = static_cast<uint32_t>(containers.size());
+        auto [lo, hi] = containerIds.equal_range(hash);
+        for (auto it = lo; it != hi; ++it) {
+            const Container& other = containers[it->second];
+            if (other.type == type && other.count == count &&
+                std::equal(signatures.begin() + static_cast<std::ptrdiff_t>(begin),
+                           signatures.end(),
+                           signatures.begin() + static_cast<std::ptrdiff_t>(other.begin))) {
+                id = it->second;
+                break;
+            }
+        }
+        if (id == containers.size()) {
+            containers.push_back({type, begin, count});
+            containerIds.emplace(hash, id);
+        } else {
+            signatures.resize(begin);
+        }
+        idents.push_back({type, id});
+    }
+    const Ident root = idents.front();
+
+    // 布局: 每个去重后的容器只放一段子节点, 按深度优先顺序第一次遇到时分配
+    std::vector<size_t>   runs(containers.size(), SIZE_MAX);
+    std::vector<uint32_t> placed;
+    size_t                nodeCount = 1;
+    std::vector<uint32_t> pending;
+    if (root.type == TomlType::Array || root.type == TomlType::Object) {
+        pending.push_back(static_cast<uint32_t>(root.value));
+    }
+    while (!pending.empty()) {
+        uint32_t id = pending.back();
+        pending.pop_back();
+        if (runs[id] != SIZE_MAX) {
+            continue;
+        }
+        const Container& container = containers[id];
+        runs[id]                   = nodeCount;
+        nodeCount += container.count;
+        placed.push_back(id);
+        for (size_t i = container.count; i-- > 0;) {
+            auto childType = static_cast<TomlType>(signatures[container.begin + 2 * i] & 0xFF);
+            if (childType == TomlType::Array || childType == TomlType::Object) {
+                pending.push_back(static_cast<uint32_t>(signatures[container.begin + 2 * i + 1]));
+            }
+        }
+    }
+    std::vector<size_t> stringOffsets(strings.size());
+    size_t              charCount = 0;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        stringOffsets[i] = charCount;
+        charCount += strings[i].size();
+    }
+    if (nodeCount > UINT32_MAX || charCount > UINT32_MAX) {
+        throw TomlException("Document too large to freeze");
+    }
+    const size_t dateOffset = sizeof(Header) + nodeCount * sizeof(Node);
+    const size_t charOffset = dateOffset + dates.size() * sizeof(TomlDate);
+    const size_t bytes      = charOffset + charCount;
+
+    std::unique_ptr<std::byte[]> buffer(new std::byte[bytes]);
+    ::new (buffer.get()) Header{nodeCount, dateOffset, charOffset, bytes};
+    Node* nodes = reinterpret_cast<Node*>(buffer.get() + sizeof(Header));
+    std::uninitialized_default_construct_n(nodes, nodeCount);
+    std::uninitialized_copy(dates.begin(), dates.end(),
+                            reinterpret_cast<TomlDate*>(buffer.get() + dateOffset));
+    auto* chars = reinterpret_cast<char*>(buffer.get() + charOffset);
+    for (size_t i = 0; i < strings.size(); ++i) {
+        std::memcpy(chars + stringOffsets[i], strings[i].data(), strings[i].size());
+    }
+    auto write = [&](const Ident& ident, Node& node) {
+        node.type = ident.type;
+        switch (ident.type) {
+            case TomlType::Boolean: node.boolean = ident.value != 0; break;
+            case TomlType::Integer: node.iNumber = static_cast<int64_t>(ident.value); break;
+            case TomlType::Double: std::memcpy(&node.dNumber, &ident.value, sizeof(double)); break;
+            case TomlType::String:
+                node.offset = stringOffsets[ident.value];
+                node.length = static_cast<uint32_t>(strings[ident.value].size());
+                break;
+            case TomlType::Date: node.offset = ident.value; break;
+            default:
+                node.offset = runs[ident.value];
+                node.length = static_cast<uint32_t>(containers[ident.value].count);
+                break;
+        }
+    };
+    write(root, nodes[0]);
+    for (uint32_t id : placed) {
+        const Container& container = containers[id];
+        for (size_t i = 0; i < container.count; ++i) {
+            uint64_t word = signatures[container.begin + 2 * i];
+            Node&    node = nodes[runs[id] + i];
+            if (uint64_t key = word >> 8; key != 0) {
+                node.keyOffset = static_cast<uint32_t>(stringOffsets[key - 1]);
+                node.keyLength = static_cast<uint32_t>(strings[key - 1].size());
+            }
+            write({static_cast<TomlType>(word & 0xFF), signatures[container.begin + 2 * i + 1]},
+                  node);
         }
-        value = value * 10 + (c - '0');
     }
+    return std::shared_ptr<const std::byte[]>(buffer.release());
+}
 
-    position += count;
-    return value;
+TomlFrozen::View TomlFrozen::root() const noexcept {
+    const auto* header = reinterpret_cast<const Header*>(m_buffer.get());
+    return View(header, header->nodes());
 }
 
-bool TomlDate::parseLocalTime(const std::string_view& sv) noexcept {
-    size_t position = 0;
+size_t TomlFrozen::nodeCount() const noexcept {
+    return reinterpret_cast<const Header*>(m_buffer.get())->nodeCount;
+}
 
-    // 解析时间部分 hh:mm:ss
-    auto hour = ParseDigits(sv, position, 2);
-    if (!hour || *hour > 23 || position >= sv.size() || sv[position] != ':') {
-        return false;
+size_t TomlFrozen::memoryBytes() const noexcept {
+    return reinterpret_cast<const Header*>(m_buffer.get())->bytes;
+}
+
+TomlFrozen::View TomlFrozen::View::operator[](size_t index) const {
+    if (!isArray()) {
+        throw TomlException("Not an Array");
     }
-    position++;
+    if (index >= m_node->length) {
+        throw TomlException("Array index out of range");
+    }
+    return View(m_header, child(index));
+}
 
-    auto minute = ParseDigits(sv, position, 2);
-    if (!minute || *minute > 59 || position >= sv.size() || sv[position] != ':') {
-        return false;
+TomlFrozen::View TomlFrozen::View::operator[](std::string_view key) const {
+    if (!isObject()) {
+        throw TomlException("Not a Object");
     }
-    position++;
+    if (auto found = find(key)) {
+        return *found;
+    }
+    throw TomlException("Key not found");
+}
 
-    auto second = ParseDigits(sv, position, 2);
-    if (!second || *second > 59) {
-        return false;
+std::optional<TomlFrozen::View> TomlFrozen::View::find(std::string_view key) const noexcept {
+    if (!isObject()) {
+        return std::nullopt;
     }
+    const char* chars = m_header->chars();
+    const Node* first = child(0);
+    const Node* last  = first + m_node->length;
+    const Node* it    = std::lower_bound(first, last, key, [chars](const Node& node, auto k) {
+        return std::string_view(chars + node.keyOffset, node.keyLength) < k;
+    });
+    if (it != last && std::string_view(chars + it->keyOffset, it->keyLength) == key) {
+        return View(m_header, it);
+    }
+    return std::nullopt;
+}
 
-    // 存储时间部分
-    setHour(*hour);
-    setMinute(*minute);
-    setSecond(*second);
-    m_type = TomlDateTimeType::LOCAL_TIME;
+std::optional<TomlFrozen::View> TomlFrozen::View::findPath(std::string_view path) const noexcept {
+    std::optional<View> node     = *this;
+    size_t              position = 0;
+    while (node && position < path.size()) {
+        if (path[position] == '[') {
+            // 数组下标
+            auto close = path.find(']', position);
+            if (close == std::string_view::npos || !node->isArray()) {
+                return std::nullopt;
+            }
+            size_t index = 0;
+            auto [ptr, ec] =
+                std::from_chars(path.data() + position + 1, path.data() + close, index);
+            if (ec != std::errc() || ptr != path.data() + close || index >= node->size()) {
+                return std::nullopt;
+            }
+            node     = View(m_header, node->child(index));
+            position = close + 1;
+        } else {
+            // 键, 直到下一个 . 或 [ (除第一个键外, 前面必须是 .)
+            if (position > 0) {
+                if (path[position] != '.') {
+                    return std::nullopt;
+                }
+                ++position;
+            }
+            auto end = path.find_first_of(".[", position);
+            if (end == std::string_view::npos) {
+                end = path.size();
+            }
+            if (end == position) {
+                return std::nullopt;
+            }
+            node     = node->find(path.substr(position, end - position));
+            position = end;
+        }
+    }
+    return node;
+}
 
-    // 解析可选的亚秒部分
-    if (position < sv.size() && sv[position] == '.') {
-        position++;
-        parseSubSecond(sv, position);
+bool TomlFrozen::View::asBoolean() const {
+    if (!isBoolean()) {
+        throw TomlException("Cannot convert to bool");
     }
+    return m_node->boolean;
+}
 
-    // 必须完全匹配整个字符串
-    return position == sv.size();
+int64_t TomlFrozen::View::asInteger() const {
+    if (!isInteger()) {
+        throw TomlException("Cannot convert to int64_t");
+    }
+    return m_node->iNumber;
 }
 
-bool TomlDate::parseDateTime(const std::string_view& sv) {
-    size_t position = 0;
-    // 解析日期部分 YYYY-MM-DD
-    auto year = ParseDigits(sv, position, 4);
-    if (!year || position >= sv.size() || sv[position] != '-') {
-        return false;
+double TomlFrozen::View::asDouble() const {
+    if (isInteger()) {
+        return static_cast<double>(m_node->iNumber);
     }
-    position++;
+    if (!isDouble()) {
+        throw TomlException("Cannot convert to double");
+    }
+    return m_node->dNumber;
+}
 
-    auto month = ParseDigits(sv, position, 2);
-    if (!month || *month < 1 || *month > 12 || position >= sv.size() || sv[position] != '-') {
-        return false;
+std::string_view TomlFrozen::View::asString() const {
+    if (!isString()) {
+        throw TomlException("Cannot convert to string");
     }
-    position++;
+    return {m_header->chars() + m_node->offset, m_node->length};
+}
 
-    auto day = ParseDigits(sv, position, 2);
-    if (!day || *day < 1) {
-        return false;
+const TomlDate& TomlFrozen::View::asDate() const {
+    if (!isDate()) {
+        throw TomlException("Not a Date");
+    }
+    return m_header->dates()[m_node->offset];
+}
+
+TomlValue TomlFrozen::View::toValue() const {
+    TomlValue result;
+    // 显式栈: 目标容器先整体建好, 其中元素的地址在填充子树期间保持不变
+    std::vector<std::pair<const Node*, TomlValue*>> pending{{m_node, &result}};
+    while (!pending.empty()) {
+        auto [node, target] = pending.back();
+        pending.pop_back();
+        View view(m_header, node);
+        switch (node->type) {
+            case TomlType::Boolean: *target = node->boolean; break;
+            case TomlType::Integer: *target = node->iNumber; break;
+            case TomlType::Double: *target = node->dNumber; break;
+            case TomlType::String: *target = TomlString(view.asString()); break;
+            case TomlType::Date: *target = view.asDate(); break;
+            case TomlType::Array: {
+                TomlArray array;
+                array.resize(node->length);
+                *target     = std::move(array);
+                auto& items = target->asArray();
+                for (size_t i = 0; i < node->length; ++i) {
+                    pending.emplace_back(view.child(i), &items[i]);
+                }
+                break;
+            }
+            case TomlType::Object: {
+                *target      = TomlObject();
+                auto& object = target->asObject();
+                for (View member : view) {
+                    auto it = object.emplace_hint(object.end(), TomlString(member.key()),
+                                                  TomlValue());
+                    pending.emplace_back(member.m_node, &it->second);
+                }
+                break;
+            }
+        }
     }
+    return result;
+}
 
-    // 验证每月的有效天数（考虑闰年）
-    const bool           isLeapYear    = (*year % 4 == 0 && *year % 100 != 0) || (*year % 400 == 0);
-    static constexpr int daysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-    int                  maxDays       = daysInMonth[*month - 1];
+TomlFrozen TomlValue::freeze(bool deduplicate) const {
+    return TomlFrozen(*this, deduplicate);
+}
 
-    // 闰年2月多一天
-    if (*month == 2 && isLeapYear) {
-        maxDays = 29;
+/*————————————————————————————————————比较与哈希——————————————————————————————————————*/
+namespace {
+/**
+ * @brief 子节点数，标量为 0。
+ */
+size_t childCount(const TomlValue& node) {
+    if (node.isArray()) {
+        return node.asArray().size();
     }
+    return node.isObject() ? node.asObject().size() : 0;
+}
 
-    if (*day > maxDays) {
+/**
+ * @brief 比较两个节点本身：类型、标量值、容器大小以及对象的键，不比较子节点。
+ */
+bool shallowEqual(const TomlValue& lhs, const TomlValue& rhs) {
+    if (lhs.type() != rhs.type()) {
         return false;
     }
+    switch (lhs.type()) {
+        case TomlType::Boolean: return static_cast<bool>(lhs) == static_cast<bool>(rhs);
+        case TomlType::Integer: return static_cast<int64_t>(lhs) == static_cast<int64_t>(rhs);
+        case TomlType::Double: return static_cast<double>(lhs) == static_cast<double>(rhs);
+        case TomlType::String: return lhs.asString() == rhs.asString();
+        case TomlType::Date: return lhs.asDate() == rhs.asDate();
+        case TomlType::Array: return lhs.asArray().size() == rhs.asArray().size();
+        case TomlType::Object: {
+            const auto& left  = lhs.asObject();
+            const auto& right = rhs.asObject();
+            return left.size() == right.size() &&
+                   std::equal(left.begin(), left.end(), right.begin(),
+                              [](const auto& a, const auto& b) { return a.first == b.first; });
+        }
+    }
+    return false;
+}
 
-    // 存储日期部分
-    setYear(*year);
-    setMonth(*month);
-    setDay(*day);
-    m_type = TomlDateTimeType::LOCAL_DATE;
+/**
+ * @brief 按相同顺序列出两个已通过 shallowEqual() 的容器的子节点对。
+ */
+void pairChildren(const TomlValue&                                              lhs,
+                  const TomlValue&                                              rhs,
+                  std::vector<std::pair<const TomlValue*, const TomlValue*>>& pairs) {
+    if (lhs.isArray()) {
+        const auto& left  = lhs.asArray();
+        const auto& right = rhs.asArray();
+        for (size_t i = 0; i < left.size(); ++i) {
+            pairs.emplace_back(&left[i], &right[i]);
+        }
+    } else if (lhs.isObject()) {
+        auto it = rhs.asObject().begin();
+        for (const auto& [_, value] : lhs.asObject()) {
+            pairs.emplace_back(&value, &(it++)->second);
+        }
+    }
+}
 
-    // 日期后无内容，解析成功
-    if (position == sv.size()) {
-        return true;
+/**
+ * @brief 树的哈希由先序遍历得到的节点摘要序列按多项式 Σ token[i]·P^(n-1-i) 折叠而成。
+ *
+ * 同时记录 P^n，两段序列的结果可以按顺序拼接，因此子树可以各自计算后再合并，
+ * 串行与并行的结果相同。
+ */
+struct TreeHash {
+    static constexpr uint64_t kBase = 0x100000001B3ull;  ///< P（奇数）
+
+    uint64_t hash  = 0;  ///< 折叠结果
+    uint64_t power = 1;  ///< P^n
+
+    /**
+     * @brief 在序列末尾追加一个节点摘要。
+     */
+    void append(uint64_t token) noexcept {
+        hash = hash * kBase + token;
+        power *= kBase;
     }
 
-    // 检查日期和时间之间的分隔符
-    if (sv[position] != 'T' && sv[position] != 't' && sv[position] != ' ') {
-        throw TomlException("Invalid separator after date in string: " + std::string(sv));
+    /**
+     * @brief 在序列末尾拼接另一段序列。
+     */
+    void append(const TreeHash& other) noexcept {
+        hash = hash * other.power + other.hash;
+        power *= other.power;
     }
-    position++;
+};
 
-    // 解析时间部分
-    return parseTimePart(sv, position);
+/**
+ * @brief 64 位整数混合函数（splitmix64 的最后一步）
+ */
+uint64_t mix64(uint64_t x) noexcept {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
 }
 
-void TomlDate::parse(const std::string_view& sv) {
-    // 为确保重入安全，先清空所有可选成员
-    this->reset();
-    if (sv.empty()) {
-        throw TomlException("Cannot parse an empty string.");
-    }
-    // 尝试按优先级解析不同格式
-    if (parseDateTime(sv)) {
-        return;
+/**
+ * @brief 单个节点（不含子节点）的摘要；对象的摘要包含全部键，数组与对象的摘要包含大小。
+ */
+uint64_t nodeToken(const TomlValue& node) {
+    uint64_t value = 0;
+    switch (node.type()) {
+        case TomlType::Boolean: value = static_cast<bool>(node); break;
+        case TomlType::Integer: value = static_cast<uint64_t>(static_cast<int64_t>(node)); break;
+        case TomlType::Double: {
+            // 0.0 与 -0.0 相等, 哈希值也必须相同
+            double number = static_cast<double>(node);
+            value         = std::hash<double>()(number == 0.0 ? 0.0 : number);
+            break;
+        }
+        case TomlType::String: value = std::hash<std::string_view>()(node.asString()); break;
+        case TomlType::Date:
+            value = static_cast<uint64_t>(node.asDate().toUnixNanos()) ^
+                    static_cast<uint64_t>(node.asDate().type());
+            break;
+        case TomlType::Array: value = node.asArray().size(); break;
+        case TomlType::Object:
+            value = node.asObject().size();
+            for (const auto& [key, _] : node.asObject()) {
+                value = mix64(value) + std::hash<std::string_view>()(key);
+            }
+            break;
     }
-    this->reset();
-    if (parseLocalTime(sv)) {
-        return;
+    return mix64(value ^ (static_cast<uint64_t>(node.type()) << 56));
+}
+
+/**
+ * @brief 在当前线程中计算子树的哈希。
+ */
+TreeHash hashTree(const TomlValue& root) {
+    TreeHash result;
+    forEachNode(root, [&result](const TomlValue& node) { result.append(nodeToken(node)); });
+    return result;
+}
+}  // namespace
+
+bool TomlValue::operator==(const TomlValue& other) const {
+    std::vector<std::pair<const TomlValue*, const TomlValue*>> pending{{this, &other}};
+    while (!pending.empty()) {
+        auto [lhs, rhs] = pending.back();
+        pending.pop_back();
+        if (lhs != rhs) {
+            if (!shallowEqual(*lhs, *rhs)) {
+                return false;
+            }
+            pairChildren(*lhs, *rhs, pending);
+        }
     }
-    // 所有解析尝试均失败
-    this->reset();
-    throw TomlException("String does not match any valid TOML date/time format: " +
-                        std::string(sv));
+    return true;
 }
 
-std::string TomlDate::toString() const noexcept {
-    std::ostringstream oss;
-    oss << std::setfill('0');
-    // YYYY-MM-dd
-    auto year = getYear();
-    if (year.has_value()) {
-        auto month = getMonth();
-        auto day   = getDay();
-        auto hour  = getHour();
-        oss << std::setw(4) << *year << '-' << std::setw(2) << *month << '-' << std::setw(2)
-            << *day;
-        if (hour.has_value()) {
-            oss << 'T';
+size_t TomlValue::hash() const {
+    return static_cast<size_t>(hashTree(*this).hash);
+}
+
+/*————————————————————————————————————并行算法————————————————————————————————————————*/
+namespace {
+thread_local size_t tWorkerIndex = 0;  ///< 当前线程在 ForkJoinPool 中的队列下标
+
+/**
+ * @brief 一次并行调用使用的工作窃取（work-stealing）线程池。
+ *
+ * 每个线程有自己的任务队列：fork 的任务压入自己队列的尾部并从尾部取回（后进先出，
+ * 数据仍在缓存中），空闲线程从其他队列的头部窃取（先进先出，窃取的是较大的任务）。
+ * 等待子任务的线程不阻塞，而是继续执行任务。
+ */
+class ForkJoinPool {
+  public:
+    /**
+     * @brief 构造线程池，调用 run() 的线程算作其中一个。
+     * @param threads 线程数。
+     */
+    explicit ForkJoinPool(size_t threads) : m_queues(threads) {
+        for (size_t i = 1; i < threads; ++i) {
+            m_workers.emplace_back(&ForkJoinPool::work, this, i);
         }
     }
-    // hh:mm:ss
-    auto hour = getHour();
-    if (hour.has_value()) {
-        auto minute = getMinute();
-        auto second = getSecond();
-        oss << std::setw(2) << *hour << ':' << std::setw(2) << *minute << ':' << std::setw(2)
-            << *second;
-    }
-
-    auto subSecond = getSubSecond();
-    if (subSecond.has_value() && *subSecond > 0) {
-        std::string subStr = std::to_string(*subSecond);
-        subStr.insert(0, 9 - subStr.length(), '0');
-        // TOML spec: 去掉尾部零
-        subStr.erase(subStr.find_last_not_of('0') + 1, std::string::npos);
-        oss << '.' << subStr;
-    }
-
-    auto tzOffset = getTzOffset();
-    if (tzOffset.has_value()) {
-        if (*tzOffset == 0) {
-            oss << "Z";
-        } else {
-            auto offsetVal = *tzOffset;
-            // 输出符号
-            oss << (offsetVal > 0 ? '+' : '-');
-            // 计算时间
-            offsetVal = std::abs(offsetVal);
-            oss << std::setw(2) << offsetVal / 60 << ':' << std::setw(2) << offsetVal % 60;
+
+    ~ForkJoinPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wakeup.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
         }
     }
 
-    return oss.str();
-}
-
-std::chrono::system_clock::time_point TomlDate::toSystemTimePoint() const {
-    if (!isOffsetDateTime()) {
-        throw TomlException("Only OffsetDateTime can be converted to a system_clock::time_point.");
+    /**
+     * @brief 在当前线程中执行根任务，其中可以调用 parallelFor()
+     * @throws 任一任务抛出的第一个异常在所有任务结束后重新抛出。
+     */
+    template <typename Task>
+    void run(Task&& task) {
+        size_t previous = std::exchange(tWorkerIndex, 0);
+        try {
+            task();
+        } catch (...) {
+            fail(std::current_exception());
+        }
+        tWorkerIndex = previous;
+        if (m_error) {
+            std::rethrow_exception(m_error);
+        }
     }
 
-    std::tm tm  = {};
-    tm.tm_year  = *getYear() - 1900;
-    tm.tm_mon   = *getMonth() - 1;
-    tm.tm_mday  = *getDay();
-    tm.tm_hour  = *getHour();
-    tm.tm_min   = *getMinute();
-    tm.tm_sec   = *getSecond();
-    tm.tm_isdst = 0;  // Don't use daylight saving with UTC
-
-    // timegm converts a struct tm (in UTC) to time_t
-    std::time_t time = timegm(&tm);
-    if (time == -1) {
-        throw TomlException("Failed to convert to time_t.");
+    /**
+     * @brief 对 [begin, end) 中的每个下标调用 body，按二分把区间拆成不超过 grain 的任务。
+     *
+     * 返回前等待所有拆出的任务完成；有任务失败后，尚未开始的区间不再执行。
+     */
+    template <typename Body>
+    void parallelFor(size_t begin, size_t end, size_t grain, const Body& body) {
+        std::atomic<size_t> pending{0};
+        while (end - begin > grain) {
+            size_t middle = begin + (end - begin) / 2;
+            pending.fetch_add(1, std::memory_order_relaxed);
+            try {
+                push([this, middle, end, grain, &body, &pending] {
+                    parallelFor(middle, end, grain, body);
+                    pending.fetch_sub(1, std::memory_order_release);
+                });
+            } catch (...) {
+                // 无法入队时在当前线程完成剩余部分
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                break;
+            }
+            end = middle;
+        }
+        if (!m_failed.load(std::memory_order_relaxed)) {
+            try {
+                for (size_t i = begin; i < end; ++i) {
+                    body(i);
+                }
+            } catch (...) {
+                fail(std::current_exception());
+            }
+        }
+        while (pending.load(std::memory_order_acquire) != 0) {
+            if (!runOne()) {
+                std::this_thread::yield();
+            }
+        }
     }
 
-    auto timePoint = std::chrono::system_clock::from_time_t(time);
+  private:
+    /**
+     * @brief 每个线程的任务队列。
+     */
+    struct Queue {
+        std::mutex                        mutex;
+        std::deque<std::function<void()>> tasks;
+    };
 
-    // Add subseconds and subtract the offset to get the final UTC time_point
-    auto subSecond = getSubSecond();
-    if (subSecond.has_value()) {
-        timePoint += std::chrono::nanoseconds(*subSecond);
+    /**
+     * @brief 把任务压入当前线程队列的尾部，有线程在休眠时唤醒一个。
+     */
+    void push(std::function<void()> task) {
+        Queue& queue = m_queues[tWorkerIndex];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        m_queued.fetch_add(1);
+        if (m_sleeping.load() != 0) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_wakeup.notify_one();
+        }
     }
 
-    timePoint -= std::chrono::minutes(*getTzOffset());
-
-    return timePoint;
-}
-
-void TomlDate::reset() noexcept {
-    m_type      = TomlDateTimeType::INVALID;
-    m_core      = 0;
-    m_subSecond = 0;
-}
-
-/*———————————————————————————————————TomlValue—————————————————————————————————————————*/
-
-TomlValue::TomlValue(const TomlValue& other) : m_type(other.m_type) {
-    switch (other.m_type) {
-        case TomlType::Boolean: m_value.boolean = other.m_value.boolean; break;
-        case TomlType::Integer: m_value.iNumber = other.m_value.iNumber; break;
-        case TomlType::Double: m_value.dNumber = other.m_value.dNumber; break;
-        case TomlType::String: m_value.string = new TomlString(*other.m_value.string); break;
-        case TomlType::Date: m_value.date = new TomlDate(*other.m_value.date); break;
-        case TomlType::Array: m_value.array = new TomlArray(*other.m_value.array); break;
-        case TomlType::Object: m_value.object = new TomlObject(*other.m_value.object); break;
+    /**
+     * @brief 取出并执行一个任务：先取自己队列的尾部，再依次窃取其他队列的头部。
+     * @return 是否执行了任务。
+     */
+    bool runOne() {
+        std::function<void()> task;
+        for (size_t i = 0; i < m_queues.size() && !task; ++i) {
+            Queue&                      queue = m_queues[(tWorkerIndex + i) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                if (i == 0) {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                } else {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+            }
+        }
+        if (!task) {
+            return false;
+        }
+        m_queued.fetch_sub(1);
+        task();
+        return true;
     }
-}
-
-TomlValue::TomlValue(TomlValue&& other) noexcept : m_type(other.m_type) {
-    m_value              = other.m_value;
-    other.m_type         = TomlType::Object;
-    other.m_value.object = nullptr;
-}
 
-TomlValue& TomlValue::operator=(const TomlValue& other) {
-    if (this != &other) {
-        destroyValue();
-        m_type = other.m_type;
-        switch (m_type) {
-            case TomlType::Boolean: m_value.boolean = other.m_value.boolean; break;
-            case TomlType::Integer: m_value.iNumber = other.m_value.iNumber; break;
-            case TomlType::Double: m_value.dNumber = other.m_value.dNumber; break;
-            case TomlType::String: m_value.string = new TomlString(*other.m_value.string); break;
-            case TomlType::Date: m_value.date = new TomlDate(*other.m_value.date); break;
-            case TomlType::Array: m_value.array = new TomlArray(*other.m_value.array); break;
-            case TomlType::Object: m_value.object = new TomlObject(*other.m_value.object); break;
+    /**
+     * @brief 工作线程主循环：没有任务可做时休眠，直到有新任务或线程池析构。
+     */
+    void work(size_t index) {
+        tWorkerIndex = index;
+        while (true) {
+            if (runOne()) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_sleeping.fetch_add(1);
+            m_wakeup.wait(lock, [this] { return m_stop || m_queued.load() != 0; });
+            m_sleeping.fetch_sub(1);
+            if (m_stop) {
+                return;
+            }
         }
     }
-    return *this;
-}
 
-TomlValue& TomlValue::operator=(TomlValue&& other) noexcept {
-    if (this != &other) {
-        destroyValue();
-        m_type               = other.m_type;
-        m_value              = other.m_value;
-        other.m_type         = TomlType::Object;
-        other.m_value.object = nullptr;
+    /**
+     * @brief 记录第一个异常，并让尚未开始的区间跳过执行。
+     */
+    void fail(std::exception_ptr error) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_error) {
+            m_error = std::move(error);
+        }
+        m_failed.store(true, std::memory_order_relaxed);
     }
-    return *this;
-}
 
-TomlValue::~TomlValue() {
-    destroyValue();
+  private:
+    std::vector<Queue>       m_queues;          ///< 每个线程的任务队列，0 号属于调用 run() 的线程
+    std::vector<std::thread> m_workers;         ///< 工作线程
+    std::atomic<size_t>      m_queued{0};       ///< 所有队列中的任务数
+    std::atomic<size_t>      m_sleeping{0};     ///< 正在休眠的工作线程数
+    std::atomic<bool>        m_failed{false};   ///< 是否有任务抛出了异常
+    std::mutex               m_mutex;           ///< 保护 m_stop、m_error，配合 m_wakeup 使用
+    std::condition_variable  m_wakeup;          ///< 有新任务或需要退出
+    std::exception_ptr       m_error;           ///< 第一个异常
+    bool                     m_stop = false;    ///< 是否需要退出
+};
+
+constexpr size_t kTasksPerThread = 8;    ///< 根节点期望切分出的任务数 = 线程数 × 此值
+constexpr size_t kForkWidth      = 256;  ///< 子节点不少于 2 倍此数的宽节点总会切分
+constexpr size_t kMaxForkDepth   = 64;   ///< 超过此深度的子树不再切分
+
+/**
+ * @brief 解析线程数参数，0 表示使用硬件并发数。
+ */
+size_t resolveThreads(size_t threads) {
+    return threads != 0 ? threads : std::max<size_t>(1, std::thread::hardware_concurrency());
 }
 
-TomlValue::operator bool() const {
-    if (!isBoolean()) {
-        throw TomlException("Cannot convert to bool");
+/**
+ * @brief 计算节点的子节点是否切分以及每个任务负责的子节点数。
+ *
+ * budget 是该子树期望切分出的任务数，根为线程数 × kTasksPerThread，按子节点数均分给
+ * 子节点；预算不足时只有宽节点按每 kForkWidth 个子节点一个任务切分。
+ *
+ * @param size 子节点数。
+ * @param budget 期望的任务数。
+ * @param depth 节点深度。
+ * @return 每个任务的子节点数，0 表示在当前线程中串行处理整棵子树。
+ */
+size_t forkGrain(size_t size, size_t budget, size_t depth) {
+    if (size < 2 || depth >= kMaxForkDepth) {
+        return 0;
     }
-    return m_value.boolean;
+    size_t tasks = std::max(std::min(size, budget), size / kForkWidth);
+    return tasks < 2 ? 0 : (size + tasks - 1) / tasks;
 }
 
-TomlValue::operator int16_t() const {
-    if (!isNumber()) {
-        throw TomlException("Cannot convert to int16_t");
+/**
+ * @brief 并行拷贝子树：需要切分时先建立容器与占位的子节点，再并行填充各子节点。
+ */
+void copyTree(ForkJoinPool&    pool,
+              const TomlValue& source,
+              TomlValue&       target,
+              size_t           budget,
+              size_t           depth) {
+    size_t size  = childCount(source);
+    size_t grain = forkGrain(size, budget, depth);
+    if (grain == 0) {
+        target = source;
+        return;
     }
-    if (m_type == TomlType::Integer) {
-        return static_cast<int16_t>(m_value.iNumber);
+#if defined(CCTOML_USE_PMR)
+    // 与拷贝构造一致, 容器沿用源值的资源
+    TomlResourceScope scope(source.resource());
+#endif
+    std::vector<std::pair<const TomlValue*, TomlValue*>> children;
+    children.reserve(size);
+    if (source.isArray()) {
+        target = TomlValue(TomlArray());
+        auto& array = target.asArray();
+        array.resize(size, TomlValue(false));
+        for (size_t i = 0; i < size; ++i) {
+            children.emplace_back(&source.asArray()[i], &array[i]);
+        }
+    } else {
+        target = TomlValue(TomlObject());
+        auto& object = target.asObject();
+        for (const auto& [key, value] : source.asObject()) {
+            auto it = object.emplace_hint(object.end(), key, TomlValue(false));
+            children.emplace_back(&value, &it->second);
+        }
     }
-    return static_cast<int16_t>(m_value.dNumber);
+    pool.parallelFor(0, size, grain, [&](size_t i) {
+        copyTree(pool, *children[i].first, *children[i].second, budget / size, depth + 1);
+    });
 }
 
-TomlValue::operator int32_t() const {
-    if (!isNumber()) {
-        throw TomlException("Cannot convert to int32_t");
+/**
+ * @brief 并行比较子树，发现不相等后其余任务尽快结束。
+ */
+void compareTree(ForkJoinPool&      pool,
+                 const TomlValue&   lhs,
+                 const TomlValue&   rhs,
+                 size_t             budget,
+                 size_t             depth,
+                 std::atomic<bool>& differ) {
+    if (differ.load(std::memory_order_relaxed)) {
+        return;
     }
-    if (m_type == TomlType::Integer) {
-        return static_cast<int32_t>(m_value.iNumber);
+    if (!shallowEqual(lhs, rhs)) {
+        differ.store(true, std::memory_order_relaxed);
+        return;
     }
-    return static_cast<int32_t>(m_value.dNumber);
+    size_t size  = childCount(lhs);
+    size_t grain = forkGrain(size, budget, depth);
+    if (grain == 0) {
+        if (!(lhs == rhs)) {
+            differ.store(true, std::memory_order_relaxed);
+        }
+        return;
+    }
+    std::vector<std::pair<const TomlValue*, const TomlValue*>> children;
+    children.reserve(size);
+    pairChildren(lhs, rhs, children);
+    pool.parallelFor(0, size, grain, [&](size_t i) {
+        compareTree(pool, *children[i].first, *children[i].second, budget / size, depth + 1,
+                    differ);
+    });
 }
 
-TomlValue::operator int64_t() const {
-    if (!isNumber()) {
-        throw TomlException("Cannot convert to int64_t");
-    }
-    if (m_type == TomlType::Integer) {
-        return m_value.iNumber;
+/**
+ * @brief 按先序列出容器的子节点。
+ */
+std::vector<const TomlValue*> listChildren(const TomlValue& node) {
+    std::vector<const TomlValue*> children;
+    children.reserve(childCount(node));
+    if (node.isArray()) {
+        for (const auto& child : node.asArray()) {
+            children.push_back(&child);
+        }
+    } else {
+        for (const auto& [_, child] : node.asObject()) {
+            children.push_back(&child);
+        }
     }
-    return static_cast<int64_t>(m_value.dNumber);
+    return children;
 }
 
-TomlValue::operator float() const {
-    if (!isNumber()) {
-        throw TomlException("Cannot convert to float");
+/**
+ * @brief 并行计算子树的哈希，各子节点的结果按顺序拼接在节点自身的摘要之后。
+ */
+TreeHash hashTree(ForkJoinPool& pool, const TomlValue& node, size_t budget, size_t depth) {
+    size_t size  = childCount(node);
+    size_t grain = forkGrain(size, budget, depth);
+    if (grain == 0) {
+        return hashTree(node);
     }
-    if (m_type == TomlType::Double) {
-        return static_cast<float>(m_value.dNumber);
+    auto                  children = listChildren(node);
+    std::vector<TreeHash> results(size);
+    pool.parallelFor(0, size, grain, [&](size_t i) {
+        results[i] = hashTree(pool, *children[i], budget / size, depth + 1);
+    });
+    TreeHash result;
+    result.append(nodeToken(node));
+    for (const auto& child : results) {
+        result.append(child);
     }
-    return static_cast<float>(m_value.iNumber);
+    return result;
 }
 
-TomlValue::operator double() const {
-    if (!isNumber()) {
-        throw TomlException("Cannot convert to double");
+/**
+ * @brief 并行统计子树的内存。
+ */
+TomlMemoryUsage
+usageOfTree(ForkJoinPool& pool, const TomlValue& node, size_t budget, size_t depth) {
+    size_t size  = childCount(node);
+    size_t grain = forkGrain(size, budget, depth);
+    if (grain == 0) {
+        return node.memoryUsage();
     }
-    if (m_type == TomlType::Double) {
-        return m_value.dNumber;
+    auto                         children = listChildren(node);
+    std::vector<TomlMemoryUsage> results(size);
+    pool.parallelFor(0, size, grain, [&](size_t i) {
+        results[i] = usageOfTree(pool, *children[i], budget / size, depth + 1);
+    });
+    TomlMemoryUsage usage;
+    addNodeUsage(node, usage);
+    for (const auto& child : results) {
+        usage += child;
     }
-    return static_cast<double>(m_value.iNumber);
+    return usage;
 }
+}  // namespace
 
-TomlValue::operator std::string() const {
-    if (!isString()) {
-        throw TomlException("Cannot convert to string");
+TomlValue TomlValue::copyParallel(size_t threads) const {
+    threads = resolveThreads(threads);
+    if (threads == 1) {
+        return *this;
     }
-    return *m_value.string;
+    TomlValue    result(false);
+    ForkJoinPool pool(threads);
+    pool.run([&] { copyTree(pool, *this, result, threads * kTasksPerThread, 0); });
+    return result;
 }
 
-void TomlValue::destroyValue() noexcept {
-    switch (m_type) {
-        // 动态分配的内存
-        case TomlType::String:
-            delete m_value.string;
-            m_value.string = nullptr;
-            break;
-        case TomlType::Date:
-            delete m_value.date;
-            m_value.date = nullptr;
-            break;
-        case TomlType::Array:
-            delete m_value.array;
-            m_value.array = nullptr;
-            break;
-        case TomlType::Object:
-            delete m_value.object;
-            m_value.object = nullptr;
-            break;
-        default: break;
+bool TomlValue::equalsParallel(const TomlValue& other, size_t threads) const {
+    threads = resolveThreads(threads);
+    if (threads == 1 || this == &other) {
+        return *this == other;
     }
+    std::atomic<bool> differ{false};
+    ForkJoinPool      pool(threads);
+    pool.run([&] { compareTree(pool, *this, other, threads * kTasksPerThread, 0, differ); });
+    return !differ.load();
 }
 
-TomlValue& TomlValue::insert(const std::string& key, const TomlValue& value) {
-    if (m_type != TomlType::Object) {
-        destroyValue();
-        m_type         = TomlType::Object;
-        m_value.object = new TomlObject();
+size_t TomlValue::hashParallel(size_t threads) const {
+    threads = resolveThreads(threads);
+    if (threads == 1) {
+        return hash();
     }
-    (*m_value.object)[key] = value;
-    return *this;
+    TreeHash     result;
+    ForkJoinPool pool(threads);
+    pool.run([&] { result = hashTree(pool, *this, threads * kTasksPerThread, 0); });
+    return static_cast<size_t>(result.hash);
 }
 
-TomlValue& TomlValue::push_back(const TomlValue& value) {
-    if (!isArray()) {
-        destroyValue();
-        m_type        = TomlType::Array;
-        m_value.array = new TomlArray();
+TomlMemoryUsage TomlValue::memoryUsageParallel(size_t threads) const {
+    threads = resolveThreads(threads);
+    if (threads == 1) {
+        return memoryUsage();
     }
-    m_value.array->emplace_back(value);
-    return *this;
+    TomlMemoryUsage usage;
+    ForkJoinPool    pool(threads);
+    pool.run([&] { usage = usageOfTree(pool, *this, threads * kTasksPerThread, 0); });
+    return usage;
 }
 
 /*————————————————————————————————————声明————————————————————————————————————————*/
+#if defined(CCTOML_USE_PMR)
+using TomlKeys = std::pmr::vector<TomlString>;  ///< 键路径（元素沿用容器的资源）
+#else
+using TomlKeys = std::vector<TomlString>;  ///< 键路径
+#endif
+
+/**
+ * @brief 在当前线程的资源中构造解析用的临时字符串或键路径（CCTOML_USE_PMR）
+ *
+ * 临时值与最终的 TomlValue 位于同一资源，移入时直接接管存储而无需再复制。
+ *
+ * @tparam T TomlString 或 TomlKeys。
+ * @param args 构造参数。
+ * @return 构造的对象。
+ */
+template <typename T, typename... Args>
+static T makeInResource(Args&&... args) {
+#if defined(CCTOML_USE_PMR)
+    return T(std::forward<Args>(args)..., typename T::allocator_type(TomlValue::currentResource()));
+#else
+    return T(std::forward<Args>(args)...);
+#endif
+}
+
 /**
  * @brief 跳过所有空白字符（空格/制表符/换行符等）
  * @param data 输入的字符串数据（可以是std::string或std::string_view）
@@ -564,11 +3740,12 @@ static void skipUselessChar(const std::string_view& data, size_t& position);
  * @brief 解析 TOML 格式的键值对列表。
  * @param data 输入字符串视图。
  * @param position 当前解析位置（会被更新）
+ * @param maxDepth 值中数组和内联表允许的最大嵌套深度。
  * @return 键值对列表，每个元素为键路径（字符串向量）和值的对。
  * @throws TomlParseException 如果解析失败，抛出异常。
  */
-static std::vector<std::pair<std::vector<std::string>, TomlValue>>
-parseKeyValuePairs(std::string_view data, size_t& position);
+static std::vector<std::pair<TomlKeys, TomlValue>>
+parseKeyValuePairs(std::string_view data, size_t& position, size_t maxDepth);
 
 /**
  * @brief 解析 TOML 格式的布尔值。
@@ -587,7 +3764,7 @@ static TomlValue parseBoolean(const std::string_view& data, size_t& position);
  * @return 表头键列表（支持点分隔的嵌套键）
  * @throws TomlParseException 如果表头格式无效，抛出异常。
  */
-static std::vector<std::string>
+static TomlKeys
 parseTableHeader(const std::string_view& data, size_t& position, bool isArray);
 
 /**
@@ -610,25 +3787,52 @@ parseBareKey(const std::string_view& data, size_t& position, bool isTable = fals
  */
 static TomlString parseQuotedKeys(const std::string_view& data, size_t& position);
 
+/**
+ * @brief 解析 TOML 格式的键路径及其后的 =。
+ * @param data 输入字符串视图。
+ * @param position 当前解析位置（会被更新，结束时位于 = 之后）
+ * @param keys 输出的键路径（支持点分隔的嵌套键，先清空，可复用其容量）
+ * @throws TomlParseException 如果键格式无效或缺少 =，抛出异常。
+ */
+static void parseKeys(const std::string_view& data, size_t& position, TomlKeys& keys);
+
 /**
  * @brief 解析 TOML 格式的键值对。
  * @param data 输入字符串视图。
  * @param position 当前解析位置（会被更新）
+ * @param maxDepth 值中数组和内联表允许的最大嵌套深度。
+ * @param keys 输出的键路径（字符串向量，可复用其容量）
  * @param needCrlf 是否要求键值对后有换行符。
- * @return 键路径（字符串向量）和值的对。
+ * @return 值。
  * @throws TomlParseException 如果键值对格式无效，抛出异常。
  */
-static std::pair<std::vector<TomlString>, TomlValue>
-parseKeyValue(const std::string_view& data, size_t& position, bool needCrlf = true);
+static TomlValue parseKeyValue(const std::string_view& data,
+                               size_t&                 position,
+                               size_t                  maxDepth,
+                               TomlKeys&               keys,
+                               bool                    needCrlf = true);
 
 /**
  * @brief 解析 TOML 格式的任意值（布尔、数字、字符串、日期、数组或对象）
+ *
+ * 数组与内联表使用显式栈迭代解析，嵌套深度不受调用栈限制。
+ *
+ * @param data 输入字符串视图。
+ * @param position 当前解析位置（会被更新）
+ * @param maxDepth 数组和内联表允许的最大嵌套深度。
+ * @return 解析后的 TomlValue 对象。
+ * @throws TomlParseException 如果值格式无效或嵌套过深，抛出异常。
+ */
+static TomlValue parseValue(const std::string_view& data, size_t& position, size_t maxDepth);
+
+/**
+ * @brief 解析 TOML 格式的标量值（布尔、数字、字符串或日期）
  * @param data 输入字符串视图。
  * @param position 当前解析位置（会被更新）
  * @return 解析后的 TomlValue 对象。
  * @throws TomlParseException 如果值格式无效，抛出异常。
  */
-static TomlValue parseValue(const std::string_view& data, size_t& position);
+static TomlValue parseScalarValue(const std::string_view& data, size_t& position);
 
 /**
  * @brief 解析 TOML 格式的数字（整数或浮点数）
@@ -648,24 +3852,6 @@ static TomlValue parseNumber(const std::string_view& data, size_t& position);
  */
 static TomlValue parseNumberOrDate(const std::string_view& data, size_t& position);
 
-/**
- * @brief 解析 TOML 格式的数组。
- * @param data 输入字符串视图。
- * @param position 当前解析位置（会被更新）
- * @return 解析后的数组（封装为 TomlValue）
- * @throws TomlParseException 如果数组格式无效，抛出异常。
- */
-static TomlValue parseArray(const std::string_view& data, size_t& position);
-
-/**
- * @brief 解析 TOML 格式的内联对象。
- * @param data 输入字符串视图。
- * @param position 当前解析位置（会被更新）
- * @return 解析后的对象（封装为 TomlValue）
- * @throws TomlParseException 如果对象格式无效，抛出异常。
- */
-static TomlValue parseObject(const std::string_view& data, size_t& position);
-
 /**
  * @brief 解析 TOML 格式的字符串（基本字符串、字面字符串、多行字符串等）
  * @param data 输入字符串视图。
@@ -676,13 +3862,16 @@ static TomlValue parseObject(const std::string_view& data, size_t& position);
 static TomlValue parseString(const std::string_view& data, size_t& position);
 
 /**
- * @brief 解析 TOML 格式的 Unicode 转义字符串（\\uXXXX 或 \\UXXXXXXXX）
- * @param data 输入字符串视图。
+ * @brief 解析 TOML 格式的 Unicode 转义（\\uXXXX 或 \\UXXXXXXXX），直接以 UTF-8 追加到结果中。
+ *
+ * 紧随其后的连续 Unicode 转义会在同一次调用中一并解码。
+ *
+ * @param data 输入字符串视图（position 指向 u 或 U）
  * @param position 当前解析位置（会被更新）
- * @return 解析后的 Unicode 字符串。
+ * @param result 解码结果追加到的字符串。
  * @throws TomlParseException 如果 Unicode 转义格式无效或码点非法，抛出异常。
  */
-static std::string parseUnicodeString(const std::string_view& data, size_t& position);
+static void parseUnicodeEscape(const std::string_view& data, size_t& position, TomlString& result);
 
 /**
  * @brief 解析 TOML 格式的基本字符串（带引号，支持转义）
@@ -691,7 +3880,7 @@ static std::string parseUnicodeString(const std::string_view& data, size_t& posi
  * @return 解析后的字符串。
  * @throws TomlParseException 如果字符串格式无效或包含非法字符，抛出异常。
  */
-static std::string parseBasicString(const std::string_view& data, size_t& position);
+static TomlString parseBasicString(const std::string_view& data, size_t& position);
 
 /**
  * @brief 解析 TOML 格式的多行基本字符串（""" 开头，支持转义和换行）
@@ -700,7 +3889,7 @@ static std::string parseBasicString(const std::string_view& data, size_t& positi
  * @return 解析后的字符串。
  * @throws TomlParseException 如果字符串格式无效或包含非法字符，抛出异常。
  */
-static std::string parseMultiBasicString(const std::string_view& data, size_t& position);
+static TomlString parseMultiBasicString(const std::string_view& data, size_t& position);
 
 /**
  * @brief 解析 TOML 格式的字面字符串（单引号，不支持转义）
@@ -709,7 +3898,7 @@ static std::string parseMultiBasicString(const std::string_view& data, size_t& p
  * @return 解析后的字符串。
  * @throws TomlParseException 如果字符串格式无效或包含非法字符，抛出异常。
  */
-static std::string parseLiteralString(const std::string_view& data, size_t& position);
+static TomlString parseLiteralString(const std::string_view& data, size_t& position);
 
 /**
  * @brief 解析 TOML 格式的多行字面字符串（''' 开头，不支持转义）
@@ -718,7 +3907,7 @@ static std::string parseLiteralString(const std::string_view& data, size_t& posi
  * @return 解析后的字符串。
  * @throws TomlParseException 如果字符串格式无效或包含非法字符，抛出异常。
  */
-static std::string parseMultiLiteralString(const std::string_view& data, size_t& position);
+static TomlString parseMultiLiteralString(const std::string_view& data, size_t& position);
 
 /**
  * @brief 快速检查字符串的某个位置是否“看起来像”一个TOML日期或时间的开始。
@@ -734,17 +3923,6 @@ static std::string parseMultiLiteralString(const std::string_view& data, size_t&
  */
 static bool looksLikeDateTime(const std::string_view& sv, size_t position) noexcept;
 
-/**
- * @brief 精确、高性能地验证一个字符串视图是否完全匹配TOML的四种日期时间格式之一。
- *
- * 此函数为自包含的单函数实现，严格遵循TOML v1.0.0规范，<br/>
- * 其中包括允许使用 'T', 't', 或空格作为日期和时间的分隔符。
- *
- * @param data 要验证的完整字符串视图。
- * @return 如果完全匹配，则为 true，否则为 false。
- */
-static bool matchFullDateTime(const std::string_view& data) noexcept;
-
 /*———————————————————————————————————实现———————————————————————————————————————————*/
 
 static void skipWhitespace(const std::string_view& data, size_t& position) noexcept {
@@ -808,9 +3986,9 @@ static void skipUselessChar(const std::string_view& data, size_t& position) {
     }
 }
 
-static std::vector<std::pair<std::vector<std::string>, TomlValue>>
-parseKeyValuePairs(std::string_view data, size_t& position) {
-    std::vector<std::pair<std::vector<std::string>, TomlValue>> keyValues;
+static std::vector<std::pair<TomlKeys, TomlValue>>
+parseKeyValuePairs(std::string_view data, size_t& position, size_t maxDepth) {
+    std::vector<std::pair<TomlKeys, TomlValue>> keyValues;
     // 不断解析顶层或当前table的key-value对
     while (position < data.size()) {
         skipUselessChar(data, position);
@@ -819,7 +3997,9 @@ parseKeyValuePairs(std::string_view data, size_t& position) {
             break;
         }
         // 解析key-value
-        keyValues.emplace_back(parseKeyValue(data, position));
+        auto keys  = makeInResource<TomlKeys>();
+        auto value = parseKeyValue(data, position, maxDepth, keys);
+        keyValues.emplace_back(std::move(keys), std::move(value));
     }
 
     return keyValues;
@@ -837,13 +4017,13 @@ TomlValue parseBoolean(const std::string_view& data, size_t& position) {
     throw TomlParseException("Expected 'true' or 'false'", position);
 }
 
-std::vector<std::string>
+TomlKeys
 parseTableHeader(const std::string_view& data, size_t& position, bool isArray) {
     // 当前字符一定为[,跳过表头
     position++;
     position += isArray;
-    std::vector<std::string> headers;
-    auto                     size = data.size();
+    auto headers = makeInResource<TomlKeys>();
+    auto size    = data.size();
     // 解析key
     while (position < size) {
         skipWhitespace(data, position);
@@ -878,7 +4058,7 @@ TomlString parseBareKey(const std::string_view& data, size_t& position, bool isT
             if (position - start == 0) {
                 throw TomlParseException("Invalid key", position);
             }
-            return TomlString(data.substr(start, position - start));
+            return makeInResource<TomlString>(data.substr(start, position - start));
         } else {
             break;
         }
@@ -894,11 +4074,10 @@ TomlString parseQuotedKeys(const std::string_view& data, size_t& position) {
     }
 }
 
-std::pair<std::vector<TomlString>, TomlValue>
-parseKeyValue(const std::string_view& data, size_t& position, bool needCrlf) {
+void parseKeys(const std::string_view& data, size_t& position, TomlKeys& keys) {
     // 当前data[position]一定有意义
-    std::vector<TomlString> keys;
-    auto                    size = data.size();
+    keys.clear();
+    auto size = data.size();
     // 解析key
     while (position < size) {
         skipWhitespace(data, position);
@@ -923,8 +4102,17 @@ parseKeyValue(const std::string_view& data, size_t& position, bool needCrlf) {
     } else {
         position++;
     }
+}
+
+TomlValue parseKeyValue(const std::string_view& data,
+                        size_t&                 position,
+                        size_t                  maxDepth,
+                        TomlKeys&               keys,
+                        bool                    needCrlf) {
+    parseKeys(data, position, keys);
+    auto size = data.size();
     // 解析value
-    auto value = parseValue(data, position);
+    auto value = parseValue(data, position, maxDepth);
     skipWhitespaceAndComment(data, position);
     // 换行
     if (needCrlf && position < size &&
@@ -934,12 +4122,10 @@ parseKeyValue(const std::string_view& data, size_t& position, bool needCrlf) {
     } else if (needCrlf && position < size) {
         throw TomlParseException("A line break is required after the value", position);
     }
-    return {keys, value};
+    return value;
 }
 
-TomlValue parseValue(const std::string_view& data, size_t& position) {
-    // 跳过前面的空白
-    skipWhitespace(data, position);
+TomlValue parseScalarValue(const std::string_view& data, size_t& position) {
     // 根据当前字符判断是哪种类型
     char c = data[position];
     if (c == '"' || c == '\'') {
@@ -949,12 +4135,6 @@ TomlValue parseValue(const std::string_view& data, size_t& position) {
         return parseNumberOrDate(data, position);
     } else if (c == 't' || c == 'f') {
         return parseBoolean(data, position);
-    } else if (c == '[') {
-        // 内联表,不可修改
-        return parseArray(data, position);
-    } else if (c == '{') {
-        // 内联表,不可修改
-        return parseObject(data, position);
     } else {
         throw TomlParseException("invalid value", position);
     }
@@ -1135,32 +4315,15 @@ TomlValue parseNumber(const std::string_view& data, size_t& position) {
 }
 
 TomlValue parseNumberOrDate(const std::string_view& data, size_t& position) {
-    size_t original = position;
-    // 判断是否为日期
+    // 判断是否为日期, 是则单遍词法分析（校验与打包一次完成）
     if (looksLikeDateTime(data, position)) {
-        // 完整匹配
-        size_t end         = position;
-        auto   isValidChar = [](char c) -> bool {
-            return std::isalnum(c) || c == '-' || c == ':' || c == 'T' || c == 'Z' || c == '+' ||
-                   c == '.';
-        };
-        while (end < data.size() &&
-               (isValidChar(data[end]) ||
-                (data[end] == ' ' && end + 1 < data.size() && isValidChar(data[end + 1])))) {
-            ++end;
-        }
-        // 可能的日期字符串
-        auto maybeDate = data.substr(position, end - position);
-        // 判断是否为日期
-        if (matchFullDateTime(maybeDate)) {
-            position = end;
-            try {
-                return TomlDate(maybeDate);
-            } catch (const TomlException& e) { throw TomlParseException(e.what(), position); }
+        TomlDate date;
+        if (!TomlDate::lex(data, position, date)) {
+            throw TomlParseException("Invalid date/time literal", position);
         }
+        return date;
     }
-    // 回退并作为普通数值解析
-    position = original;
+    // 作为普通数值解析
     return parseNumber(data, position);
 }
 
@@ -1196,93 +4359,135 @@ static void skipAll(const std::string_view& data, size_t& position) {
  */
 #define PARSE_STATE_NO_VALUE (2)
 
-TomlValue parseArray(const std::string_view& data, size_t& position) {
-    // 当前字符一定为[
-    position++;
-    skipAll(data, position);
-    // 解析以,分割的一个个value (而不是key-value)
-    TomlArray array;
-    // 0 -> init
-    // 1 -> has value
-    // 2 -> no value
-    auto state = PARSE_STATE_INIT;
-    while (position < data.size()) {
-        skipAll(data, position);
-        // 遇到]说明结束了
-        if (data[position] == ']') {
-            position++;
-            return array;
-        }
-        if (state != PARSE_STATE_NO_VALUE) {
-            array.emplace_back(parseValue(data, position));
-        } else {
-            throw TomlParseException("Unexpected value after empty array element", position);
-        }
-        skipAll(data, position);
-        // 如果为,则说明还有值,否则则应该return了
-        if (position < data.size() && data[position] == ',') {
-            position++;
-            state = PARSE_STATE_HAS_VALUE;
+/**
+ * @brief 迭代解析数组/内联表时的栈帧。
+ */
+struct NestedFrame {
+    TomlValue container;  ///< 正在构造的数组或内联表
+    TomlKeys  keys;       ///< 内联表中当前值的键路径
+    int       state;      ///< 解析状态（PARSE_STATE_*）
+};
+
+/**
+ * @brief 将解析完成的值放入栈顶的数组或内联表中。
+ * @param frame 栈顶帧。
+ * @param value 解析完成的值。
+ * @param position 当前解析位置（用于报错）
+ * @throws TomlParseException 如果内联表的键路径与已有值冲突，抛出异常。
+ */
+static void appendNestedValue(NestedFrame& frame, TomlValue&& value, size_t position) {
+    if (frame.container.isArray()) {
+        frame.container.asArray().emplace_back(std::move(value));
+        return;
+    }
+    auto        node = &frame.container;
+    const auto& ks   = frame.keys;
+    for (size_t i = 0; !ks.empty() && i < ks.size() - 1; i++) {
+        // 这里的node必须为object,因为内联表里为key-value形式，但array内只有value形式
+        if (node->isObject()) {
+            node = &(*node)[ks[i]];
         } else {
-            state = PARSE_STATE_NO_VALUE;
+            throw TomlParseException("Cannot create nested key: parent is not an object", position);
         }
     }
-    throw TomlParseException("Unclosed array: missing ']'", position);
+    // 最后获取的node也必须为object
+    if (node->isObject()) {
+        node->asObject()[ks.back()] = std::move(value);
+    } else {
+        throw TomlParseException("Cannot insert value: target is not an object", position);
+    }
 }
 
-TomlValue parseObject(const std::string_view& data, size_t& position) {
-    // 当前一定为{ (object不同于array,不允许换行)
-    position++;
-    TomlValue object;
-    // 0 -> init
-    // 1 -> has value
-    // 2 -> no value
-    auto state = PARSE_STATE_INIT;
-    while (position < data.size()) {
-        skipWhitespaceAndComment(data, position);
-        if (data[position] == '}') {
-            // 在内联表中的最后一个键/值对之后，不允许终止逗号
-            if (state != PARSE_STATE_HAS_VALUE) {
-                position++;
-                return object;
-            } else {
-                break;
-            }
+TomlValue parseValue(const std::string_view& data, size_t& position, size_t maxDepth) {
+    // 跳过前面的空白
+    skipWhitespace(data, position);
+    if (position >= data.size()) {
+        throw TomlParseException("invalid value", position);
+    }
+    char c = data[position];
+    if (c != '[' && c != '{') {
+        return parseScalarValue(data, position);
+    }
+    // 数组(以,分割的一个个value)与内联表(以,分割的key-value, 不允许换行)共用一个显式栈
+    std::vector<NestedFrame> stack;
+    TomlValue                value;
+    while (true) {
+        // 此时data[position]一定为[或{
+        if (stack.size() >= maxDepth) {
+            throw TomlParseException("Maximum nesting depth exceeded", position);
         }
-        if (state != PARSE_STATE_NO_VALUE) {
-            // 解析一个个key-value
-            auto node    = &object;
-            auto [ks, v] = parseKeyValue(data, position, false);
-            for (size_t i = 0; !ks.empty() && i < ks.size() - 1; i++) {
-                // 这里的node必须为object,因为内联表里为key-value形式，但array内只有value形式
-                if (node->isObject()) {
-                    node = &(*node)[ks[i]];
-                } else {
-                    throw TomlParseException("Cannot create nested key: parent is not an object",
+        stack.push_back({c == '[' ? TomlValue(TomlArray()) : TomlValue(),
+                         makeInResource<TomlKeys>(), PARSE_STATE_INIT});
+        position++;
+        while (true) {
+            auto& frame  = stack.back();
+            bool  closed = false;
+            if (frame.container.isArray()) {
+                skipAll(data, position);
+                if (position >= data.size()) {
+                    throw TomlParseException("Unclosed array: missing ']'", position);
+                }
+                // 遇到]说明结束了
+                if (data[position] == ']') {
+                    position++;
+                    closed = true;
+                } else if (frame.state == PARSE_STATE_NO_VALUE) {
+                    throw TomlParseException("Unexpected value after empty array element",
+                                             position);
+                }
+            } else {
+                skipWhitespaceAndComment(data, position);
+                if (position >= data.size()) {
+                    throw TomlParseException("Unclosed object: missing '}'", position);
+                }
+                if (data[position] == '}') {
+                    // 在内联表中的最后一个键/值对之后，不允许终止逗号
+                    if (frame.state == PARSE_STATE_HAS_VALUE) {
+                        throw TomlParseException("Unclosed object: missing '}'", position);
+                    }
+                    position++;
+                    closed = true;
+                } else if (frame.state == PARSE_STATE_NO_VALUE) {
+                    throw TomlParseException("Unexpected value after empty array element",
                                              position);
+                } else {
+                    parseKeys(data, position, frame.keys);
                 }
             }
-            // 最后获取的node也必须为object
-            if (node->isObject()) {
-                node->insert(ks.back(), v);
+            if (closed) {
+                value = std::move(frame.container);
+                stack.pop_back();
+                if (stack.empty()) {
+                    return value;
+                }
             } else {
-                throw TomlParseException("Cannot insert value: target is not an object", position);
+                skipWhitespace(data, position);
+                if (position >= data.size()) {
+                    throw TomlParseException("invalid value", position);
+                }
+                c = data[position];
+                if (c == '[' || c == '{') {
+                    // 进入下一层
+                    break;
+                }
+                value = parseScalarValue(data, position);
+            }
+            // 值已完成, 放入外层容器并检查是否还有值
+            auto& parent = stack.back();
+            appendNestedValue(parent, std::move(value), position);
+            if (parent.container.isArray()) {
+                skipAll(data, position);
+            } else {
+                skipWhitespaceAndComment(data, position);
+            }
+            if (position < data.size() && data[position] == ',') {
+                position++;
+                parent.state = PARSE_STATE_HAS_VALUE;
+            } else {
+                parent.state = PARSE_STATE_NO_VALUE;
             }
-        } else {
-            throw TomlParseException("Unexpected value after empty array element", position);
-        }
-
-        // 跳过空白及注释
-        skipWhitespaceAndComment(data, position);
-        // 判断是否还有值
-        if (position < data.size() && data[position] == ',') {
-            state = PARSE_STATE_HAS_VALUE;
-            position++;
-        } else {
-            state = PARSE_STATE_NO_VALUE;
         }
     }
-    throw TomlParseException("Unclosed object: missing '}'", position);
 }
 
 #undef SKIP_ALL
@@ -1337,57 +4542,99 @@ TomlValue parseString(const std::string_view& data, size_t& position) {
     }
 }
 
-std::string parseUnicodeString(const std::string_view& data, size_t& position) {
-    auto parseHex = [&](int length) {
-        if (position + length >= data.size()) {
+/**
+ * @brief 十六进制字符到数值的查找表，非十六进制字符为 0xF0（高半字节非零即表示非法）
+ */
+static constexpr auto kHexDigitValues = [] {
+    std::array<uint8_t, 256> table{};
+    for (auto& value : table) {
+        value = 0xF0;
+    }
+    for (int i = 0; i < 10; ++i) {
+        table['0' + i] = static_cast<uint8_t>(i);
+    }
+    for (int i = 0; i < 6; ++i) {
+        table['a' + i] = table['A' + i] = static_cast<uint8_t>(10 + i);
+    }
+    return table;
+}();
+
+/**
+ * @brief 将码点以 UTF-8 编码写入缓冲区。
+ * @param codePoint 合法的 Unicode 标量值。
+ * @param out 输出缓冲区（至少 4 字节）
+ * @return 写入的字节数。
+ */
+static inline size_t encodeUtf8(uint32_t codePoint, char* out) noexcept {
+    if (codePoint <= 0x7F) {
+        out[0] = static_cast<char>(codePoint);
+        return 1;
+    }
+    if (codePoint <= 0x7FF) {
+        out[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+        out[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        return 2;
+    }
+    if (codePoint <= 0xFFFF) {
+        out[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+        out[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+    out[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    return 4;
+}
+
+void parseUnicodeEscape(const std::string_view& data, size_t& position, TomlString& result) {
+    // 连续的转义（常见于转义后的 CJK 文本）在此循环内一次性解码, 避免每个转义都回到调用方
+    while (true) {
+        // 获取unicode位数
+        const size_t hexLength = data[position++] == 'u' ? 4 : 8;
+        if (position + hexLength >= data.size()) {
             throw TomlParseException("Unexpected end in Unicode escape", position);
         }
-        // 获取字符串
-        auto hex = data.substr(position, length);
-        position += length;
-        int32_t codePoint;
-        auto [ptr, ec] = std::from_chars(hex.data(), hex.data() + hex.size(), codePoint, 16);
-        if (ec != std::errc() || ptr != hex.data() + hex.size()) {
-            throw TomlParseException("Invalid hexadecimal string " + std::string(hex), position);
+        // 查表累加, 非法字符只在最后统一判断
+        uint32_t codePoint = 0;
+        uint8_t  invalid   = 0;
+        for (size_t i = 0; i < hexLength; ++i) {
+            const uint8_t value = kHexDigitValues[static_cast<unsigned char>(data[position + i])];
+            invalid |= value;
+            codePoint = (codePoint << 4) | (value & 0x0F);
         }
-        return codePoint;
-    };
-    // 获取unicode位数
-    auto hexLength = data[position++] == 'u' ? 4 : 8;
-    // 解析出码点
-    auto codePoint = parseHex(hexLength);
-    // 校验码点是否为合法的 Unicode 标量值, toml不允许代理对
-    if (codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
-        // 处理非法码点
-        throw TomlParseException(
-            "Invalid Unicode code point: " +
-                std::string(data.substr(position - hexLength - 2, hexLength + 2)),
-            position);
-    }
-    std::string result;
-    if (codePoint <= 0x7F) {
-        result += static_cast<char>(codePoint);
-    } else if (codePoint <= 0x7FF) {
-        result += static_cast<char>(0xC0 | (codePoint >> 6));
-        result += static_cast<char>(0x80 | (codePoint & 0x3F));
-    } else if (codePoint <= 0xFFFF) {
-        result += static_cast<char>(0xE0 | (codePoint >> 12));
-        result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
-        result += static_cast<char>(0x80 | (codePoint & 0x3F));
-    } else {
-        result += static_cast<char>(0xF0 | (codePoint >> 18));
-        result += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
-        result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
-        result += static_cast<char>(0x80 | (codePoint & 0x3F));
+        position += hexLength;
+        if (invalid & 0xF0) {
+            throw TomlParseException(
+                "Invalid hexadecimal string " +
+                    std::string(data.substr(position - hexLength, hexLength)),
+                position);
+        }
+        // 校验码点是否为合法的 Unicode 标量值, toml不允许代理对
+        if (codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+            // 处理非法码点
+            throw TomlParseException(
+                "Invalid Unicode code point: " +
+                    std::string(data.substr(position - hexLength - 2, hexLength + 2)),
+                position);
+        }
+        char buffer[4];
+        result.append(buffer, encodeUtf8(codePoint, buffer));
+        // 下一个仍是 Unicode 转义则跳过反斜杠继续解码
+        if (position + 1 >= data.size() || data[position] != '\\' ||
+            (data[position + 1] != 'u' && data[position + 1] != 'U')) {
+            return;
+        }
+        ++position;
     }
-    return result;
 }
 
-std::string parseBasicString(const std::string_view& data, size_t& position) {
+TomlString parseBasicString(const std::string_view& data, size_t& position) {
     // 跳过"
     ++position;
 
-    std::string result;
+    auto result = makeInResource<TomlString>();
     while (position < data.size()) {
         char c = data[position];
         // 结束符
@@ -1425,7 +4672,7 @@ std::string parseBasicString(const std::string_view& data, size_t& position) {
                 case 'U':
                     // 回退为\u
                     --position;
-                    result += parseUnicodeString(data, position);
+                    parseUnicodeEscape(data, position, result);
                     break;
                 default:
                     throw TomlParseException("Unknown escape: \\" + std::string(1, esc), position);
@@ -1434,20 +4681,29 @@ std::string parseBasicString(const std::string_view& data, size_t& position) {
             if (c == '\r' || c == '\n') {
                 throw TomlParseException("Line wrapping is not allowed in Basic String", position);
             }
-            result += c;
-            ++position;
+            // 连续的普通字符整段追加, 遇到引号、反斜杠或控制字符时回到上面逐个处理
+            size_t end = position + 1;
+            while (end < data.size()) {
+                auto next = static_cast<unsigned char>(data[end]);
+                if (next == '"' || next == '\\' || (next <= 0x1F && next != '\t') || next == 0x7F) {
+                    break;
+                }
+                ++end;
+            }
+            result.append(data.data() + position, end - position);
+            position = end;
         }
     }
     throw TomlParseException("Unterminated basic string", position);
 }
 
-std::string parseMultiBasicString(const std::string_view& data, size_t& position) {
+TomlString parseMultiBasicString(const std::string_view& data, size_t& position) {
     // 此时当前字符串一定为"""
     position += 3;
     // 跳过开头的换行符（如果存在）
     skipCrlf(data, position);
-    std::string result;
-    bool        inEscape = false;  // 标记是否处于转义状态
+    auto result   = makeInResource<TomlString>();
+    bool inEscape = false;  // 标记是否处于转义状态
     while (position < data.size()) {
         // 遇到结束标识
         if (!inEscape && MATCH3(data, position, '"')) {
@@ -1517,7 +4773,7 @@ std::string parseMultiBasicString(const std::string_view& data, size_t& position
                 case 'u':
                 case 'U':
                     --position;  // 回退以解析Unicode
-                    result += parseUnicodeString(data, position);
+                    parseUnicodeEscape(data, position, result);
                     break;
                 default:
                     throw TomlParseException("Unknown escape in multi-line: \\" + std::string(1, c),
@@ -1532,10 +4788,10 @@ std::string parseMultiBasicString(const std::string_view& data, size_t& position
     throw TomlParseException("Unterminated multi-line basic string", position);
 }
 
-std::string parseLiteralString(const std::string_view& data, size_t& position) {
+TomlString parseLiteralString(const std::string_view& data, size_t& position) {
     // 跳过开头的'
     ++position;
-    std::string result;
+    auto result = makeInResource<TomlString>();
     while (position < data.size()) {
         char c = data[position];
 
@@ -1556,11 +4812,11 @@ std::string parseLiteralString(const std::string_view& data, size_t& position) {
     throw TomlParseException("Unterminated literal string", position);
 }
 
-std::string parseMultiLiteralString(const std::string_view& data, size_t& position) {
+TomlString parseMultiLiteralString(const std::string_view& data, size_t& position) {
     position += 3;
     // 跳过开头的换行符（如果存在）
     skipCrlf(data, position);
-    std::string result;
+    auto result = makeInResource<TomlString>();
     result.reserve(32);
     while (position < data.size()) {
         char c = data[position];
@@ -1612,129 +4868,401 @@ bool looksLikeDateTime(const std::string_view& sv, size_t position) noexcept {
     return false;
 }
 
-bool matchFullDateTime(const std::string_view& data) noexcept {
-    if (data.empty()) {
-        return false;
-    }
+/*———————————————————————————————————UTF-8 校验—————————————————————————————————————————*/
+// 向量化实现采用查表法（Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per
+// Byte"）：用前一字节的高/低半字节和当前字节的高半字节分别查 16 项表，三者按位与后非零即为错误。
 
-    size_t       position = 0;
-    const size_t size     = data.size();
+/**
+ * @brief 错误类别位：查表结果中每一位代表一类非法的相邻字节组合。
+ */
+#define UTF8_TOO_SHORT (1 << 0)  ///< 11______ 0_______ 或 11______ 11______
+#define UTF8_TOO_LONG (1 << 1)   ///< 0_______ 10______
+#define UTF8_OVERLONG_3 (1 << 2) ///< 11100000 100_____
+#define UTF8_TOO_LARGE (1 << 3)  ///< 11110100 1001____ 等（码点大于 U+10FFFF）
+#define UTF8_SURROGATE (1 << 4)  ///< 11101101 101_____
+#define UTF8_OVERLONG_2 (1 << 5) ///< 1100000_ 10______
+#define UTF8_TOO_LARGE_1000 (1 << 6)  ///< 11110101 1000____ 等
+#define UTF8_OVERLONG_4 (1 << 6)      ///< 11110000 1000____
+#define UTF8_TWO_CONTS (1 << 7)       ///< 10______ 10______
+#define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
 
-    // -----------------------------------------------------------------
-    // 分支 1: 尝试解析以日期 (YYYY-MM-DD) 开头的格式
-    // -----------------------------------------------------------------
-    if (size >= 10 && IS_DIGIT(data[0]) && IS_DIGIT(data[1]) && IS_DIGIT(data[2]) &&
-        IS_DIGIT(data[3]) && (data[4] == '-') && IS_DIGIT(data[5]) && IS_DIGIT(data[6]) &&
-        (data[7] == '-') && IS_DIGIT(data[8]) && IS_DIGIT(data[9])) {
-        // 检查月份和日期的数值范围
-        const int month = (data[5] - '0') * 10 + (data[6] - '0');
-        const int day   = (data[8] - '0') * 10 + (data[9] - '0');
+/**
+ * @brief 以前一字节的高半字节为索引的查找表。
+ */
+alignas(16) static constexpr uint8_t kUtf8Byte1High[16] = {
+    // 0_______ ________ <前一字节为 ASCII>
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TOO_LONG, UTF8_TOO_LONG,
+    // 10______ ________ <前一字节为后续字节>
+    UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+    // 1100____ ________ <两字节序列首字节>
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+    // 1101____ ________ <两字节序列首字节>
+    UTF8_TOO_SHORT,
+    // 1110____ ________ <三字节序列首字节>
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+    // 1111____ ________ <四字节序列首字节>
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4};
 
-        if (month >= 1 && month <= 12 && day >= 1 && day <= 31) {
-            // ---- 日期部分有效 ----
-            position = 10;
+/**
+ * @brief 以前一字节的低半字节为索引的查找表。
+ */
+alignas(16) static constexpr uint8_t kUtf8Byte1Low[16] = {
+    // ____0000 ________
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+    // ____0001 ________
+    UTF8_CARRY | UTF8_OVERLONG_2,
+    // ____001_ ________
+    UTF8_CARRY, UTF8_CARRY,
+    // ____0100 ________
+    UTF8_CARRY | UTF8_TOO_LARGE,
+    // ____0101 ________
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    // ____011_ ________
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    // ____1___ ________
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    // ____1101 ________
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000};
 
-            // 如果字符串到此结束, 则是合法的 Local Date
-            if (position == size) {
-                return true;
-            }
+/**
+ * @brief 以当前字节的高半字节为索引的查找表。
+ */
+alignas(16) static constexpr uint8_t kUtf8Byte2High[16] = {
+    // ________ 0_______ <当前字节为 ASCII>
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    // ________ 1000____
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 |
+        UTF8_OVERLONG_4,
+    // ________ 1001____
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+    // ________ 101_____
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    // ________ 11______
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT};
 
-            // 如果后面有内容, 分隔符必须是 'T', 't', 或空格
-            if (data[position] != 'T' && data[position] != 't' && data[position] != ' ') {
-                return false;
-            }
-            position++;  // 消耗分隔符
+/**
+ * @brief 块末尾未完成序列的阈值：倒数第 3/2/1 个字节分别不小于 0xF0/0xE0/0xC0 时说明序列被截断。
+ */
+alignas(16) static constexpr uint8_t kUtf8IncompleteMax[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1};
+
+#undef UTF8_TOO_SHORT
+#undef UTF8_TOO_LONG
+#undef UTF8_OVERLONG_3
+#undef UTF8_TOO_LARGE
+#undef UTF8_SURROGATE
+#undef UTF8_OVERLONG_2
+#undef UTF8_TOO_LARGE_1000
+#undef UTF8_OVERLONG_4
+#undef UTF8_TWO_CONTS
+#undef UTF8_CARRY
 
-            // ---- 解析时间部分 (hh:mm:ss) ----
-            if (position + 8 > size) {
-                return false;
+/**
+ * @brief 标量查找第一个非法 UTF-8 序列。
+ *
+ * 纯 ASCII 部分每次检查 8 个字节；多字节序列逐个校验长度、后续字节、过长编码、代理对与上限。
+ *
+ * @param data 输入数据。
+ * @param size 数据长度。
+ * @return 第一个非法序列首字节的位置，全部合法时返回 size。
+ */
+static size_t findInvalidUtf8(const unsigned char* data, size_t size) noexcept {
+    size_t position = 0;
+    while (position < size) {
+        // ASCII 快速路径
+        if (position + 8 <= size) {
+            uint64_t block;
+            std::memcpy(&block, data + position, sizeof(block));
+            if ((block & 0x8080808080808080ULL) == 0) {
+                position += 8;
+                continue;
             }
-            const int hour   = (data[position] - '0') * 10 + (data[position + 1] - '0');
-            const int minute = (data[position + 3] - '0') * 10 + (data[position + 4] - '0');
-            const int second = (data[position + 6] - '0') * 10 + (data[position + 7] - '0');
-
-            if (!(IS_DIGIT(data[position]) && IS_DIGIT(data[position + 1]) &&
-                  (data[position + 2] == ':') && IS_DIGIT(data[position + 3]) &&
-                  IS_DIGIT(data[position + 4]) && (data[position + 5] == ':') &&
-                  IS_DIGIT(data[position + 6]) && IS_DIGIT(data[position + 7]) &&
-                  (hour <= 23 && minute <= 59 && second <= 59))) {
-                return false;
+        }
+        const unsigned char lead = data[position];
+        if (lead < 0x80) {
+            ++position;
+            continue;
+        }
+        size_t   length;
+        uint32_t codePoint, minCodePoint;
+        if ((lead & 0xE0) == 0xC0) {
+            length = 2, codePoint = lead & 0x1F, minCodePoint = 0x80;
+        } else if ((lead & 0xF0) == 0xE0) {
+            length = 3, codePoint = lead & 0x0F, minCodePoint = 0x800;
+        } else if ((lead & 0xF8) == 0xF0) {
+            length = 4, codePoint = lead & 0x07, minCodePoint = 0x10000;
+        } else {
+            return position;
+        }
+        if (position + length > size) {
+            return position;
+        }
+        for (size_t i = 1; i < length; ++i) {
+            const unsigned char c = data[position + i];
+            if ((c & 0xC0) != 0x80) {
+                return position;
             }
-            position += 8;
+            codePoint = (codePoint << 6) | (c & 0x3F);
+        }
+        // 过长编码、超出 U+10FFFF 或代理对
+        if (codePoint < minCodePoint || codePoint > 0x10FFFF ||
+            (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+            return position;
+        }
+        position += length;
+    }
+    return size;
+}
 
-            // ---- 解析可选的亚秒部分 (.ffffff) ----
-            if (position < size && data[position] == '.') {
-                position++;
-                const size_t fracStart = position;
-                while (position < size && IS_DIGIT(data[position])) {
-                    position++;
-                }
-                if (position == fracStart)
-                    return false;
-            }
+#if defined(CCTOML_UTF8_SSE41)
+/**
+ * @brief SSE4.1 校验一个 16 字节块，结果累积到 error 中。
+ * @param input 当前块。
+ * @param prevInput 前一个块（会被更新为当前块）
+ * @param error 累积的错误标记。
+ * @param prevIncomplete 前一个块末尾是否有未完成的序列（会被更新）
+ */
+CCTOML_TARGET("sse4.1")
+static inline void
+checkUtf8BlockSse41(__m128i input, __m128i& prevInput, __m128i& error, __m128i& prevIncomplete) {
+    if (_mm_movemask_epi8(input) == 0) {
+        // 纯 ASCII 块：只需确认前一块没有被截断的序列
+        error = _mm_or_si128(error, prevIncomplete);
+    } else {
+        const __m128i nibble    = _mm_set1_epi8(0x0F);
+        const __m128i prev1     = _mm_alignr_epi8(input, prevInput, 15);
+        const __m128i byte1High = _mm_shuffle_epi8(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(kUtf8Byte1High)),
+            _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+        const __m128i byte1Low = _mm_shuffle_epi8(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(kUtf8Byte1Low)),
+            _mm_and_si128(prev1, nibble));
+        const __m128i byte2High = _mm_shuffle_epi8(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(kUtf8Byte2High)),
+            _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+        const __m128i special = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+        // 三、四字节序列的第 3、4 个字节必须是后续字节
+        const __m128i third  = _mm_subs_epu8(_mm_alignr_epi8(input, prevInput, 14),
+                                             _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+        const __m128i fourth = _mm_subs_epu8(_mm_alignr_epi8(input, prevInput, 13),
+                                             _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+        const __m128i must23 =
+            _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+        error          = _mm_or_si128(error, _mm_xor_si128(must23, special));
+        prevIncomplete = _mm_subs_epu8(
+            input, _mm_loadu_si128(reinterpret_cast<const __m128i*>(kUtf8IncompleteMax + 16)));
+    }
+    prevInput = input;
+}
 
-            // ---- 解析可选的时区偏移部分 ----
-            if (position < size) {
-                const char offset_char = data[position];
-                if (offset_char == 'Z' || offset_char == 'z') {
-                    position++;
-                } else if (offset_char == '+' || offset_char == '-') {
-                    position++;
-                    if (position + 5 > size)
-                        return false;
-                    const int off_hour = (data[position] - '0') * 10 + (data[position + 1] - '0');
-                    const int off_min =
-                        (data[position + 3] - '0') * 10 + (data[position + 4] - '0');
+/**
+ * @brief SSE4.1 实现的 UTF-8 校验。
+ * @param data 输入数据。
+ * @param size 数据长度。
+ * @return 如果全部合法，返回 true，否则返回 false。
+ */
+CCTOML_TARGET("sse4.1")
+static bool isValidUtf8Sse41(const unsigned char* data, size_t size) {
+    __m128i error = _mm_setzero_si128(), prevInput = error, prevIncomplete = error;
+    size_t  position = 0;
+    for (; position + 16 <= size; position += 16) {
+        checkUtf8BlockSse41(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position)),
+                            prevInput, error, prevIncomplete);
+    }
+    // 尾部不足一块时以 0 填充（0 为 ASCII，被截断的序列会在此处暴露）
+    alignas(16) unsigned char tail[16] = {};
+    std::memcpy(tail, data + position, size - position);
+    checkUtf8BlockSse41(_mm_load_si128(reinterpret_cast<const __m128i*>(tail)), prevInput, error,
+                        prevIncomplete);
+    error = _mm_or_si128(error, prevIncomplete);
+    return _mm_testz_si128(error, error) != 0;
+}
+#endif
 
-                    if (!(IS_DIGIT(data[position]) && IS_DIGIT(data[position + 1]) &&
-                          (data[position + 2] == ':') && IS_DIGIT(data[position + 3]) &&
-                          IS_DIGIT(data[position + 4]) && (off_hour <= 23 && off_min <= 59))) {
-                        return false;
-                    }
-                    position += 5;
-                }
-            }
+#if defined(CCTOML_UTF8_AVX2)
+/**
+ * @brief AVX2 取当前块左移 N 字节并以前一块末尾补齐的结果（跨 128 位通道）。
+ */
+#    define UTF8_AVX2_PREV(input, prevInput, n)                                                    \
+        _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prevInput, input, 0x21), 16 - (n))
 
-            // 最终检查: 必须消耗掉整个字符串
-            return position == size;
-        }
+/**
+ * @brief AVX2 校验一个 32 字节块，结果累积到 error 中。
+ * @param input 当前块。
+ * @param prevInput 前一个块（会被更新为当前块）
+ * @param error 累积的错误标记。
+ * @param prevIncomplete 前一个块末尾是否有未完成的序列（会被更新）
+ */
+CCTOML_TARGET("avx2")
+static inline void
+checkUtf8BlockAvx2(__m256i input, __m256i& prevInput, __m256i& error, __m256i& prevIncomplete) {
+    if (_mm256_movemask_epi8(input) == 0) {
+        // 纯 ASCII 块：只需确认前一块没有被截断的序列
+        error = _mm256_or_si256(error, prevIncomplete);
+    } else {
+        const __m256i nibble    = _mm256_set1_epi8(0x0F);
+        const __m256i prev1     = UTF8_AVX2_PREV(input, prevInput, 1);
+        const __m256i byte1High = _mm256_shuffle_epi8(
+            _mm256_broadcastsi128_si256(
+                _mm_load_si128(reinterpret_cast<const __m128i*>(kUtf8Byte1High))),
+            _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+        const __m256i byte1Low = _mm256_shuffle_epi8(
+            _mm256_broadcastsi128_si256(
+                _mm_load_si128(reinterpret_cast<const __m128i*>(kUtf8Byte1Low))),
+            _mm256_and_si256(prev1, nibble));
+        const __m256i byte2High = _mm256_shuffle_epi8(
+            _mm256_broadcastsi128_si256(
+                _mm_load_si128(reinterpret_cast<const __m128i*>(kUtf8Byte2High))),
+            _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+        const __m256i special =
+            _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+        // 三、四字节序列的第 3、4 个字节必须是后续字节
+        const __m256i third  = _mm256_subs_epu8(UTF8_AVX2_PREV(input, prevInput, 2),
+                                                _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+        const __m256i fourth = _mm256_subs_epu8(UTF8_AVX2_PREV(input, prevInput, 3),
+                                                _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+        const __m256i must23 = _mm256_and_si256(_mm256_or_si256(third, fourth),
+                                                _mm256_set1_epi8(static_cast<char>(0x80)));
+        error          = _mm256_or_si256(error, _mm256_xor_si256(must23, special));
+        prevIncomplete = _mm256_subs_epu8(
+            input, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kUtf8IncompleteMax)));
     }
+    prevInput = input;
+}
 
-    // -----------------------------------------------------------------
-    // 分支 2: 尝试解析纯时间格式 (hh:mm:ss)
-    // -----------------------------------------------------------------
-    position = 0;
-    if (size >= 8 && (data[position + 2] == ':') && (data[position + 5] == ':') &&
-        IS_DIGIT(data[position]) && IS_DIGIT(data[position + 1]) && IS_DIGIT(data[position + 3]) &&
-        IS_DIGIT(data[position + 4]) && IS_DIGIT(data[position + 6]) &&
-        IS_DIGIT(data[position + 7])) {
-        const int hour   = (data[position] - '0') * 10 + (data[position + 1] - '0');
-        const int minute = (data[position + 3] - '0') * 10 + (data[position + 4] - '0');
-        const int second = (data[position + 6] - '0') * 10 + (data[position + 7] - '0');
+#    undef UTF8_AVX2_PREV
 
-        if (hour <= 23 && minute <= 59 && second <= 59) {
-            position += 8;
+/**
+ * @brief AVX2 实现的 UTF-8 校验。
+ * @param data 输入数据。
+ * @param size 数据长度。
+ * @return 如果全部合法，返回 true，否则返回 false。
+ */
+CCTOML_TARGET("avx2")
+static bool isValidUtf8Avx2(const unsigned char* data, size_t size) {
+    __m256i error = _mm256_setzero_si256(), prevInput = error, prevIncomplete = error;
+    size_t  position = 0;
+    for (; position + 32 <= size; position += 32) {
+        checkUtf8BlockAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position)),
+                           prevInput, error, prevIncomplete);
+    }
+    // 尾部不足一块时以 0 填充（0 为 ASCII，被截断的序列会在此处暴露）
+    alignas(32) unsigned char tail[32] = {};
+    std::memcpy(tail, data + position, size - position);
+    checkUtf8BlockAvx2(_mm256_load_si256(reinterpret_cast<const __m256i*>(tail)), prevInput,
+                       error, prevIncomplete);
+    error = _mm256_or_si256(error, prevIncomplete);
+    return _mm256_testz_si256(error, error) != 0;
+}
+#endif
 
-            if (position < size && data[position] == '.') {
-                position++;
-                const size_t fracStart = position;
-                while (position < size && IS_DIGIT(data[position])) {
-                    position++;
-                }
-                if (position == fracStart) {
-                    return false;
-                }
-            }
+#if defined(CCTOML_UTF8_NEON)
+/**
+ * @brief NEON 校验一个 16 字节块，结果累积到 error 中。
+ * @param input 当前块。
+ * @param prevInput 前一个块（会被更新为当前块）
+ * @param error 累积的错误标记。
+ * @param prevIncomplete 前一个块末尾是否有未完成的序列（会被更新）
+ */
+static inline void checkUtf8BlockNeon(uint8x16_t  input,
+                                      uint8x16_t& prevInput,
+                                      uint8x16_t& error,
+                                      uint8x16_t& prevIncomplete) {
+    if (vmaxvq_u8(input) < 0x80) {
+        // 纯 ASCII 块：只需确认前一块没有被截断的序列
+        error = vorrq_u8(error, prevIncomplete);
+    } else {
+        const uint8x16_t nibble    = vdupq_n_u8(0x0F);
+        const uint8x16_t prev1     = vextq_u8(prevInput, input, 15);
+        const uint8x16_t byte1High = vqtbl1q_u8(vld1q_u8(kUtf8Byte1High), vshrq_n_u8(prev1, 4));
+        const uint8x16_t byte1Low  = vqtbl1q_u8(vld1q_u8(kUtf8Byte1Low), vandq_u8(prev1, nibble));
+        const uint8x16_t byte2High = vqtbl1q_u8(vld1q_u8(kUtf8Byte2High), vshrq_n_u8(input, 4));
+        const uint8x16_t special   = vandq_u8(vandq_u8(byte1High, byte1Low), byte2High);
+        // 三、四字节序列的第 3、4 个字节必须是后续字节
+        const uint8x16_t third  = vqsubq_u8(vextq_u8(prevInput, input, 14), vdupq_n_u8(0xE0 - 0x80));
+        const uint8x16_t fourth = vqsubq_u8(vextq_u8(prevInput, input, 13), vdupq_n_u8(0xF0 - 0x80));
+        const uint8x16_t must23 = vandq_u8(vorrq_u8(third, fourth), vdupq_n_u8(0x80));
+        error          = vorrq_u8(error, veorq_u8(must23, special));
+        prevIncomplete = vqsubq_u8(input, vld1q_u8(kUtf8IncompleteMax + 16));
+    }
+    prevInput = input;
+}
 
-            return position == size;
-        }
+/**
+ * @brief NEON 实现的 UTF-8 校验。
+ * @param data 输入数据。
+ * @param size 数据长度。
+ * @return 如果全部合法，返回 true，否则返回 false。
+ */
+static bool isValidUtf8Neon(const unsigned char* data, size_t size) {
+    uint8x16_t error = vdupq_n_u8(0), prevInput = error, prevIncomplete = error;
+    size_t     position = 0;
+    for (; position + 16 <= size; position += 16) {
+        checkUtf8BlockNeon(vld1q_u8(data + position), prevInput, error, prevIncomplete);
     }
+    // 尾部不足一块时以 0 填充（0 为 ASCII，被截断的序列会在此处暴露）
+    unsigned char tail[16] = {};
+    std::memcpy(tail, data + position, size - position);
+    checkUtf8BlockNeon(vld1q_u8(tail), prevInput, error, prevIncomplete);
+    error = vorrq_u8(error, prevIncomplete);
+    return vmaxvq_u8(error) == 0;
+}
+#endif
 
-    return false;
+/**
+ * @brief 校验整个输入是否为合法的 UTF-8（TOML 要求）。
+ *
+ * 优先使用 AVX2/SSE4.1/NEON 的查表实现整体判定，仅在发现错误时退回标量实现定位具体位置。
+ *
+ * @param data 输入数据。
+ * @throws TomlParseException 如果存在非法 UTF-8 序列，抛出包含其首字节位置的异常。
+ */
+static void validateUtf8(const std::string_view& data) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+    const auto  size  = data.size();
+    bool        valid;
+#if defined(CCTOML_UTF8_RUNTIME_DISPATCH)
+    if (__builtin_cpu_supports("avx2")) {
+        valid = isValidUtf8Avx2(bytes, size);
+    } else if (__builtin_cpu_supports("sse4.1")) {
+        valid = isValidUtf8Sse41(bytes, size);
+    } else {
+        valid = findInvalidUtf8(bytes, size) == size;
+    }
+#elif defined(CCTOML_UTF8_AVX2)
+    valid = isValidUtf8Avx2(bytes, size);
+#elif defined(CCTOML_UTF8_SSE41)
+    valid = isValidUtf8Sse41(bytes, size);
+#elif defined(CCTOML_UTF8_NEON)
+    valid = isValidUtf8Neon(bytes, size);
+#else
+    valid = findInvalidUtf8(bytes, size) == size;
+#endif
+    if (!valid) {
+        throw TomlParseException("Invalid UTF-8 sequence", findInvalidUtf8(bytes, size));
+    }
 }
 
 namespace parser {
     TomlValue parse(std::string_view data) {
+        return parse(data, ParseOptions());
+    }
+
+    TomlValue parse(std::string_view data, const ParseOptions& options) {
+        // TOML 文档必须是合法的 UTF-8, 先整体校验（包括字符串与注释）
+        validateUtf8(data);
         size_t    position = 0;
         TomlValue root;
         // todo:Dotted keys create and define a table for each key part before the last one,
@@ -1749,10 +5277,10 @@ namespace parser {
         // 1. 先解析顶层内容
         if (position < size && data[position] != '[') {
             // 解析顶层属性(key-value)
-            auto keyValues = parseKeyValuePairs(data, position);
+            auto keyValues = parseKeyValuePairs(data, position, options.maxDepth);
             // 根据表头添加数据
             // 对于当前节点赋值
-            for (const auto& [k, v] : keyValues) {
+            for (auto& [k, v] : keyValues) {
                 TomlValue* node = &root;
                 for (size_t i = 0; !k.empty() && i < k.size() - 1; i++) {
                     if (node->isObject()) {
@@ -1763,9 +5291,10 @@ namespace parser {
                 }
                 if (node->isObject()) {
                     if (node->asObject().find(k.back()) == node->asObject().end()) {
-                        node->insert(k.back(), v);
+                        node->asObject().emplace(k.back(), std::move(v));
                     } else {
-                        throw TomlParseException("key '" + k.back() + "' has existed", position);
+                        throw TomlParseException("key '" + std::string(k.back()) + "' has existed",
+                                                 position);
                     }
                 } else {
                     throw TomlParseException("node is not a object", position);
@@ -1798,7 +5327,7 @@ namespace parser {
             skipCrlf(data, position);
 
             // 解析下面的key-value
-            auto keyValues = parseKeyValuePairs(data, position);
+            auto keyValues = parseKeyValuePairs(data, position, options.maxDepth);
 #define GET_TARGET_NODE(key)                                                                       \
     do {                                                                                           \
         if (node->isObject()) {                                                                    \
@@ -1849,7 +5378,7 @@ namespace parser {
 
 #define SET_VALUE_TO_NODE(root)                                                                    \
     do {                                                                                           \
-        for (const auto& [ks, v] : keyValues) {                                                    \
+        for (auto& [ks, v] : keyValues) {                                                          \
             auto* tempNode = root;                                                                 \
             for (size_t i = 0; !ks.empty() && i < ks.size() - 1; i++) {                            \
                 if (!tempNode->isObject()) {                                                       \
@@ -1861,9 +5390,10 @@ namespace parser {
                 throw TomlParseException("Cannot insert key on non-object", position);             \
             }                                                                                      \
             if (tempNode->asObject().find(ks.back()) != tempNode->asObject().end()) {              \
-                throw TomlParseException("Duplicate key '" + ks.back() + "'", position);           \
+                throw TomlParseException("Duplicate key '" + std::string(ks.back()) + "'",         \
+                                         position);                                                \
             }                                                                                      \
-            tempNode->insert(ks.back(), v);                                                        \
+            tempNode->asObject().emplace(ks.back(), std::move(v));                                 \
         }                                                                                          \
     } while (false)
 
@@ -1875,7 +5405,7 @@ namespace parser {
                     // 新的数组对象
                     TomlValue parent;
                     SET_VALUE_TO_NODE(&parent);
-                    node->push_back(parent);
+                    node->asArray().emplace_back(std::move(parent));
                 }
             } else {
                 // 对象
@@ -1889,9 +5419,113 @@ namespace parser {
         }
         return root;
     }
+
+    void parseInto(std::string_view data, TomlDecodeTarget& target, const ParseOptions& options) {
+        validateUtf8(data);
+        size_t       position = 0;
+        const size_t size     = data.size();
+        // 逐个解析一节中的键值对并立即交给表的写入目标, 点分键逐级进入子表
+        auto keys    = makeInResource<TomlKeys>();
+        auto deliver = [&](TomlDecodeTarget& table) {
+            while (position < size) {
+                skipUselessChar(data, position);
+                if (position >= size || data[position] == '[') {
+                    break;
+                }
+                auto              value = parseKeyValue(data, position, options.maxDepth, keys);
+                TomlDecodeTarget* node  = &table;
+                for (size_t i = 0; i + 1 < keys.size(); i++) {
+                    node = &node->table(keys[i]);
+                }
+                node->value(keys.back(), std::move(value));
+            }
+        };
+        // 1. 顶层内容
+        deliver(target);
+        // 2. 各表头及其下的键值对
+        while (position < size) {
+            skipWhitespaceAndComment(data, position);
+            if (position >= size) {
+                break;
+            }
+            if (data[position] != '[') {
+                throw TomlParseException("Expected table header", position);
+            }
+            const bool isArray = position + 1 < size && data[position + 1] == '[';
+            auto       headers = parseTableHeader(data, position, isArray);
+            skipWhitespaceAndComment(data, position);
+            if (position < size && data[position] != '\r' && data[position] != '\n') {
+                throw TomlParseException("A line break is required after the value", position);
+            }
+            skipCrlf(data, position);
+
+            TomlDecodeTarget* node = &target;
+            for (size_t i = 0; i + 1 < headers.size(); i++) {
+                node = &node->table(headers[i]);
+            }
+            deliver(isArray ? node->append(headers.back()) : node->table(headers.back()));
+        }
+        target.finish();
+    }
+
+#if defined(CCTOML_USE_PMR)
+    TomlValue parse(std::string_view data, std::pmr::memory_resource* resource) {
+        return parse(data, ParseOptions(), resource);
+    }
+
+    TomlValue parse(std::string_view data, const ParseOptions& options,
+                    std::pmr::memory_resource* resource) {
+        TomlResourceScope scope(resource);
+        return parse(data, options);
+    }
+#endif
 #undef SET_VALUE_TO_NODE
 }  // namespace parser
 
+TomlTreeTarget::~TomlTreeTarget() = default;
+
+TomlValue& TomlTreeTarget::current() const {
+    if (m_node->isArray()) {
+        auto& array = m_node->asArray();
+        if (array.empty() || !array.back().isObject()) {
+            throw TomlException("Expected object in path");
+        }
+        return array.back();
+    }
+    if (!m_node->isObject()) {
+        throw TomlException("Expected object in path");
+    }
+    return *m_node;
+}
+
+void TomlTreeTarget::value(std::string_view key, TomlValue&& value) {
+    if (!current().asObject().emplace(key, std::move(value)).second) {
+        throw TomlException("Duplicate key '" + std::string(key) + "'");
+    }
+}
+
+TomlDecodeTarget& TomlTreeTarget::table(std::string_view key) {
+    return child(current()[key]);
+}
+
+TomlDecodeTarget& TomlTreeTarget::append(std::string_view key) {
+    TomlValue& node = current()[key];
+    // 新建的表转为表数组
+    if (node.isObject() && node.asObject().empty()) {
+        node = TomlArray();
+    }
+    if (!node.isArray()) {
+        throw TomlException("node is not a array");
+    }
+    node.push_back(TomlObject());
+    return child(node);
+}
+
+TomlDecodeTarget& TomlTreeTarget::child(TomlValue& node) {
+    m_children.push_back(std::make_unique<TomlTreeTarget>(node));
+    return *m_children.back();
+}
+
 #undef SKIP_USELESS_CHAR
 #undef SKIP_CRLF
 #undef SKIP_WHITESPACE_AND_COMMENT
@@ -1944,7 +5578,7 @@ inline static void stringifyString(const TomlValue& value, std::ostringstream& o
  * @param s 输入字符串。
  * @return 序列化后的字符串，包含必要的引号和转义字符。
  */
-static std::string stringifyString(const std::string& s);
+static std::string stringifyString(std::string_view s);
 
 /**
  * @brief 序列化日期时间值到输出流。
@@ -1961,7 +5595,7 @@ stringifyDate(const TomlValue& value, std::ostringstream& oss, parser::Stringify
  * @return 如果字符串是有效的 TOML 裸键（仅包含字母、数字、下划线或连字符），返回 true，否则返回
  * false。
  */
-static bool stringIsBareKey(const std::string& s);
+static bool stringIsBareKey(std::string_view s);
 
 /**
  * @brief 序列化 TOML 数组到输出流（TOML 格式）
@@ -1991,6 +5625,13 @@ static bool isArrayOfTables(const TomlValue& value);
  */
 inline static void stringifyTomlObject(const TomlValue& value, std::ostringstream& oss);
 
+/**
+ * @brief 序列化 TOML 对象中不是子表或表数组的字段（TOML 格式）
+ * @param object TOML 对象。
+ * @param oss 输出字符串流。
+ */
+static void stringifyTomlFields(const TomlObject& object, std::ostringstream& oss);
+
 /**
  * @brief 序列化 TOML 对象到输出流（TOML 格式，带前缀）
  * @param object TOML 对象。
@@ -2151,7 +5792,7 @@ void stringifyDouble(const TomlValue& value, std::ostringstream& oss) {
     }
 }
 
-bool stringIsBareKey(const std::string& s) {
+bool stringIsBareKey(std::string_view s) {
     // 空字符串不是合法的bareKey
     if (s.empty()) {
         return false;
@@ -2169,7 +5810,7 @@ void stringifyString(const TomlValue& value, std::ostringstream& oss) {
     oss << stringifyString(value.asString());
 }
 
-std::string stringifyString(const std::string& s) {
+std::string stringifyString(std::string_view s) {
     std::ostringstream oss;
     oss << '"';
     for (char c : s) {
@@ -2199,15 +5840,22 @@ std::string stringifyString(const std::string& s) {
 }
 
 void stringifyDate(const TomlValue& value, std::ostringstream& oss, parser::StringifyType type) {
+    // 直接格式化到栈上缓冲区, 预留json两侧引号的位置
+    char   buffer[TomlDate::FORMAT_BUFFER_SIZE + 2];
+    size_t size = value.asDate().format(buffer + 1);
     switch (type) {
         case parser::TO_TOML:
-        case parser::TO_YAML: oss << value.asDate(); break;
-        case parser::TO_JSON: oss << '"' << value.asDate() << '"'; break;
+        case parser::TO_YAML: oss.write(buffer + 1, static_cast<std::streamsize>(size)); break;
+        case parser::TO_JSON:
+            buffer[0]        = '"';
+            buffer[size + 1] = '"';
+            oss.write(buffer, static_cast<std::streamsize>(size + 2));
+            break;
     }
 }
 
 void stringifyTomlArray(const TomlValue& value, std::ostringstream& oss) {
-    const auto& array = value.get<TomlArray>();
+    const auto& array = value.asArray();
     oss << "[";
     for (size_t i = 0; i < array.size(); ++i) {
         if (i > 0) {
@@ -2216,7 +5864,7 @@ void stringifyTomlArray(const TomlValue& value, std::ostringstream& oss) {
         const auto& item = array[i];
         // 表中的array就应该以inline形式输出
         if (item.type() == TomlType::Object) {
-            stringifyInlineObject(item.get<TomlObject>(), oss);
+            stringifyInlineObject(item.asObject(), oss);
         } else {
             stringifyValue(item, oss);
         }
@@ -2266,17 +5914,21 @@ void stringifyTomlObject(const TomlValue& value, std::ostringstream& oss) {
     stringifyTomlObject(value.asObject(), oss, "");
 }
 
-void stringifyTomlObject(const TomlObject&   object,
-                         std::ostringstream& oss,
-                         const std::string&  prefix) {
-    // 1. 输出非 Object 的字段（顶层属性）
+void stringifyTomlFields(const TomlObject& object, std::ostringstream& oss) {
     for (const auto& [k, v] : object) {
         if (v.type() != TomlType::Object && !isArrayOfTables(v)) {
-            oss << (stringIsBareKey(k) ? k : stringifyString(k)) << " = ";
+            oss << (stringIsBareKey(k) ? std::string(k) : stringifyString(k)) << " = ";
             stringifyValue(v, oss);
             oss << "\n";
         }
     }
+}
+
+void stringifyTomlObject(const TomlObject&   object,
+                         std::ostringstream& oss,
+                         const std::string&  prefix) {
+    // 1. 输出非 Object 的字段（顶层属性）
+    stringifyTomlFields(object, oss);
 
     // 2. 输出子对象 [section] 和 表数组[[section]]
     for (const auto& [k, v] : object) {
@@ -2284,7 +5936,8 @@ void stringifyTomlObject(const TomlObject&   object,
             const auto& child = v.asObject();
             std::string fullKey;
             // 预先处理当前键的格式
-            const std::string processedKey = stringIsBareKey(k) ? k : stringifyString(k);
+            const std::string processedKey =
+                stringIsBareKey(k) ? std::string(k) : stringifyString(k);
             // 构建完整键
             if (!prefix.empty()) {
                 fullKey.reserve(prefix.size() + 1 + processedKey.size());
@@ -2298,7 +5951,8 @@ void stringifyTomlObject(const TomlObject&   object,
             const auto& array = v.asArray();
             std::string fullKey;
             // 预先处理当前键的格式
-            const std::string processedKey = stringIsBareKey(k) ? k : stringifyString(k);
+            const std::string processedKey =
+                stringIsBareKey(k) ? std::string(k) : stringifyString(k);
             // 构建完整键
             if (!prefix.empty()) {
                 fullKey.reserve(prefix.size() + 1 + processedKey.size());
@@ -2315,7 +5969,7 @@ void stringifyTomlObject(const TomlObject&   object,
 }
 
 void stringifyJsonArray(const TomlValue& value, std::ostringstream& oss, int indent, int level) {
-    const auto& array = value.get<TomlArray>();
+    const auto& array = value.asArray();
     if (array.empty()) {
         oss << "[]";
         return;
@@ -2338,7 +5992,7 @@ void stringifyJsonArray(const TomlValue& value, std::ostringstream& oss, int ind
 }
 
 void stringifyJsonObject(const TomlValue& value, std::ostringstream& oss, int indent, int level) {
-    const auto& object = value.get<TomlObject>();
+    const auto& object = value.asObject();
     if (object.empty()) {
         oss << "{}";
         return;
@@ -2410,14 +6064,196 @@ void stringifyYamlObject(const TomlValue& value, std::ostringstream& oss, int in
     }
 }
 
+/**
+ * @brief 并行序列化中的一段输出，按顺序拼接后与顺序序列化的结果相同。
+ */
+struct StringifyChunk {
+    enum Kind {
+        Fields,     ///< 根对象中不是子表或表数组的字段
+        Table,      ///< 一个子表（含表头）
+        TableArray  ///< 表数组中 [begin, end) 的元素（各含表头）
+    };
+    Kind             kind;
+    const TomlValue* value;   ///< 根对象、子表或表数组
+    std::string      key;     ///< 表头中的键
+    size_t           begin;   ///< 表数组的起始下标
+    size_t           end;     ///< 表数组的结束下标
+};
+
+/**
+ * @brief 把根对象切分成若干段并在多个线程中序列化。
+ * @return 按输出顺序排列的各段内容。
+ */
+static std::vector<std::string> stringifyChunks(const TomlValue&      value,
+                                                parser::StringifyType type,
+                                                int                   indent,
+                                                size_t                threads) {
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    if (type != parser::TO_TOML || !value.isObject() || threads == 1) {
+        return {parser::stringify(value, type, indent)};
+    }
+    // 与 stringifyTomlObject() 的输出顺序一致: 先是全部字段, 再按键的顺序输出子表与表数组
+    const auto&                 object = value.asObject();
+    std::vector<StringifyChunk> chunks{{StringifyChunk::Fields, &value, {}, 0, 0}};
+    for (const auto& [k, v] : object) {
+        if (v.isObject()) {
+            chunks.push_back({StringifyChunk::Table, &v, stringIsBareKey(k) ? std::string(k)
+                                                                            : stringifyString(k),
+                              0, 0});
+        } else if (isArrayOfTables(v)) {
+            // 每批元素足够多以摊薄线程调度开销, 又足够少以便各线程负载均衡
+            const size_t size  = v.asArray().size();
+            const size_t batch = std::max<size_t>(16, size / (threads * 4));
+            std::string  key   = stringIsBareKey(k) ? std::string(k) : stringifyString(k);
+            for (size_t begin = 0; begin < size; begin += batch) {
+                chunks.push_back(
+                    {StringifyChunk::TableArray, &v, key, begin, std::min(size, begin + batch)});
+            }
+        }
+    }
+
+    std::vector<std::string> buffers(chunks.size());
+    std::atomic<size_t>      next{0};
+    std::exception_ptr       error;
+    std::mutex               errorMutex;
+    auto                     work = [&] {
+        try {
+            for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < chunks.size();) {
+                const StringifyChunk& chunk = chunks[i];
+                std::ostringstream    oss;
+                switch (chunk.kind) {
+                    case StringifyChunk::Fields:
+                        stringifyTomlFields(chunk.value->asObject(), oss);
+                        break;
+                    case StringifyChunk::Table:
+                        oss << "\n[" << chunk.key << "]\n";
+                        stringifyTomlObject(chunk.value->asObject(), oss, chunk.key);
+                        break;
+                    case StringifyChunk::TableArray:
+                        for (size_t j = chunk.begin; j < chunk.end; ++j) {
+                            oss << "\n[[" << chunk.key << "]]\n";
+                            stringifyTomlObject(chunk.value->asArray()[j].asObject(), oss,
+                                                chunk.key);
+                        }
+                        break;
+                }
+                buffers[i] = oss.str();
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            next.store(chunks.size(), std::memory_order_relaxed);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < std::min(threads, chunks.size()); ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return buffers;
+}
+
 namespace parser {
     std::string stringify(const TomlValue& value, StringifyType type, int indent) {
         std::ostringstream oss;
         stringifyValue(value, oss, type, indent, 0);
         return oss.str();
     }
+
+    std::string
+    stringifyParallel(const TomlValue& value, StringifyType type, int indent, size_t threads) {
+        auto buffers = stringifyChunks(value, type, indent, threads);
+        if (buffers.size() == 1) {
+            return std::move(buffers.front());
+        }
+        size_t size = 0;
+        for (const auto& buffer : buffers) {
+            size += buffer.size();
+        }
+        std::string result;
+        result.reserve(size);
+        for (const auto& buffer : buffers) {
+            result += buffer;
+        }
+        return result;
+    }
+
+    void stringifyToFile(const std::string& path,
+                         const TomlValue&   value,
+                         StringifyType      type,
+                         int                indent,
+                         size_t             threads) {
+        auto buffers = stringifyChunks(value, type, indent, threads);
+#if defined(CCTOML_HAVE_WRITEV)
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw TomlException("Cannot open file: " + path);
+        }
+        // 每次最多提交 kMaxBatch 段, 部分写入时从中断处继续
+        constexpr size_t   kMaxBatch = 1024;
+        std::vector<iovec> vectors;
+        vectors.reserve(buffers.size());
+        for (auto& buffer : buffers) {
+            if (!buffer.empty()) {
+                vectors.push_back({buffer.data(), buffer.size()});
+            }
+        }
+        size_t first = 0;
+        while (first < vectors.size()) {
+            int     count   = static_cast<int>(std::min(kMaxBatch, vectors.size() - first));
+            ssize_t written = ::writev(fd, vectors.data() + first, count);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ::close(fd);
+                throw TomlException("Cannot write file: " + path);
+            }
+            auto remaining = static_cast<size_t>(written);
+            while (first < vectors.size() && remaining >= vectors[first].iov_len) {
+                remaining -= vectors[first++].iov_len;
+            }
+            if (remaining > 0) {
+                vectors[first].iov_base = static_cast<char*>(vectors[first].iov_base) + remaining;
+                vectors[first].iov_len -= remaining;
+            }
+        }
+        if (::close(fd) != 0) {
+            throw TomlException("Cannot write file: " + path);
+        }
+#else
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw TomlException("Cannot open file: " + path);
+        }
+        for (const auto& buffer : buffers) {
+            file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        }
+        if (!file.flush()) {
+            throw TomlException("Cannot write file: " + path);
+        }
+#endif
+    }
 }  // namespace parser
 
 #undef IS_DIGIT
 }  // namespace cctoml
+
+#undef CCTOML_TARGET
+#undef CCTOML_UTF8_RUNTIME_DISPATCH
+#undef CCTOML_UTF8_AVX2
+#undef CCTOML_UTF8_SSE41
+#undef CCTOML_UTF8_NEON
+#undef CCTOML_HAVE_POSIX_STAT
+#undef CCTOML_HAVE_WRITEV
 #pragma clang diagnostic pop
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include <cctoml.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cctoml;
+
+/**
+ * @brief 写入一个带编号的小型配置文件。
+ * @param path 文件路径。
+ * @param id 文件编号。
+ */
+static void writeDocument(const std::string& path, size_t id) {
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    output << "id = " << id << "\n[server]\nhost = \"localhost\"\nports = [8000, 8001, 8002]\n";
+}
+
+int main() {
+    constexpr size_t kFiles   = 4;
+    constexpr size_t kThreads = 8;
+    constexpr size_t kRounds  = 5000;
+
+    const auto               directory = std::filesystem::temp_directory_path();
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < kFiles; ++i) {
+        paths.push_back((directory / ("cctoml-bench-cache-" + std::to_string(i) + ".toml")).string());
+        writeDocument(paths.back(), i);
+    }
+
+    // 元数据未变时直接命中, 文件只在被修改或 touch 后重新读取
+    bool reused = false;
+    {
+        TomlCache::Options verify;
+        verify.verifyContent = true;
+        TomlCache  single(verify);
+        const auto first = single.load(paths[0]);
+        const bool hit   = single.load(paths[0]) == first;
+        std::filesystem::last_write_time(
+            paths[0], std::filesystem::last_write_time(paths[0]) + std::chrono::seconds(2));
+        const bool touched = single.load(paths[0]) == first;
+        writeDocument(paths[0], kFiles);
+        const bool changed = (*single.load(paths[0]))["id"].get<int64_t>() == int64_t(kFiles);
+        writeDocument(paths[0], 0);
+        reused = hit && touched && changed && single.stats().loads == 2;
+        std::cout << "identity hit, touch reuse, change reload: " << (reused ? "yes" : "no")
+                  << std::endl;
+    }
+
+    // 极小的预算使条目加载后立即被淘汰, 每次加载都在锁外重新读取文件并与其他线程的淘汰交错
+    TomlCache::Options options;
+    options.verifyContent = true;
+    options.memoryBudget  = 1;
+    TomlCache cache(options);
+
+    std::atomic<size_t>      mismatches{0};
+    std::vector<std::thread> threads;
+    auto                     start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < kRounds; ++i) {
+                size_t file     = (t + i) % kFiles;
+                auto   document = cache.load(paths[file]);
+                if ((*document)["id"].get<int64_t>() != static_cast<int64_t>(file)) {
+                    ++mismatches;
+                }
+                if (i % 64 == 0) {
+                    cache.invalidate(paths[(file + 1) % kFiles]);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    auto stats = cache.stats();
+    std::cout << "loads: " << kThreads * kRounds << " in " << elapsed.count() * 1e3 << " ms"
+              << " (parsed " << stats.loads << ", hits " << stats.hits << ", waits " << stats.waits
+              << ", evictions " << stats.evictions << ")" << std::endl;
+
+    cache.clear();
+    stats = cache.stats();
+    for (const auto& path : paths) {
+        std::filesystem::remove(path);
+    }
+    if (!reused || mismatches != 0 || stats.memory != 0 || stats.entries != 0) {
+        std::cout << "cache state inconsistent: mismatches " << mismatches << ", memory "
+                  << stats.memory << ", entries " << stats.entries << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include <cctoml.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace cctoml;
+
+/**
+ * @brief 构造包含大量日期的文档，覆盖四种日期类型、小数秒与时区偏移。
+ * @param count [[events]] 个数。
+ * @return TOML 文档。
+ */
+static std::string makeDateDocument(size_t count) {
+    static const char* const offsets[]   = {"Z", "+08:00", "-05:30", "+00:00"};
+    static const char* const fractions[] = {"", ".5", ".123456", ".999999999"};
+    std::string              doc;
+    for (size_t i = 0; i < count; ++i) {
+        const std::string day  = std::to_string(10 + i % 19);
+        const std::string hour = std::to_string(10 + i % 14);
+        doc += "[[events]]\nstart = 2024-03-" + day + "T" + hour + ":15:30" + fractions[i % 4] +
+               offsets[i % 4] + "\nlocal = 1999-12-" + day + "T23:59:59" + fractions[(i + 1) % 4] +
+               "\ndate = 1979-05-" + day + "\ntime = " + hour + ":00:00" + fractions[(i + 2) % 4] +
+               "\nhistory = [2020-01-01, 2021-06-" + day + "T08:00:00Z, 07:32:00]\n";
+    }
+    return doc;
+}
+
+/**
+ * @brief 多次执行并输出平均耗时与吞吐量。
+ * @param name 测试名称。
+ * @param bytes 每次处理的字节数（用于计算吞吐量）
+ * @param rounds 重复次数。
+ * @param body 被测函数，返回值用于防止被优化掉。
+ */
+template <typename F>
+static void bench(const std::string& name, size_t bytes, int rounds, F&& body) {
+    size_t sink  = 0;
+    auto   start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        sink += body();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double                        seconds = elapsed.count() / rounds;
+    std::cout << std::left << std::setw(28) << name << std::right << std::setw(12) << std::fixed
+              << std::setprecision(3) << seconds * 1e3 << " ms" << std::setw(12)
+              << bytes / seconds / (1 << 20) << " MB/s" << std::setw(8) << sink % 10 << std::endl;
+}
+
+int main() {
+    const std::string doc  = makeDateDocument(50000);
+    const TomlValue   root = parser::parse(doc);
+
+    // 收集所有日期, 单独对比 format() 与 toString()
+    std::vector<TomlDate> dates;
+    for (const auto& event : root["events"].asArray()) {
+        for (const auto& [key, value] : event.asObject()) {
+            if (value.isDate()) {
+                dates.push_back(value.asDate());
+            } else {
+                for (const auto& item : value.asArray()) {
+                    dates.push_back(item.asDate());
+                }
+            }
+        }
+    }
+    bool   same  = true;
+    size_t bytes = 0;
+    for (const auto& date : dates) {
+        char buffer[TomlDate::FORMAT_BUFFER_SIZE];
+        const size_t length = date.format(buffer);
+        same                = same && std::string_view(buffer, length) == date.toString();
+        bytes += length;
+    }
+
+    std::cout << dates.size() << " dates" << std::endl;
+    bench("TomlDate::toString", bytes, 20, [&] {
+        size_t total = 0;
+        for (const auto& date : dates) {
+            total += date.toString().size();
+        }
+        return total;
+    });
+    bench("TomlDate::format", bytes, 20, [&] {
+        size_t total = 0;
+        char   buffer[TomlDate::FORMAT_BUFFER_SIZE];
+        for (const auto& date : dates) {
+            total += date.format(buffer);
+        }
+        return total;
+    });
+    const size_t tomlBytes = parser::stringify(root).size();
+    bench("stringify TOML", tomlBytes, 10, [&] { return parser::stringify(root).size(); });
+    const size_t jsonBytes = parser::stringify(root, parser::TO_JSON).size();
+    bench("stringify JSON", jsonBytes, 10, [&] {
+        return parser::stringify(root, parser::TO_JSON).size();
+    });
+
+    // 导出结果必须能原样解析回来
+    same = same && parser::parse(parser::stringify(root)) == root;
+    std::cout << "format matches toString and round-trips: " << (same ? "yes" : "no")
+              << std::endl;
+    return same ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+#include <cctoml.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace cctoml;
+
+/**
+ * @brief 构造包含 count 个 [[users]] 的文档。
+ */
+static std::string makeDocument(size_t count) {
+    static const char* const regions[] = {"eu", "us", "ap"};
+    std::string              doc;
+    for (size_t i = 0; i < count; ++i) {
+        doc += "[[users]]\nname = \"user-" + std::to_string(i) + "\"\nid = " + std::to_string(i) +
+               "\nregion = \"" + regions[i % 3] + "\"\n";
+    }
+    return doc;
+}
+
+/**
+ * @brief 重复执行并输出平均耗时。
+ * @param name 测试名称。
+ * @param rounds 重复次数。
+ * @param body 被测函数，返回值用于防止被优化掉。
+ */
+template <typename F>
+static void bench(const std::string& name, int rounds, F&& body) {
+    size_t sink  = 0;
+    auto   start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        sink += body(i);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << std::left << std::setw(28) << name << std::right << std::setw(12) << std::fixed
+              << std::setprecision(1) << elapsed.count() / rounds * 1e9 << " ns" << std::setw(8)
+              << sink % 10 << std::endl;
+}
+
+/**
+ * @brief 检查索引在只读访问、修改元素与修改数组后的行为。
+ * @return 全部符合预期时返回 true。
+ */
+static bool checkInvalidation() {
+    TomlValue  doc   = parser::parse("[[items]]\nname = \"a\"\n[[items]]\nname = \"c\"\n"
+                                        "[[items]]\nname = \"e\"\n");
+    TomlValue& items = doc["items"];
+    TomlValue& e     = items.asArray()[1];
+    TomlArrayIndex index(items, {"name"});
+    bool           ok = true;
+
+    // 只读访问（即使经由非 const 接口）不会使索引失效
+    for (auto& item : items.asArray()) {
+        ok = ok && item["name"].isString();
+    }
+    ok = ok && items[0]["name"].get<std::string>() == "a" && index.valid() &&
+         index.find({"c"}) == &e;
+
+    // 通过元素引用修改字段: 重建前按建立时的字段值查找, 重建后按新值查找
+    e["name"] = "z";
+    ok        = ok && index.valid() && index.find({"c"}) == &e && index.find({"z"}) == nullptr;
+    index.rebuild();
+    ok = ok && index.find({"c"}) == nullptr && index.find({"z"}) == &e;
+
+    // 整体替换元素: 旧字段值已被释放, 索引使用的是自己的副本
+    e  = TomlValue(TomlObject());
+    ok = ok && index.find({"z"}) == &e;
+    index.rebuild();
+    ok = ok && index.find({"z"}) == nullptr && index.size() == 2;
+
+    // 增删元素后索引失效, 查找抛出异常, TomlIndexCache 自动重建
+    items.push_back(TomlObject{{"name", "g"}});
+    bool stale = false;
+    try {
+        index.find({"g"});
+    } catch (const TomlException&) {
+        stale = true;
+    }
+    TomlIndexCache cache;
+    ok = ok && stale && !index.valid() &&
+         cache.get(items, {"name"}).find({"g"}) == &items.asArray().back();
+    return ok;
+}
+
+int main() {
+    constexpr size_t kUsers = 100000;
+
+    const TomlValue  doc   = parser::parse(makeDocument(kUsers));
+    const TomlValue& users = doc["users"];
+
+    const auto start = std::chrono::steady_clock::now();
+    TomlArrayIndex byName(users, {"name"});
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << std::left << std::setw(28) << "build hash index" << std::right << std::setw(12)
+              << std::fixed << std::setprecision(3) << elapsed.count() * 1e3 << " ms" << std::endl;
+    TomlArrayIndex byRegion(users, {"region", "id"}, TomlArrayIndex::Kind::Sorted);
+
+    std::vector<std::string> names;
+    for (size_t i = 0; i < 1000; ++i) {
+        names.push_back("user-" + std::to_string(i * 97 % kUsers));
+    }
+    bench("linear scan", 200, [&](int i) {
+        const std::string& name = names[i % names.size()];
+        for (const auto& user : users.asArray()) {
+            if (std::string_view(user["name"].asString()) == name) {
+                return size_t(user["id"].get<int64_t>());
+            }
+        }
+        return size_t(0);
+    });
+    bench("hash index find", 1000000, [&](int i) {
+        return size_t((*byName.find({names[i % names.size()]}))["id"].get<int64_t>());
+    });
+    bench("sorted index find", 1000000, [&](int i) {
+        return size_t(byRegion.find({"us", int64_t(i % kUsers / 3 * 3 + 1)}) != nullptr);
+    });
+
+    bool ok = byName.size() == kUsers && byRegion.findAll({"eu", 0}).size() == 1;
+    for (const auto& name : names) {
+        const TomlValue* user = byName.find({name});
+        ok = ok && user != nullptr && std::string_view((*user)["name"].asString()) == name;
+    }
+    ok = ok && checkInvalidation();
+    std::cout << "index lookups and invalidation behave as documented: " << (ok ? "yes" : "no")
+              << std::endl;
+    return ok ? 0 : 1;
+}
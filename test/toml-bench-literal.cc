@@ -0,0 +1,122 @@
+#include <cctoml.h>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace cctoml;
+
+/**
+ * @brief 覆盖各类语法的默认配置。
+ */
+static constexpr char kDefaults[] = R"(# 服务默认配置
+title = "cctoml \"defaults\" \u00e9\U0001F600"
+path  = 'C:\Users\toml'
+text  = """
+first line \
+    continued
+second line"""
+raw   = '''
+  keep \n as is'''
+owner.name = "tom"
+owner.dob  = 1979-05-27T07:32:00-08:00
+
+[server]
+host     = "127.0.0.1"
+ports    = [8000, 8_001, 0x1F42, 0o17, 0b101]
+enabled  = true
+ratio    = 0.1
+big      = 6.02214076e23
+small    = -1.5e-300
+tiny     = 4.9e-324
+limits   = {min = -9223372036854775808, max = 9223372036854775807, inf = -inf}
+schedule = [07:30:00, 1987-07-05, 1987-07-05 17:45:00.123456, 2024-02-29T00:00:00Z]
+
+[server.tls]
+cert = "server.pem"
+
+[[users]]
+name  = "alice"
+roles = ["admin", "dev"]
+
+[[users]]
+name = "bob"
+nested = [[1, 2], ["a", {b = [true]}]]
+
+[database.primary]
+"quoted key" = 1
+a.b.c = 2
+)";
+
+/**
+ * @brief parser::parse 可以解析、而 _tomlc 按 TOML 1.0 拒绝的文档（与 operator""_tomlc 的说明一致）
+ */
+static const char* const kDivergent[] = {
+    "[a]\nb = 1\n[a]\nc = 2",         "a.b = 1\n[a]\nc = 2",
+    "[a.b]\n[a]\n[a]",                "[t]\nx.y.v = 0\n[t.x.y]",
+    "[a.b.c]\n[a]\nb.c.t = 1",         "t = {x = {y = 1}}\nt.z = 2",
+    "t = {x = {y = 1}, x.z = 2}",     "t = {b = 1, b = 2}",
+    "a = {}\n[a.b]",                   "a = [{b = 1}]\n[a.c]",
+    "a = []\n[[a]]",
+};
+
+/**
+ * @brief 重复执行并输出平均耗时。
+ * @param name 测试名称。
+ * @param rounds 重复次数。
+ * @param body 被测函数，返回值用于防止被优化掉。
+ */
+template <typename F>
+static void bench(const std::string& name, int rounds, F&& body) {
+    size_t sink  = 0;
+    auto   start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        sink += body();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << std::left << std::setw(28) << name << std::right << std::setw(12) << std::fixed
+              << std::setprecision(1) << elapsed.count() / rounds * 1e9 << " ns" << std::setw(8)
+              << sink % 10 << std::endl;
+}
+
+int main() {
+    const TomlFrozen::View compiled = operator""_tomlc<kDefaults>();
+    const TomlValue        parsed   = parser::parse(kDefaults);
+
+    // 编译期解析的结果必须与运行期解析完全一致 (逐位比较浮点)
+    bool ok = compiled.toValue() == parsed;
+    ok      = ok && compiled["server"]["ratio"].asDouble() == parsed["server"]["ratio"].get<double>();
+    ok      = ok && std::signbit(compiled["server"]["limits"]["inf"].asDouble());
+    ok      = ok && compiled.findPath("users[1].nested[1][1].b[0]")->asBoolean();
+    ok      = ok && compiled["owner"]["dob"].asDate() == parsed["owner"]["dob"].get<TomlDate>();
+    ok      = ok && CCTOML_STATIC_TOML(kDefaults).toValue() == parsed;
+    for (const char* key : {"big", "small", "tiny"}) {
+        double a = compiled["server"][key].asDouble(), b = parsed["server"][key].get<double>();
+        ok       = ok && std::memcmp(&a, &b, sizeof(double)) == 0;
+    }
+    ok = ok && R"(port = 8080)"_tomlc["port"].asInteger() == 8080;
+    std::cout << "compile-time literal matches parser::parse: " << (ok ? "yes" : "no")
+              << std::endl;
+
+    // 编译期解析器同样可以在运行期执行, 以此确认这些文档会使 _tomlc 编译失败
+    size_t divergent = 0;
+    for (const char* text : kDivergent) {
+        bool rejected = false;
+        try {
+            literal::Parser{text};
+        } catch (const TomlParseException&) {
+            rejected = true;
+        }
+        divergent += rejected && parser::parse(text).isObject();
+    }
+    ok = ok && divergent == std::size(kDivergent);
+    std::cout << "documented divergences from parser::parse: " << divergent << "/"
+              << std::size(kDivergent) << std::endl;
+
+    bench("parser::parse", 20000, [] { return parser::parse(kDefaults)["server"].asObject().size(); });
+    bench("CCTOML_STATIC_TOML", 20000, [] { return CCTOML_STATIC_TOML(kDefaults)["server"].size(); });
+    bench("_tomlc", 20000, [] { return (operator""_tomlc<kDefaults>())["server"].size(); });
+    return ok ? 0 : 1;
+}
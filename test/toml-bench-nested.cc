@@ -0,0 +1,88 @@
+#include <cctoml.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+
+using namespace cctoml;
+
+/**
+ * @brief 构造一个嵌套指定层数的数组/内联表文档，如 a = [{x = [{x = [1]}]}]
+ * @param depth 嵌套深度。
+ * @param inlineTable 是否交替使用内联表。
+ * @return TOML 文档。
+ */
+static std::string makeNestedDocument(size_t depth, bool inlineTable) {
+    std::string open, close;
+    open.reserve(depth * 6);
+    close.reserve(depth * 2);
+    for (size_t i = 0; i < depth; ++i) {
+        if (inlineTable && i % 2 == 1) {
+            open += "{x = ";
+            close += '}';
+        } else {
+            open += '[';
+            close += ']';
+        }
+    }
+    std::string closeReversed(close.rbegin(), close.rend());
+    return "a = " + open + "1" + closeReversed + "\n";
+}
+
+/**
+ * @brief 构造一个普通的（浅层嵌套）文档，用于对比常规输入的吞吐量。
+ * @param lines 键值对行数。
+ * @return TOML 文档。
+ */
+static std::string makeFlatDocument(size_t lines) {
+    std::string doc;
+    for (size_t i = 0; i < lines; ++i) {
+        doc += "key" + std::to_string(i) + " = [1, 2.5, \"three\", {a = 1, b = [true, false]}]\n";
+    }
+    return doc;
+}
+
+/**
+ * @brief 多次解析文档并输出平均耗时与吞吐量。
+ * @param name 测试名称。
+ * @param doc TOML 文档。
+ * @param options 解析选项。
+ * @param rounds 重复次数。
+ */
+static void
+bench(const std::string& name, const std::string& doc, const parser::ParseOptions& options, int rounds) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        auto value = parser::parse(doc, options);
+        (void) value;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double                        seconds = elapsed.count() / rounds;
+    std::cout << std::left << std::setw(28) << name << std::right << std::setw(12) << std::fixed
+              << std::setprecision(3) << seconds * 1e3 << " ms" << std::setw(12)
+              << doc.size() / seconds / (1 << 20) << " MB/s" << std::endl;
+}
+
+int main() {
+    parser::ParseOptions unlimited;
+    unlimited.maxDepth = std::numeric_limits<size_t>::max();
+
+    bench("flat (100k lines)", makeFlatDocument(100000), unlimited, 5);
+    for (size_t depth : {1000, 10000, 20000}) {
+        bench("array depth " + std::to_string(depth), makeNestedDocument(depth, false), unlimited,
+              20);
+        bench("mixed depth " + std::to_string(depth), makeNestedDocument(depth, true), unlimited,
+              20);
+    }
+
+    // 默认深度限制应拒绝过深的输入
+    try {
+        parser::parse(makeNestedDocument(10000, false));
+        std::cout << "depth limit: not enforced" << std::endl;
+        return 1;
+    } catch (const TomlParseException& e) {
+        std::cout << "depth limit: " << e.what() << std::endl;
+    }
+    return 0;
+}
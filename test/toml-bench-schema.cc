@@ -0,0 +1,192 @@
+#include <cctoml.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace cctoml;
+
+struct Server {
+    std::string              host;
+    int                      port   = 0;
+    bool                     tls    = false;
+    double                   weight = 0;
+    std::vector<std::string> tags;
+};
+
+struct Config {
+    std::string         name;
+    int64_t             version = 0;
+    std::optional<bool> debug;
+    std::vector<Server> servers;
+};
+
+/**
+ * @brief 手写的 fromToml，作为 “通用解析 + 解码” 的对照。
+ */
+void fromToml(const TomlValue& toml, Server& server) {
+    server.host   = toml["host"].get<std::string>();
+    server.port   = toml["port"].get<int>();
+    server.tls    = toml["tls"].get<bool>();
+    server.weight = toml["weight"].get<double>();
+    server.tags   = toml["tags"].get<std::vector<std::string>>();
+}
+
+void fromToml(const TomlValue& toml, Config& config) {
+    config.name    = toml["name"].get<std::string>();
+    config.version = toml["version"].get<int64_t>();
+    if (toml.contains("debug")) {
+        config.debug = toml["debug"].get<bool>();
+    }
+    config.servers = toml["servers"].get<std::vector<Server>>();
+}
+
+/**
+ * @brief 构造包含 count 个 [[servers]] 的文档。
+ */
+static std::string makeDocument(size_t count) {
+    std::string doc = "name = \"cluster\"\nversion = 3\ndebug = false\n";
+    for (size_t i = 0; i < count; ++i) {
+        doc += "\n[[servers]]\nhost = \"node-" + std::to_string(i) +
+               ".internal.example.com\"\nport = " + std::to_string(8000 + i % 1000) +
+               "\ntls = true\nweight = 0.75\ntags = [\"primary\", \"zone-a\", \"ssd\"]\n";
+    }
+    return doc;
+}
+
+/**
+ * @brief 比较两份解码结果。
+ */
+static bool sameConfig(const Config& a, const Config& b) {
+    return a.name == b.name && a.version == b.version && a.debug == b.debug &&
+           a.servers.size() == b.servers.size() && a.servers.back().host == b.servers.back().host &&
+           a.servers.back().port == b.servers.back().port &&
+           a.servers.back().tags == b.servers.back().tags;
+}
+
+/**
+ * @brief 获取解码时抛出的 TomlSchemaException 的键路径与信息（未抛出时为空串）
+ */
+template <typename F>
+static std::string schemaError(F&& body) {
+    try {
+        body();
+    } catch (const TomlSchemaException& e) {
+        return e.what();
+    }
+    return std::string();
+}
+
+/**
+ * @brief 检查 load() 与 decode(parser::parse()) 报告的错误一致。
+ */
+static bool checkErrors(const TomlSchema<Config>& config) {
+    static const char* const docs[] = {
+        "name = \"a\"\nversion = 1\n[[servers]]\nhost = \"h\"\nport = 1\ntls = true\n"
+        "weight = 1.0\ntags = []\n[[servers]]\nhost = \"h\"\ntls = true\nweight = 1.0\ntags = []\n",
+        "name = \"a\"\nversion = \"1\"\n",
+        "name = \"a\"\nversion = 1\n[[servers]]\nhost = \"h\"\nport = 1\ntls = true\n"
+        "weight = 1.0\ntags = [1]\n",
+        "name = \"a\"\nversion = 1\n[servers]\nhost = \"h\"\n",
+        "name = \"a\"\nversion = 1\nservers = []\n[other.deep]\nx = 1\n",
+        "name = \"a\"\n[version]\n",
+    };
+    bool ok = true;
+    for (const char* doc : docs) {
+        Config out;
+        ok = ok && schemaError([&] { config.load(doc); }) ==
+                       schemaError([&] { config.decode(parser::parse(doc), out); });
+    }
+    // 严格模式下的未知键
+    TomlSchema<Config> strict = config;
+    strict.strict();
+    const char* unknown = "name = \"a\"\nversion = 1\nservers = []\n[extra]\nx = 1\n";
+    Config      out;
+    ok = ok && schemaError([&] { strict.load(unknown); }) == "extra: unknown key" &&
+         schemaError([&] { strict.decode(parser::parse(unknown), out); }) == "extra: unknown key";
+    return ok;
+}
+
+/**
+ * @brief 多次执行并输出平均耗时与吞吐量。
+ * @param name 测试名称。
+ * @param doc 输入文档（用于计算吞吐量）
+ * @param rounds 重复次数。
+ * @param body 被测函数，返回值用于防止被优化掉。
+ */
+template <typename F>
+static double bench(const std::string& name, const std::string& doc, int rounds, F&& body) {
+    size_t sink  = 0;
+    auto   start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        sink += body();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double                        seconds = elapsed.count() / rounds;
+    std::cout << std::left << std::setw(28) << name << std::right << std::setw(12) << std::fixed
+              << std::setprecision(3) << seconds * 1e3 << " ms" << std::setw(12)
+              << doc.size() / seconds / (1 << 20) << " MB/s" << std::setw(8) << sink % 10
+              << std::endl;
+    return seconds;
+}
+
+int main() {
+    const auto server = TomlSchema<Server>()
+                            .field("host", &Server::host)
+                            .field("port", &Server::port)
+                            .field("tls", &Server::tls)
+                            .field("weight", &Server::weight)
+                            .field("tags", &Server::tags);
+    const auto config = TomlSchema<Config>()
+                            .field("name", &Config::name)
+                            .field("version", &Config::version)
+                            .field("debug", &Config::debug)
+                            .field("servers", &Config::servers, server);
+
+    // 构建大模式: 完美哈希表只在首次解码时构建一次
+    {
+        auto               start = std::chrono::steady_clock::now();
+        TomlSchema<Server> wide;
+        std::string        extra;
+        for (size_t i = 0; i < 2000; ++i) {
+            wide.field("key" + std::to_string(i), &Server::port, false);
+            extra += "key" + std::to_string(i) + " = " + std::to_string(i) + "\n";
+        }
+        const int port = wide.load(extra).port;
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << std::left << std::setw(28) << "build 2000-field schema" << std::right
+                  << std::setw(12) << std::fixed << std::setprecision(3) << elapsed.count() * 1e3
+                  << " ms" << std::setw(20) << port % 10 << std::endl;
+    }
+
+    const std::string doc = makeDocument(20000);
+    bench("parser::parse", doc, 10, [&] { return parser::parse(doc).asObject().size(); });
+    double generic = bench("parse + fromToml", doc, 10, [&] {
+        Config result;
+        fromToml(parser::parse(doc), result);
+        return result.servers.size();
+    });
+    double schema =
+        bench("TomlSchema::load", doc, 10, [&] { return config.load(doc).servers.size(); });
+    std::cout << "schema speedup over parse + fromToml: " << std::setprecision(2)
+              << generic / schema << "x" << std::endl;
+
+    // 从 const 树解码只复制写入成员的值
+    const TomlValue tree = parser::parse(doc);
+    bench("TomlSchema::decode (const)", doc, 10, [&] {
+        Config result;
+        config.decode(tree, result);
+        return result.servers.size();
+    });
+
+    // 各种方式的结果必须一致
+    Config expected;
+    fromToml(parser::parse(doc), expected);
+    Config fromTree;
+    config.decode(tree, fromTree);
+    const bool same   = sameConfig(config.load(doc), expected) && sameConfig(fromTree, expected);
+    const bool errors = checkErrors(config);
+    std::cout << "results match: " << (same ? "yes" : "no")
+              << ", errors match: " << (errors ? "yes" : "no") << std::endl;
+    return same && errors ? 0 : 1;
+}
@@ -165,7 +165,7 @@ class TomlStringifyer {
         stringifyLeaf("string", value.get<std::string>(), oss, indent, level);
     }
 
-    static void stringifyString(const std::string& value, std::ostringstream& oss) {
+    static void stringifyString(std::string_view value, std::ostringstream& oss) {
         oss << '"';
         for (char c : value) {
             auto uc = static_cast<unsigned char>(c);  // 处理负值字符